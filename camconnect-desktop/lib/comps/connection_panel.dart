@@ -1,6 +1,7 @@
 import 'package:flutter/material.dart';
 
 import '../utils/connection_manager.dart';
+import '../utils/request_names.dart';
 import '../utils/requester.dart';
 import '../utils/resolution_presets.dart';
 import '../utils/task_executer.dart';
@@ -266,26 +267,32 @@ class _ConnectionPanelState extends State<ConnectionPanel> {
       builder: (context) => ResolutionPresetsDialog(
         resolutionPresets: Variables.resolutionPresets!,
         onResolutionSelected: (resolution) async {
-          if (await Requester.setResolution(resolution.toString())) {
-            setState(() => Variables.resolution = resolution.toString());
-          } else {
-            return; // on failure.
-          }
           if (Variables.framerate == null) {
             final framerate = await Requester.getFramerate();
             if (framerate == null) return;
             setState(() => Variables.framerate = framerate);
           }
-          if (resolution.maxFps < Variables.framerate! &&
-              (await Requester.setFramerate(resolution.maxFps))) {
-            setState(() => Variables.framerate = resolution.maxFps);
+          // One request, so the phone never runs a framerate the new
+          // resolution can't.
+          final settings = <String, dynamic>{
+            RequestName.resolution: resolution.toString(),
+            if (resolution.maxFps < Variables.framerate!)
+              RequestName.framerate: resolution.maxFps,
+            if (resolution.maxFps != Variables.fpsRange.last)
+              RequestName.maxFramerate: resolution.maxFps,
+          };
+          if (!await Requester.setSettings(settings)) {
+            return; // on failure, none was applied.
           }
-          if (resolution.maxFps != Variables.fpsRange.last &&
-              (await Requester.setMaxFramerate(resolution.maxFps))) {
-            setState(() {
+          setState(() {
+            Variables.resolution = resolution.toString();
+            if (settings.containsKey(RequestName.framerate)) {
+              Variables.framerate = resolution.maxFps;
+            }
+            if (settings.containsKey(RequestName.maxFramerate)) {
               Variables.fpsRange = Variables.getFpsRange(resolution.maxFps);
-            });
-          }
+            }
+          });
         },
       ),
     );
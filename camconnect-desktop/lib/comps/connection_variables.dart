@@ -31,117 +31,123 @@ class Variables {
   }
 
   static void setupUpdateCallbacks() {
-    ConnectionManager.remoteStream.listen((_) async {
-      isMicOn = await Requester.getIsMicOn() ?? isMicOn;
-      isTorchOn = await Requester.getIsTorchOn() ?? isTorchOn;
-      resolution = await Requester.getResolution();
-
-      final maxFps = await Requester.getMaxFramerate();
-      if (maxFps != null && maxFps != fpsRange.last) {
-        fpsRange = getFpsRange(maxFps);
-      }
-
-      framerate = await Requester.getFramerate();
-      if (framerate != null && !fpsRange.contains(framerate)) {
-        onError?.call("Received invalid framerate: $framerate");
-        framerate = null;
-      }
-
-      final camerasInfo = await Requester.getCameras();
-      if (camerasInfo != null) {
+    ConnectionManager.remoteStream.listen((_) => _refresh());
+    Requester.onResync = _refresh;
+
+    Requester.onUpdateRequest = (request) {
+      request.forEach(_applySetting);
+      onChanged?.call(); // inform the variable value change.
+    };
+  }
+
+  /// Takes every setting from one snapshot of the phone's.
+  static Future<void> _refresh() async {
+    final settings = await Requester.getSnapshot();
+    if (settings == null) return;
+
+    // Ranges first, the values are checked against them.
+    const ranges = [RequestName.maxFramerate, RequestName.cameras];
+    for (final name in ranges) {
+      if (settings.containsKey(name)) _applySetting(name, settings[name]);
+    }
+    settings.forEach((name, value) {
+      if (!ranges.contains(name)) _applySetting(name, value);
+    });
+    onChanged?.call(); // inform the variable value change.
+  }
+
+  static Future<void> _applySetting(String name, dynamic value) async {
+    switch (name) {
+      case RequestName.port:
+        final result = _cast<int>(name, value);
+        if (result == null || result == Preferences.getPort()) return;
+        if (!await Preferences.setPort(result)) {
+          onError?.call("Failed to save preference: port");
+        }
+        onPortChanged?.call(result);
+        break;
+
+      case RequestName.hasTorch:
+        final result = _cast<bool>(name, value);
+        if (result == null) return;
+        hasTorch = result;
+        break;
+
+      case RequestName.torch:
+        final result = _cast<bool>(name, value);
+        if (result == null) return;
+        isTorchOn = result;
+        break;
+
+      case RequestName.microphone:
+        final result = _cast<bool>(name, value);
+        if (result == null) return;
+        isMicOn = result;
+        break;
+
+      case RequestName.resolution:
+        final result = _cast<String>(name, value);
+        if (result == null) return;
+        resolution = result;
+        break;
+
+      case RequestName.framerate:
+        final result = _cast<int>(name, value);
+        if (result == null) return;
+        if (fpsRange.contains(result)) {
+          framerate = result;
+        } else {
+          onError?.call("Received invalid framerate: $result");
+        }
+        break;
+
+      case RequestName.maxFramerate:
+        final result = _cast<int>(name, value);
+        if (result == null) return;
+        if (result >= 5) {
+          fpsRange = getFpsRange(result);
+        } else {
+          onError?.call("Received invalid max-framerate: $result");
+        }
+        break;
+
+      case RequestName.cameraId:
+        final result = _cast<int>(name, value);
+        if (result == null) return;
+        if (cameras?.any((e) => e.deviceId == result) ?? false) {
+          cameraId = result;
+        } else {
+          onError?.call("Received invalid cameraId: $result");
+        }
+        break;
+
+      case RequestName.cameras:
+        final result = _cast<List<dynamic>>(name, value);
+        if (result == null) return;
         try {
-          cameras = deserializeCamerasInfo(camerasInfo);
+          cameras = deserializeCamerasInfo(result);
         } catch (e) {
           onError?.call(e.toString());
         }
-      }
+        break;
 
-      cameraId = await Requester.getCameraId();
-      if (cameraId != null && cameras != null) {
-        if (!cameras!.any((camera) => camera.deviceId == cameraId)) {
-          onError?.call("Received invalid cameraId: $cameraId");
-          cameraId = null;
+      case RequestName.resolutionPresets:
+        final result = _cast<Map<String, dynamic>>(name, value);
+        if (result == null) return;
+        try {
+          resolutionPresets = deserializeResolutionPresets(result);
+        } catch (e) {
+          onError?.call(e.toString());
         }
-      }
+        break;
 
-      hasTorch = await Requester.getHasTorch() ?? hasTorch;
-      onChanged?.call(); // inform the variable value change.
-    });
+      case RequestName.orientation:
+        break; // not shown on the desktop.
 
-    Requester.onUpdateRequest = (request) {
-      request.forEach((name, value) async {
-        switch (name) {
-          case RequestName.port:
-            final result = _cast<int>(name, value);
-            if (result == null) return;
-            if (!await Preferences.setPort(result)) {
-              onError?.call("Failed to save preference: port");
-            }
-            onPortChanged?.call(result);
-            break;
-
-          case RequestName.hasTorch:
-            final result = _cast<bool>(name, value);
-            if (result == null) return;
-            hasTorch = result;
-            break;
-
-          case RequestName.torch:
-            final result = _cast<bool>(name, value);
-            if (result == null) return;
-            isTorchOn = result;
-            break;
-
-          case RequestName.microphone:
-            final result = _cast<bool>(name, value);
-            if (result == null) return;
-            isMicOn = result;
-            break;
-
-          case RequestName.resolution:
-            final result = _cast<String>(name, value);
-            if (result == null) return;
-            resolution = result;
-            break;
-
-          case RequestName.framerate:
-            final result = _cast<int>(name, value);
-            if (result == null) return;
-            if (fpsRange.contains(result)) {
-              framerate = result;
-            } else {
-              onError?.call("Received invalid framerate: $result");
-            }
-            break;
-
-          case RequestName.maxFramerate:
-            final result = _cast<int>(name, value);
-            if (result == null) return;
-            if (result >= 5) {
-              fpsRange = getFpsRange(result);
-            } else {
-              onError?.call("Received invalid max-framerate: $result");
-            }
-            break;
-
-          case RequestName.cameraId:
-            final result = _cast<int>(name, value);
-            if (result == null) return;
-            if (cameras?.any((e) => e.deviceId == result) ?? false) {
-              cameraId = result;
-            } else {
-              onError?.call("Received invalid cameraId: $result");
-            }
-            break;
-
-          default:
-            onError?.call("Received invalid set-update request: $request");
-            break;
-        }
-      });
-
-      onChanged?.call(); // inform the variable value change.
-    };
+      default:
+        onError?.call("Received invalid setting: {$name: $value}");
+        break;
+    }
   }
 
   static T? _cast<T>(String name, dynamic value) {
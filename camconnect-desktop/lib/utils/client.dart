@@ -1,6 +1,7 @@
 import 'dart:convert';
 import 'dart:io';
 
+import 'preferences.dart';
 import 'signaling.dart';
 
 class Client {
@@ -15,19 +16,41 @@ class Client {
 
   Client() {
     signaling.onError = onError;
-    signaling.onClose = _onClose;
+    signaling.onClose = _onSessionClosed;
     signaling.onMessageSend = sendMessage;
   }
 
+  static const _resumeRetryInterval = Duration(milliseconds: 250);
+
   WebSocket? _socket;
+  String? _sessionId;
+  String _address = "";
+  int _port = 0;
   bool _intentionalDisconnect = false;
 
   Future<void> connect(String address, int port) async {
-    _socket = await WebSocket.connect('ws://$address:$port');
+    // The phone scales the video down to the layer asked for here.
+    final layer = Preferences.getVideoLayer();
+    _socket = await WebSocket.connect('ws://$address:$port/?layer=$layer');
+    _sessionId = null;
+    _address = address;
+    _port = port;
 
     await signaling.setupPeerConnection();
+    _listen(_socket!);
 
-    _socket!.listen(
+    _intentionalDisconnect = false;
+    onConnected?.call(); // signal connected.
+  }
+
+  Future<void> disconnect() async {
+    _intentionalDisconnect = true;
+    if (_socket == null) await signaling.close(); // interrupted session.
+    await _socket?.close();
+  }
+
+  void _listen(WebSocket socket) {
+    socket.listen(
       (data) {
         Map<String, dynamic> message;
         try {
@@ -40,6 +63,12 @@ class Client {
           return onReceivedMessage?.call(message);
         }
 
+        // Names this viewer's session, for resuming it.
+        if (message['type'] == 'session') {
+          _sessionId = message['id'] as String?;
+          return;
+        }
+
         // Handle possible remote peer invalid value that may cause type casting error.
         bool status = false; // false -> unknown remote peer signaling message.
         try {
@@ -53,8 +82,17 @@ class Client {
         }
       },
       onDone: () async {
+        if (_socket != socket) return; // replaced by a resumed socket.
+        _socket = null;
+
+        // Keep the session and come back to it within the grace period.
+        if (!_intentionalDisconnect && signaling.canResume) {
+          signaling.detachSignaling();
+          return _resumeSignaling();
+        }
+
         try {
-          await _socket?.close(); // socket might be open.
+          await socket.close(); // socket might be open.
           await signaling.close(); // close peer connection.
         } catch (e) {
           onSoftError?.call(e.toString());
@@ -64,14 +102,38 @@ class Client {
       cancelOnError: true,
       onError: (e) => onError?.call(e.toString()),
     );
+  }
 
-    _intentionalDisconnect = false;
-    onConnected?.call(); // signal connected.
+  /// Reconnects the signaling socket of an interrupted session until it
+  /// works or the grace period ends.
+  Future<void> _resumeSignaling() async {
+    while (signaling.isInterrupted && !_intentionalDisconnect) {
+      WebSocket socket;
+      try {
+        socket = await WebSocket.connect(
+                'ws://$_address:$_port/resume?session=$_sessionId')
+            .timeout(_resumeRetryInterval * 4);
+      } catch (_) {
+        await Future.delayed(_resumeRetryInterval);
+        continue;
+      }
+      if (!signaling.isInterrupted || _intentionalDisconnect) {
+        return await socket.close(); // ended meanwhile.
+      }
+      _socket = socket;
+      _listen(socket);
+      return signaling.attachSignaling();
+    }
   }
 
-  Future<void> disconnect() async {
-    _intentionalDisconnect = true;
-    await _socket?.close();
+  /// The session ended, or wasn't resumed within the grace period.
+  Future<void> _onSessionClosed() async {
+    try {
+      await signaling.close();
+    } catch (e) {
+      onSoftError?.call(e.toString());
+    }
+    _onClose();
   }
 
   void _onClose() {
@@ -1,10 +1,9 @@
 import 'dart:async';
-import 'dart:io';
 
 import 'package:flutter_webrtc/flutter_webrtc.dart';
 
-import 'broadcast_listener.dart';
 import 'client.dart';
+import 'discovery_probe.dart';
 import 'preferences.dart';
 import 'requester.dart';
 import 'signaling.dart';
@@ -19,11 +18,14 @@ enum ConnectionStatus {
 
 class ConnectionManager {
   static int get port => Preferences.getPort();
-  static const _broadcastMessage = "camconnect broadcast";
 
   static bool networkDiscoveryEnabled = true;
   static String remoteAddress = "", errorMsg = "";
 
+  /// Time from the last interruption to the first frame after resuming,
+  /// null if no frame came within the timeout.
+  static Duration? lastResumeTime;
+
   static ConnectionStatus get connectionStatus => _connectionStatus;
   static Signaling get signaling => _client.signaling;
 
@@ -63,15 +65,15 @@ class ConnectionManager {
     }
 
     try {
-      await BroadcastListener.start(InternetAddress.anyIPv4, port);
+      await DiscoveryProbe.start(port);
     } catch (e) {
-      _updateErrorMsg(e.toString()); // port binding may fail
+      _updateErrorMsg(e.toString()); // socket binding may fail
     }
     _updateStatus(ConnectionStatus.waiting);
   }
 
   static Future<void> disconnect() async {
-    BroadcastListener.stop();
+    DiscoveryProbe.stop();
     await _client.disconnect();
     _updateStatus(ConnectionStatus.disconnected);
   }
@@ -87,15 +89,12 @@ class ConnectionManager {
   }
 
   static void _setupCallbacks() {
-    BroadcastListener.onBroadcast = (ip, msg) async {
-      if (msg != _broadcastMessage) {
-        return; // not a camconnect broadcast.
-      }
-      BroadcastListener.stop();
+    DiscoveryProbe.onDiscovered = (answer) async {
+      DiscoveryProbe.stop();
 
-      remoteAddress = ip.address;
+      remoteAddress = answer.address.address;
       try {
-        await _client.connect(ip.address, port);
+        await _client.connect(remoteAddress, answer.port);
       } catch (e) {
         _updateErrorMsg(e.toString());
       }
@@ -108,7 +107,7 @@ class ConnectionManager {
     _client.onDisconnected = reconnect;
     _client.onError = _updateErrorMsg;
     _client.onSoftError = onError;
-    BroadcastListener.onError = _updateErrorMsg;
+    DiscoveryProbe.onError = _updateErrorMsg;
 
     _client.onReceivedMessage = Requester.handleResponse;
     Requester.onSend = _client.sendMessage;
@@ -116,6 +115,8 @@ class ConnectionManager {
     _client.signaling.onRemoteStream = (stream) {
       _remoteStreamController.add(stream);
     };
+
+    _client.signaling.onResumed = (time) => lastResumeTime = time;
   }
 
   static void _updateErrorMsg(String msg) {
@@ -0,0 +1,91 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'discovery_packet.dart';
+import 'mdns.dart';
+
+/// Looks for phones on the LAN.
+///
+/// Queries go out to the discovery multicast group, the broadcast address
+/// and over multicast DNS at once, and phones answer right away. Unanswered
+/// queries are repeated after 250 ms, doubling up to every 2 s.
+class DiscoveryProbe {
+  static void Function(String)? onError;
+  static void Function(DiscoveryAnswer)? onDiscovered;
+
+  static bool get isActive => _socket != null;
+
+  static const _firstRetry = Duration(milliseconds: 250);
+  static const _maxRetry = Duration(seconds: 2);
+
+  static final _random = Random();
+
+  static RawDatagramSocket? _socket;
+  static Timer? _timer;
+  static int _nonce = 0;
+
+  /// Queries phones listening on [port]. [addresses] and [mdnsAddress]
+  /// replace the default destinations, a null [mdnsPort] skips mDNS.
+  static Future<void> start(
+    int port, {
+    List<InternetAddress>? addresses,
+    InternetAddress? mdnsAddress,
+    int? mdnsPort = Mdns.port,
+  }) async {
+    stop();
+    final socket = _socket =
+        await RawDatagramSocket.bind(InternetAddress.anyIPv4, 0);
+    socket.broadcastEnabled = true;
+    socket.listen(
+      (event) {
+        if (event != RawSocketEvent.read) return;
+        final datagram = socket.receive();
+        if (datagram == null) return;
+        final answer = _parse(datagram);
+        if (answer != null && _socket == socket) onDiscovered?.call(answer);
+      },
+      cancelOnError: true,
+      onError: (error) => onError?.call(error.toString()),
+    );
+
+    _nonce = _random.nextInt(1 << 32);
+    final query = DiscoveryPacket.query(_nonce);
+    final mdnsQuery = Mdns.query(_nonce & 0xFFFF);
+    final targets = [
+      for (final address in addresses ??
+          [DiscoveryPacket.group, InternetAddress('255.255.255.255')])
+        (query, address, port),
+      if (mdnsPort != null) (mdnsQuery, mdnsAddress ?? Mdns.group, mdnsPort),
+    ];
+    _send(socket, targets, _firstRetry);
+  }
+
+  static void stop() {
+    _timer?.cancel();
+    _timer = null;
+    _socket?.close();
+    _socket = null;
+  }
+
+  static void _send(RawDatagramSocket socket,
+      List<(Uint8List, InternetAddress, int)> targets, Duration retry) {
+    if (_socket != socket) return;
+    for (final (packet, address, port) in targets) {
+      try {
+        socket.send(packet, address, port);
+      } on SocketException {
+        // No route for this destination, the others may still work.
+      }
+    }
+    final next = retry * 2 > _maxRetry ? _maxRetry : retry * 2;
+    _timer = Timer(retry, () => _send(socket, targets, next));
+  }
+
+  static DiscoveryAnswer? _parse(Datagram datagram) {
+    final answer = DiscoveryPacket.parseAnswer(datagram.data);
+    if (answer != null) return answer.nonce == _nonce ? answer : null;
+    return Mdns.parseResponse(datagram.data, datagram.address);
+  }
+}
@@ -16,6 +16,18 @@ class Preferences {
 
   static int getPort() => _port ??= (_preferences!.getInt('port') ?? 8080);
 
+  // Resume Grace Period, zero tears the session down on the first drop.
+  static Future<bool> setResumeGracePeriod(Duration period) =>
+      _preferences!.setInt('resume-grace-period', period.inMilliseconds);
+  static Duration getResumeGracePeriod() => Duration(
+      milliseconds: _preferences!.getInt('resume-grace-period') ?? 10000);
+
+  // Video Layer, the resolution asked of the phone: full, half or quarter.
+  static Future<bool> setVideoLayer(String value) =>
+      _preferences!.setString('video-layer', value);
+  static String getVideoLayer() =>
+      _preferences!.getString('video-layer') ?? 'full';
+
   // Video Device Enabled
   static Future<bool> setVideoDeviceEnabled(bool state) =>
       _preferences!.setBool('video-device', state);
@@ -17,6 +17,8 @@ class RequestName {
 
   static const String maxFramerate = 'max-framerate';
 
+  static const String orientation = 'orientation';
+
   static const String resolution = 'resolution';
 
   static const String resolutionPresets = 'resolution-presets';
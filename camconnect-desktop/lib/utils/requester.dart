@@ -2,13 +2,30 @@ import 'dart:async';
 
 import 'request_names.dart';
 
+/// Requests settings of the phone and follows its changes to them.
+///
+/// [getSnapshot] gets every setting in one round trip. After it, the phone
+/// pushes changes as numbered deltas to [onUpdateRequest]. A gap in the
+/// numbers, e.g. deltas lost while the signaling socket was down, calls
+/// [onResync] to take a new snapshot.
 class Requester {
+  static const protocolVersion = 1;
+
   static void Function(Map<String, dynamic>)? onSend;
   static void Function(Map<String, dynamic>)? onUpdateRequest;
+  static void Function()? onResync;
   static void Function(String)? onError;
 
+  static const _timeout = Duration(milliseconds: 600);
+  static const _snapshotTimeout = Duration(milliseconds: 1500);
+
   static final Map<String, Completer<Map<String, dynamic>>> _completers = {};
 
+  static int? _seq;
+  static Completer<Map<String, dynamic>>? _snapshotCompleter;
+  static Future<Map<String, dynamic>?>? _snapshot;
+  static final List<Map<String, dynamic>> _deltasDuringSnapshot = [];
+
   static void handleResponse(Map<String, dynamic> response) {
     response.forEach((name, value) {
       if ((value is! Map<String, dynamic>) || value.keys.isEmpty) {
@@ -21,8 +38,19 @@ class Requester {
           completer?.complete(value);
           break;
         case 'set-response':
-          var completer = _completers.remove(value.keys.first);
-          completer?.complete(value);
+          // A set-request of several settings is answered at once.
+          for (final key in value.keys) {
+            _completers.remove(key)?.complete(value);
+          }
+          break;
+        case 'snapshot-response':
+          final completer = _snapshotCompleter;
+          if (completer != null && !completer.isCompleted) {
+            completer.complete(value);
+          }
+          break;
+        case 'delta':
+          _handleDelta(value);
           break;
         case 'set-update':
           onUpdateRequest?.call(value);
@@ -34,6 +62,19 @@ class Requester {
     });
   }
 
+  /// Every setting the phone could read, with the deltas pushed while
+  /// waiting for it applied on top. Null if the request failed.
+  static Future<Map<String, dynamic>?> getSnapshot() =>
+      _snapshot ??= _fetchSnapshot().whenComplete(() => _snapshot = null);
+
+  /// Sets all of [settings] or, if one fails, none of them.
+  static Future<bool> setSettings(Map<String, dynamic> settings) async {
+    final responses = settings.keys.map(_setResponse).toList();
+    onSend?.call({'set-request': settings});
+    final results = await Future.wait(responses);
+    return results.every((success) => success);
+  }
+
   static Future<List<dynamic>?> getCameras() {
     return _getRequest<List<dynamic>>(RequestName.cameras);
   }
@@ -132,11 +173,11 @@ class Requester {
     return null; // Indicates either failed or received invalid type / response.
   }
 
-  static Future<bool> _setRequest(String name, dynamic value) async {
-    onSend?.call({
-      'set-request': {name: value}
-    });
+  static Future<bool> _setRequest(String name, dynamic value) {
+    return setSettings({name: value});
+  }
 
+  static Future<bool> _setResponse(String name) async {
     final Map<String, dynamic> response;
     try {
       response = await _fetchResponse(name, 'set');
@@ -158,13 +199,85 @@ class Requester {
     return response['result'] == 'success';
   }
 
+  static Future<Map<String, dynamic>?> _fetchSnapshot() async {
+    final completer = _snapshotCompleter = Completer<Map<String, dynamic>>();
+    onSend?.call({'snapshot-request': protocolVersion});
+
+    final timer = Timer(_snapshotTimeout, () {
+      if (!completer.isCompleted) {
+        completer.completeError("snapshot-request: request timed out");
+      }
+    });
+
+    final Map<String, dynamic> response;
+    try {
+      response = await completer.future;
+    } catch (e) {
+      onError?.call(e.toString());
+      _replayDeltas();
+      return null;
+    } finally {
+      timer.cancel();
+      _snapshotCompleter = null;
+    }
+
+    final seq = response['seq'];
+    final settings = response['settings'];
+    if (response['version'] != protocolVersion ||
+        seq is! int ||
+        settings is! Map<String, dynamic>) {
+      onError?.call("Received invalid snapshot-response: $response");
+      _replayDeltas();
+      return null;
+    }
+
+    // Deltas up to seq are in the snapshot already.
+    _seq = seq;
+    final result = Map<String, dynamic>.of(settings);
+    for (final delta in _deltasDuringSnapshot) {
+      if (delta['seq'] > _seq!) {
+        _seq = delta['seq'];
+        result.addAll(delta['settings']);
+      }
+    }
+    _deltasDuringSnapshot.clear();
+    return result;
+  }
+
+  static void _handleDelta(Map<String, dynamic> delta) {
+    final seq = delta['seq'];
+    final settings = delta['settings'];
+    if (seq is! int || settings is! Map<String, dynamic>) {
+      return onError?.call("Received invalid delta: $delta");
+    }
+
+    if (_snapshotCompleter != null) {
+      return _deltasDuringSnapshot.add(delta);
+    }
+
+    final last = _seq;
+    if (last != null && seq <= last) return; // in the snapshot already.
+    _seq = seq;
+    if (settings.isNotEmpty) onUpdateRequest?.call(settings);
+    if (last != null && seq != last + 1) onResync?.call(); // missed some.
+  }
+
+  /// Hands deltas held for a snapshot that failed to [onUpdateRequest].
+  static void _replayDeltas() {
+    final deltas = List.of(_deltasDuringSnapshot);
+    _deltasDuringSnapshot.clear();
+    for (final delta in deltas) {
+      _handleDelta(delta);
+    }
+  }
+
   static Future<dynamic> _fetchResponse(
       String requestName, String requestType) async {
     var completer = Completer<Map<String, dynamic>>();
     _completers[requestName] = completer;
 
     // Set a timeout for the request
-    Timer(const Duration(milliseconds: 600), () {
+    Timer(_timeout, () {
       if (!completer.isCompleted) {
         completer
             .completeError("$requestType-$requestName: request timeout out");
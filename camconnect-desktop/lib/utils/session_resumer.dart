@@ -0,0 +1,47 @@
+import 'dart:async';
+
+/// Keeps an interrupted session alive for a grace period.
+///
+/// While the peer connection or the signaling socket is down the session is
+/// interrupted, [resume] ends that, otherwise [onExpired] is called once the
+/// grace period runs out and the session should be torn down.
+class SessionResumer {
+  SessionResumer({required this.onExpired});
+
+  final void Function() onExpired;
+
+  Timer? _timer;
+  final _interruption = Stopwatch();
+
+  bool get isInterrupted => _timer != null;
+
+  /// Starts the grace period, unless the session is already interrupted. A
+  /// zero [gracePeriod] expires at once.
+  void interrupt(Duration gracePeriod) {
+    if (_timer != null) return;
+    if (gracePeriod <= Duration.zero) return onExpired();
+
+    _interruption
+      ..reset()
+      ..start();
+    _timer = Timer(gracePeriod, () {
+      _timer = null;
+      _interruption.stop();
+      onExpired();
+    });
+  }
+
+  /// Ends the interruption, returns how long it lasted or null if the
+  /// session wasn't interrupted.
+  Duration? resume() {
+    if (_timer == null) return null;
+    cancel();
+    return _interruption.elapsed;
+  }
+
+  void cancel() {
+    _timer?.cancel();
+    _timer = null;
+    _interruption.stop();
+  }
+}
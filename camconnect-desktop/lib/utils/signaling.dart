@@ -1,5 +1,8 @@
 import 'package:flutter_webrtc/flutter_webrtc.dart';
 
+import 'preferences.dart';
+import 'session_resumer.dart';
+
 class Signaling {
   MediaStream? _remoteStream;
   RTCPeerConnection? _peerConnection;
@@ -10,6 +13,25 @@ class Signaling {
 
   void Function(MediaStream)? onRemoteStream;
 
+  void Function()? onInterrupted;
+
+  /// Called with the time from the interruption to the first frame decoded
+  /// after it, null if none was decoded within the timeout.
+  void Function(Duration?)? onResumed;
+
+  late final _resumer = SessionResumer(onExpired: () => onClose?.call());
+  bool _signalingAttached = true;
+
+  static const _framePollInterval = Duration(milliseconds: 20);
+  static const _frameTimeout = Duration(seconds: 2);
+
+  /// Whether a dropped connection is given a grace period to come back.
+  bool get canResume =>
+      _peerConnection != null &&
+      Preferences.getResumeGracePeriod() > Duration.zero;
+
+  bool get isInterrupted => _resumer.isInterrupted;
+
   bool get isConnected =>
       _peerConnection?.connectionState ==
       RTCPeerConnectionState.RTCPeerConnectionStateConnected;
@@ -30,13 +52,22 @@ class Signaling {
       });
     };
 
+    // The remote peer restarts ICE, this side answers and waits.
     _peerConnection!.onIceConnectionState = (connectionState) {
       switch (connectionState) {
         case RTCIceConnectionState.RTCIceConnectionStateDisconnected:
-          onClose?.call();
-          break;
         case RTCIceConnectionState.RTCIceConnectionStateFailed:
-          onError?.call("WebRTC connection failed.");
+          if (!canResume) {
+            return connectionState ==
+                    RTCIceConnectionState.RTCIceConnectionStateFailed
+                ? onError?.call("WebRTC connection failed.")
+                : onClose?.call();
+          }
+          _interrupt();
+          break;
+        case RTCIceConnectionState.RTCIceConnectionStateConnected:
+        case RTCIceConnectionState.RTCIceConnectionStateCompleted:
+          if (_signalingAttached) _resume();
           break;
         default:
       }
@@ -48,6 +79,59 @@ class Signaling {
     };
   }
 
+  /// Keeps the session through the grace period while the signaling socket
+  /// is gone, see [attachSignaling].
+  void detachSignaling() {
+    _signalingAttached = false;
+    _interrupt();
+  }
+
+  /// Resumes an interrupted session over a new signaling socket, the remote
+  /// peer restarts ICE if the connection needs it.
+  void attachSignaling() {
+    _signalingAttached = true;
+    if (isConnected) _resume();
+  }
+
+  void _interrupt() {
+    if (!isInterrupted) onInterrupted?.call();
+    _resumer.interrupt(Preferences.getResumeGracePeriod());
+  }
+
+  Future<void> _resume() async {
+    final interruption = _resumer.resume();
+    if (interruption == null) return;
+    final firstFrame = await _waitForFrame();
+    onResumed?.call(firstFrame == null ? null : interruption + firstFrame);
+  }
+
+  /// Waits until the decoded frame count moves, returns how long that took.
+  /// Null if it didn't move within [_frameTimeout] or the connection closed.
+  Future<Duration?> _waitForFrame() async {
+    final stopwatch = Stopwatch()..start();
+    try {
+      final decoded = await _framesDecoded();
+      while (stopwatch.elapsed < _frameTimeout) {
+        await Future.delayed(_framePollInterval);
+        if (await _framesDecoded() > decoded) return stopwatch.elapsed;
+      }
+    } catch (_) {
+      // Closed meanwhile, no frame came.
+    }
+    return null;
+  }
+
+  Future<num> _framesDecoded() async {
+    final reports = await _peerConnection?.getStats() ?? [];
+    num frames = 0;
+    for (final report in reports) {
+      if (report.type == 'inbound-rtp' && report.values['kind'] == 'video') {
+        frames += report.values['framesDecoded'] ?? 0;
+      }
+    }
+    return frames;
+  }
+
   static const _mediaConstraints = <String, dynamic>{
     'mandatory': {
       'OfferToReceiveAudio': true,
@@ -101,11 +185,14 @@ class Signaling {
   }
 
   Future<void> close() async {
+    _resumer.cancel();
+    _signalingAttached = true;
     await _peerConnection?.close();
     _peerConnection = null;
   }
 
   Future<void> dispose() async {
+    _resumer.cancel();
     await _remoteStream?.dispose();
     await _peerConnection?.close();
     await _peerConnection?.dispose();
@@ -0,0 +1,84 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:camconnect/utils/discovery_packet.dart';
+import 'package:camconnect/utils/discovery_probe.dart';
+import 'package:flutter/foundation.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+void main() {
+  final port = 40000 + Random().nextInt(20000);
+
+  tearDown(DiscoveryProbe.stop);
+
+  test("discovers a phone on loopback", () async {
+    final phone = await _FakePhone.start(port);
+    final time = await _timeToDiscovery(port);
+    phone.close();
+
+    debugPrint("time to discovery, loopback: ${time.inMicroseconds} us");
+    expect(time, lessThan(const Duration(milliseconds: 100)));
+  });
+
+  test("repeats the query for a phone that comes up late", () async {
+    _FakePhone? phone;
+    Timer(const Duration(milliseconds: 300), () async {
+      phone = await _FakePhone.start(port);
+    });
+    final time = await _timeToDiscovery(port);
+    phone?.close();
+
+    // Queried at 0, 250 and 750 ms.
+    expect(time, greaterThanOrEqualTo(const Duration(milliseconds: 300)));
+    expect(time, lessThan(const Duration(seconds: 1)));
+  });
+}
+
+Future<Duration> _timeToDiscovery(int port) async {
+  final discovered = Completer<DiscoveryAnswer>();
+  DiscoveryProbe.onDiscovered = (answer) {
+    if (!discovered.isCompleted) discovered.complete(answer);
+  };
+
+  final stopwatch = Stopwatch()..start();
+  await DiscoveryProbe.start(port,
+      addresses: [InternetAddress.loopbackIPv4], mdnsPort: null);
+  final answer = await discovered.future.timeout(const Duration(seconds: 2));
+  final time = stopwatch.elapsed;
+
+  expect(answer.port, port);
+  expect(answer.name, "fake phone");
+  return time;
+}
+
+/// Answers discovery queries like the phone does.
+class _FakePhone {
+  _FakePhone._(this._socket);
+
+  final RawDatagramSocket _socket;
+
+  static Future<_FakePhone> start(int port) async {
+    final socket =
+        await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, port);
+    socket.listen((event) {
+      final datagram = socket.receive();
+      if (datagram == null) return;
+      final nonce = DiscoveryPacket.parseQuery(datagram.data);
+      if (nonce == null) return;
+      socket.send(
+        DiscoveryPacket.answer(DiscoveryAnswer(
+          address: InternetAddress.loopbackIPv4,
+          port: port,
+          nonce: nonce,
+          name: "fake phone",
+        )),
+        datagram.address,
+        datagram.port,
+      );
+    });
+    return _FakePhone._(socket);
+  }
+
+  void close() => _socket.close();
+}
@@ -7,6 +7,7 @@ void main() {
   group("Request Validation", _testResponseValidation);
   group("Get Responses", _testGetResponses);
   group("Set Responses", _testSetResponses);
+  group("Snapshots and Deltas", _testSnapshotsAndDeltas);
 }
 
 void _testResponseValidation() {
@@ -321,6 +322,165 @@ void _testSetResponses() {
   });
 }
 
+void _testSnapshotsAndDeltas() {
+  const rtt = Duration(milliseconds: 50);
+  const settings = <String, dynamic>{
+    RequestName.cameras: [
+      {'name': 'Back', 'id': '0'}
+    ],
+    RequestName.cameraId: 0,
+    RequestName.microphone: true,
+    RequestName.torch: false,
+    RequestName.hasTorch: true,
+    RequestName.framerate: 30,
+    RequestName.maxFramerate: 30,
+    RequestName.resolution: '1280x720',
+    RequestName.resolutionPresets: <String, dynamic>{},
+  };
+
+  Map<String, dynamic> snapshot(int seq) => {
+        'snapshot-response': {
+          'version': Requester.protocolVersion,
+          'seq': seq,
+          'settings': settings,
+          'errors': <String, dynamic>{},
+        }
+      };
+
+  Map<String, dynamic> delta(int seq, Map<String, dynamic> settings) => {
+        'delta': {'seq': seq, 'settings': settings}
+      };
+
+  tearDown(() {
+    Requester.onSend = null;
+    Requester.onUpdateRequest = null;
+    Requester.onResync = null;
+  });
+
+  test('getSnapshot: every setting in one round trip', () async {
+    // Arrange
+    var requests = 0;
+    Requester.onSend = (request) {
+      requests++;
+      expect(request['snapshot-request'], Requester.protocolVersion);
+      Future.delayed(rtt, () => Requester.handleResponse(snapshot(5)));
+    };
+    final stopwatch = Stopwatch()..start();
+
+    // Act
+    final result = await Requester.getSnapshot();
+
+    // Assert: one round trip, not one per setting. The bound is loose
+    // for loaded machines, serial requests would take 9 x RTT.
+    expect(stopwatch.elapsed, lessThan(rtt * 5));
+    expect(requests, 1);
+    expect(result, settings);
+  });
+
+  test('getSnapshot: deltas pushed meanwhile are applied on top', () async {
+    // Arrange
+    Requester.onSend = (_) {
+      Requester.handleResponse(delta(4, {RequestName.torch: true}));
+      Requester.handleResponse(delta(6, {RequestName.framerate: 15}));
+      Future.delayed(rtt, () => Requester.handleResponse(snapshot(5)));
+    };
+    var updates = 0;
+    Requester.onUpdateRequest = (_) => updates++;
+
+    // Act
+    final result = (await Requester.getSnapshot())!;
+
+    // Assert: delta 4 is in the snapshot already, delta 6 isn't.
+    expect(result[RequestName.torch], settings[RequestName.torch]);
+    expect(result[RequestName.framerate], 15);
+    expect(updates, 0);
+  });
+
+  test('delta: a gap in the sequence asks for a resync', () async {
+    // Arrange
+    Requester.onSend = (_) => Requester.handleResponse(snapshot(10));
+    await Requester.getSnapshot();
+    final updates = <Map<String, dynamic>>[];
+    var resyncs = 0;
+    Requester.onUpdateRequest = updates.add;
+    Requester.onResync = () => resyncs++;
+    var requests = 0;
+    Requester.onSend = (_) => requests++;
+
+    // Act
+    Requester.handleResponse(delta(11, {RequestName.microphone: false}));
+    Requester.handleResponse(delta(13, {RequestName.torch: true}));
+    Requester.handleResponse(delta(12, {RequestName.torch: false}));
+
+    // Assert: applied as they arrive, without a request, the stale one
+    // dropped.
+    expect(requests, 0);
+    expect(updates, [
+      {RequestName.microphone: false},
+      {RequestName.torch: true},
+    ]);
+    expect(resyncs, 1);
+  });
+
+  test('setSettings: several settings in one round trip', () async {
+    // Arrange
+    const request = {
+      RequestName.resolution: '640x480',
+      RequestName.framerate: 15,
+      RequestName.maxFramerate: 15,
+    };
+    var requests = 0;
+    Requester.onSend = (message) {
+      requests++;
+      expect(message['set-request'], request);
+      Future.delayed(rtt, () {
+        Requester.handleResponse({
+          'set-response': {
+            for (final name in request.keys) name: {'result': 'success'}
+          }
+        });
+      });
+    };
+    final stopwatch = Stopwatch()..start();
+
+    // Act
+    final result = await Requester.setSettings(request);
+
+    // Assert: one round trip, not one per setting. Serial requests would
+    // take 3 x RTT.
+    expect(stopwatch.elapsed, lessThan(rtt * 3));
+    expect(requests, 1);
+    expect(result, isTrue);
+  });
+
+  test('setSettings: fails if any setting failed', () async {
+    // Arrange
+    final errors = <String>[];
+    Requester.onError = errors.add;
+    Requester.onSend = (_) {
+      Requester.handleResponse({
+        'set-response': {
+          RequestName.resolution: {
+            'result': 'failure',
+            'error': 'aborted: framerate failed'
+          },
+          RequestName.framerate: {'result': 'failure', 'error': 'failed'},
+        }
+      });
+    };
+
+    // Act
+    final result = await Requester.setSettings({
+      RequestName.resolution: '640x480',
+      RequestName.framerate: 15,
+    });
+
+    // Assert
+    expect(result, isFalse);
+    expect(errors, hasLength(2));
+  });
+}
+
 class TestResponse {
   final String name;
   final dynamic result;
@@ -1,6 +1,38 @@
 package com.example.camconnect
 
+import android.content.Context
+import android.net.wifi.WifiManager
 import io.flutter.embedding.android.FlutterActivity
+import io.flutter.embedding.engine.FlutterEngine
+import io.flutter.plugin.common.MethodChannel
 
 class MainActivity: FlutterActivity() {
+    private var multicastLock: WifiManager.MulticastLock? = null
+
+    override fun configureFlutterEngine(flutterEngine: FlutterEngine) {
+        super.configureFlutterEngine(flutterEngine)
+
+        // Held while answering discovery queries, Wi-Fi drivers filter
+        // multicast packets for apps without it.
+        MethodChannel(flutterEngine.dartExecutor.binaryMessenger, "camconnect/multicast-lock")
+            .setMethodCallHandler { call, result ->
+                when (call.method) {
+                    "acquire" -> {
+                        if (multicastLock == null) {
+                            val wifi = applicationContext.getSystemService(Context.WIFI_SERVICE) as WifiManager
+                            multicastLock = wifi.createMulticastLock("camconnect-discovery").apply {
+                                setReferenceCounted(false)
+                            }
+                        }
+                        multicastLock?.acquire()
+                        result.success(null)
+                    }
+                    "release" -> {
+                        multicastLock?.release()
+                        result.success(null)
+                    }
+                    else -> result.notImplemented()
+                }
+            }
+    }
 }
@@ -91,7 +91,7 @@ class _MainWidgetState extends State<MainWidget> {
       }
     });
 
-    ConnectionManager.signaling.onPermissionError = (errorMsg) {
+    ConnectionManager.media.onPermissionError = (errorMsg) {
       if (errorMsg.isEmpty) {
         // permission granted or no permission error encountered.
         return ScaffoldMessenger.of(context).removeCurrentSnackBar();
@@ -99,7 +99,7 @@ class _MainWidgetState extends State<MainWidget> {
 
       showSnackBarPrompt(context, errorMsg, "Grant Permission", () async {
         try {
-          await ConnectionManager.signaling.updateLocalStream();
+          await ConnectionManager.media.updateLocalStream();
         } catch (e) {
           _showSnackBarMessage(e.toString());
         }
@@ -31,7 +31,7 @@ class _CameraPageState extends State<CameraPage> {
       if (mounted) setState(() {});
     };
 
-    final stream = await ConnectionManager.signaling.getLocalStream();
+    final stream = await ConnectionManager.media.getLocalStream();
     if (stream != null) {
       _setLocalRenderer(stream);
     }
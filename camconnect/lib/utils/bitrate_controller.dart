@@ -0,0 +1,304 @@
+import 'dart:async';
+import 'dart:math';
+
+import 'package:flutter_webrtc/flutter_webrtc.dart';
+
+/// What to give up first when the link can't carry the configured stream.
+enum BitrateMode {
+  /// Keep the frame rate, lower the resolution.
+  latencyFirst,
+
+  /// Keep the resolution, lower the frame rate.
+  qualityFirst,
+}
+
+/// One step of a [BitrateProfile], relative to the configured stream.
+class EncodingRung {
+  const EncodingRung(this.scaleResolutionDownBy, this.framerateFactor);
+
+  final double scaleResolutionDownBy;
+  final double framerateFactor;
+}
+
+class BitrateProfile {
+  const BitrateProfile({
+    required this.rungs,
+    required this.downSamples,
+    required this.upSamples,
+    required this.maxLoss,
+    required this.maxRtt,
+  });
+
+  /// From the configured stream down to the cheapest one.
+  final List<EncodingRung> rungs;
+
+  /// Consecutive congested samples before stepping down a rung.
+  final int downSamples;
+
+  /// Consecutive clear samples before stepping up a rung, more than
+  /// [downSamples] so a recovering link is trusted slowly.
+  final int upSamples;
+
+  /// Loss fraction and round trip time, in seconds, counted as congestion.
+  final double maxLoss;
+  final double maxRtt;
+
+  static const latencyFirst = BitrateProfile(
+    rungs: [
+      EncodingRung(1, 1),
+      EncodingRung(1.5, 1),
+      EncodingRung(2, 1),
+      EncodingRung(3, 1),
+      EncodingRung(4, 0.5),
+    ],
+    downSamples: 2,
+    upSamples: 6,
+    maxLoss: 0.03,
+    maxRtt: 0.15,
+  );
+
+  static const qualityFirst = BitrateProfile(
+    rungs: [
+      EncodingRung(1, 1),
+      EncodingRung(1, 2 / 3),
+      EncodingRung(1, 0.5),
+      EncodingRung(1.5, 0.5),
+      EncodingRung(2, 1 / 3),
+    ],
+    downSamples: 3,
+    upSamples: 5,
+    maxLoss: 0.08,
+    maxRtt: 0.4,
+  );
+
+  static BitrateProfile of(BitrateMode mode) => switch (mode) {
+        BitrateMode.latencyFirst => latencyFirst,
+        BitrateMode.qualityFirst => qualityFirst,
+      };
+}
+
+/// Link conditions seen by the sender over one sampling period.
+class LinkSample {
+  const LinkSample({
+    this.availableBitrate,
+    this.rtt,
+    this.loss = 0,
+    this.qualityLimitationReason = 'none',
+  });
+
+  /// Bits per second the congestion controller estimates it can send.
+  final double? availableBitrate;
+
+  /// Seconds.
+  final double? rtt;
+
+  /// Fraction of the packets sent in the period that were lost.
+  final double loss;
+
+  final String qualityLimitationReason;
+}
+
+/// The encoding a sender should use, applied by [SenderBitrateController].
+class EncodingTarget {
+  const EncodingTarget(
+      this.maxBitrate, this.scaleResolutionDownBy, this.maxFramerate);
+
+  final int maxBitrate;
+  final double scaleResolutionDownBy;
+  final int maxFramerate;
+}
+
+/// Picks the encoding of a video sender from [LinkSample]s.
+///
+/// The bitrate follows the available outgoing bitrate directly. Resolution
+/// and frame rate move one rung of the profile at a time, down after
+/// [BitrateProfile.downSamples] congested samples and up only after
+/// [BitrateProfile.upSamples] clear ones with room for the richer rung, so
+/// a link near a rung's edge doesn't flap between two rungs.
+class BitrateController {
+  BitrateController({
+    required this.profile,
+    required this.width,
+    required this.height,
+    required this.fps,
+    this.minBitrate = 150000,
+  }) : _target = _targetFor(profile.rungs.first, _bitrateFor(width, height,
+            fps.toDouble()), fps);
+
+  final BitrateProfile profile;
+  final int width, height, fps;
+  final int minBitrate;
+
+  // Bits per pixel a rung needs to look acceptable, and the share of the
+  // available bitrate given to video.
+  static const _bitsPerPixel = 0.08;
+  static const _headroom = 0.85;
+
+  int _rung = 0;
+  int _congested = 0, _clear = 0;
+  EncodingTarget _target;
+
+  int get rung => _rung;
+  EncodingTarget get target => _target;
+
+  /// Updates the target from [sample], returns it if it changed enough to be
+  /// worth applying, otherwise null.
+  EncodingTarget? onSample(LinkSample sample) {
+    final available = sample.availableBitrate;
+    final budget = available == null ? null : available * _headroom;
+
+    final congested = sample.loss > profile.maxLoss ||
+        (sample.rtt ?? 0) > profile.maxRtt ||
+        sample.qualityLimitationReason == 'bandwidth' ||
+        sample.qualityLimitationReason == 'cpu' ||
+        (budget != null && budget < _needOf(_rung));
+    final clear = !congested &&
+        sample.loss <= profile.maxLoss / 2 &&
+        (sample.rtt ?? 0) <= profile.maxRtt / 2 &&
+        (budget == null || _rung == 0 || budget >= _needOf(_rung - 1) * 1.2);
+
+    _congested = congested ? _congested + 1 : 0;
+    _clear = clear ? _clear + 1 : 0;
+
+    var rung = _rung;
+    if (_congested >= profile.downSamples && rung < profile.rungs.length - 1) {
+      rung++;
+    } else if (_clear >= profile.upSamples && rung > 0) {
+      rung--;
+    }
+    if (rung != _rung) {
+      _rung = rung;
+      _congested = _clear = 0;
+    }
+
+    final need = _needOf(_rung);
+    final bitrate = budget == null
+        ? need
+        : min(max(budget, minBitrate.toDouble()), _needOf(0) * 1.5);
+    final target = _targetFor(profile.rungs[_rung], bitrate, fps);
+
+    // Small bitrate moves aren't worth a setParameters round trip.
+    if (target.scaleResolutionDownBy == _target.scaleResolutionDownBy &&
+        target.maxFramerate == _target.maxFramerate &&
+        (target.maxBitrate - _target.maxBitrate).abs() <
+            _target.maxBitrate * 0.1) {
+      return null;
+    }
+    return _target = target;
+  }
+
+  double _needOf(int rung) {
+    final r = profile.rungs[rung];
+    return _bitrateFor(width / r.scaleResolutionDownBy,
+        height / r.scaleResolutionDownBy, fps * r.framerateFactor);
+  }
+
+  static double _bitrateFor(num width, num height, double fps) =>
+      width * height * fps * _bitsPerPixel;
+
+  static EncodingTarget _targetFor(
+          EncodingRung rung, double bitrate, int fps) =>
+      EncodingTarget(
+        bitrate.round(),
+        rung.scaleResolutionDownBy,
+        (fps * rung.framerateFactor).round().clamp(1, fps),
+      );
+}
+
+/// Samples the stats of a video sender every [interval] and applies the
+/// encodings [BitrateController] picks.
+///
+/// [layerScale] is the viewer's own downscale of the capture, applied on
+/// top of the controller's.
+class SenderBitrateController {
+  SenderBitrateController(this._sender, this._controller,
+      {this.interval = const Duration(seconds: 1), this.layerScale = 1});
+
+  final RTCRtpSender _sender;
+  final BitrateController _controller;
+  final Duration interval;
+  final double layerScale;
+
+  Timer? _timer;
+  bool _sampling = false;
+  num? _packetsSent, _packetsLost;
+
+  void start() {
+    if (_timer != null) return;
+    _timer = Timer.periodic(interval, (_) => _sample());
+    _apply(_controller.target).catchError((_) {});
+  }
+
+  void stop() {
+    _timer?.cancel();
+    _timer = null;
+  }
+
+  Future<void> _sample() async {
+    // A slow getStats skips ticks rather than piling up.
+    if (_sampling) return;
+    _sampling = true;
+    try {
+      final target = _controller.onSample(_toSample(await _sender.getStats()));
+      if (target != null && _timer != null) await _apply(target);
+    } catch (_) {
+      // The sender may be gone, the connection's own callbacks handle that.
+    } finally {
+      _sampling = false;
+    }
+  }
+
+  LinkSample _toSample(List<StatsReport> reports) {
+    double? available, rtt;
+    num? packetsSent, packetsLost;
+    var limitation = 'none';
+    for (final report in reports) {
+      final values = report.values;
+      switch (report.type) {
+        case 'candidate-pair':
+          if (values['state'] != 'succeeded') break;
+          available = (values['availableOutgoingBitrate'] as num?)?.toDouble();
+          rtt = (values['currentRoundTripTime'] as num?)?.toDouble();
+          break;
+        case 'outbound-rtp':
+          if (values['kind'] != 'video') break;
+          packetsSent = values['packetsSent'];
+          limitation = values['qualityLimitationReason'] ?? limitation;
+          break;
+        case 'remote-inbound-rtp':
+          if (values['kind'] != 'video') break;
+          packetsLost = values['packetsLost'];
+          break;
+      }
+    }
+
+    var loss = 0.0;
+    if (packetsSent != null && packetsLost != null) {
+      final sent = packetsSent - (_packetsSent ?? packetsSent);
+      final lost = packetsLost - (_packetsLost ?? packetsLost);
+      if (sent > 0) loss = (lost / sent).clamp(0.0, 1.0).toDouble();
+    }
+    _packetsSent = packetsSent;
+    _packetsLost = packetsLost;
+
+    return LinkSample(
+      availableBitrate: available,
+      rtt: rtt,
+      loss: loss,
+      qualityLimitationReason: limitation,
+    );
+  }
+
+  Future<void> _apply(EncodingTarget target) async {
+    final parameters = _sender.parameters;
+    final encodings = parameters.encodings;
+    if (encodings == null || encodings.isEmpty) return;
+    for (final encoding in encodings) {
+      encoding.maxBitrate = target.maxBitrate;
+      encoding.scaleResolutionDownBy =
+          target.scaleResolutionDownBy * layerScale;
+      encoding.maxFramerate = target.maxFramerate;
+    }
+    await _sender.setParameters(parameters);
+  }
+}
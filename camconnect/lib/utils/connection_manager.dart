@@ -5,11 +5,12 @@ import 'package:connectivity_plus/connectivity_plus.dart';
 import 'package:flutter_webrtc/flutter_webrtc.dart';
 import 'package:network_info_plus/network_info_plus.dart';
 
-import 'broadcaster.dart';
+import 'discovery_packet.dart';
+import 'discovery_responder.dart';
 import 'preferences.dart';
 import 'request_handler.dart';
+import 'local_media.dart';
 import 'server.dart';
-import 'signaling.dart';
 
 enum ConnectionStatus {
   notConnected,
@@ -21,7 +22,6 @@ enum ConnectionStatus {
 
 class ConnectionManager {
   static int get port => Preferences.getPort();
-  static const _broadcastMessage = "camconnect broadcast";
 
   static bool networkDiscoveryEnabled = true;
   static String errorMsg = "", connectivityErrorMsg = "";
@@ -30,7 +30,7 @@ class ConnectionManager {
   static InternetAddress? currentAddress;
   static String? get remoteAddress => _server.remoteAddress?.address;
   static ConnectionStatus get connectionStatus => _connectionStatus;
-  static Signaling get signaling => _server.signaling;
+  static LocalMedia get media => _server.media;
 
   static void Function(String?)? onIPChanged;
   static void Function(String)? onError, onConnectivityError;
@@ -80,7 +80,7 @@ class ConnectionManager {
 
     if (networkDiscoveryEnabled) {
       try {
-        await Broadcaster.start(currentAddress!, port, _broadcastMessage);
+        await _startDiscovery();
       } catch (e) {
         onError?.call(e.toString()); // port binding may fail
       }
@@ -91,7 +91,7 @@ class ConnectionManager {
   }
 
   static Future<void> disconnect() async {
-    Broadcaster.stop();
+    DiscoveryResponder.stop();
     await _server.disconnect();
     _updateStatus(ConnectionStatus.disconnected);
   }
@@ -104,9 +104,9 @@ class ConnectionManager {
 
   static Future<void> setNetworkDiscoveryEnabled(bool enable) async {
     if (!enable) {
-      Broadcaster.stop();
+      DiscoveryResponder.stop();
     } else if (currentAddress != null) {
-      await Broadcaster.start(currentAddress!, port, _broadcastMessage);
+      await _startDiscovery();
     }
     networkDiscoveryEnabled = enable;
   }
@@ -120,8 +120,8 @@ class ConnectionManager {
   }
 
   static void _setupCallbacks() {
+    // Discovery keeps answering while connected, so more desktops can join.
     _server.onConnected = () {
-      Broadcaster.stop();
       _stopNetworkChangeListener();
       _updateStatus(ConnectionStatus.connected);
     };
@@ -130,16 +130,37 @@ class ConnectionManager {
     _server.onError = _updateErrorMsg;
     _server.onSoftError = onError;
 
-    _server.onReceivedMessage = RequestHandler.handleRequest;
+    DiscoveryResponder.onError = (e) => onError?.call(e);
+
+    _server.onReceivedMessage =
+        (request, viewer) => RequestHandler.handleRequest(request, viewer.send);
     RequestHandler.onSend = _server.sendMessage;
+    RequestHandler.onSendUpdate = _server.sendMessage;
 
-    _server.signaling.onLocalStream = (stream) {
+    _server.media.onLocalStream = (stream) {
       _localStreamController.add(stream);
     };
 
     _startNetworkChangeListener();
   }
 
+  static Future<void> _startDiscovery() {
+    var capabilities = 0;
+    if (Preferences.getMicEnabled()) {
+      capabilities |= DiscoveryCapability.audio;
+    }
+    if (Preferences.getResumeGracePeriod() > Duration.zero) {
+      capabilities |= DiscoveryCapability.resume;
+    }
+    return DiscoveryResponder.start(
+      currentAddress!,
+      port,
+      name: Platform.localHostname,
+      capabilities: capabilities,
+      mdns: Preferences.getMdnsEnabled(),
+    );
+  }
+
   static void _startNetworkChangeListener() {
     _networkChangeListener ??=
         Connectivity().onConnectivityChanged.listen((result) {
@@ -184,7 +205,7 @@ class ConnectionManager {
   static Future<void> dispose() async {
     await _statusController.close();
     await _localStreamController.close();
-    await _server.signaling.dispose();
+    await _server.dispose();
   }
 }
 
@@ -0,0 +1,122 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+/// Capabilities a phone announces in its [DiscoveryAnswer].
+class DiscoveryCapability {
+  static const audio = 1 << 0;
+  static const resume = 1 << 1;
+}
+
+/// The camconnect LAN discovery protocol.
+///
+/// The desktop sends a query to [group] (and to the broadcast address) on
+/// the connection port, phones answer it at once by unicast. All fields
+/// are big-endian:
+///
+///     query:  "CCDP" | version u8 | kind u8 = 0 | nonce u32
+///     answer: "CCDP" | version u8 | kind u8 = 1 | nonce u32 | port u16 |
+///             capabilities u16 | address length u8 | address |
+///             name length u8 | name (UTF-8)
+///
+/// Readers ignore bytes past the fields they know, so later versions may
+/// append fields.
+class DiscoveryPacket {
+  static const version = 1;
+  static final group = InternetAddress('239.255.67.67');
+
+  static const _magic = [0x43, 0x43, 0x44, 0x50]; // "CCDP"
+  static const _query = 0, _answer = 1;
+  static const _headerSize = 10;
+
+  static Uint8List query(int nonce) {
+    final bytes = ByteData(_headerSize);
+    _writeHeader(bytes, _query, nonce);
+    return bytes.buffer.asUint8List();
+  }
+
+  /// The nonce of a query, null if [packet] isn't one.
+  static int? parseQuery(Uint8List packet) {
+    final bytes = _readHeader(packet, _query);
+    return bytes?.getUint32(6);
+  }
+
+  static Uint8List answer(DiscoveryAnswer answer) {
+    final address = answer.address.rawAddress;
+    var name = utf8.encode(answer.name);
+    if (name.length > 255) name = name.sublist(0, 255);
+
+    final bytes =
+        ByteData(_headerSize + 6 + address.length + 1 + name.length);
+    _writeHeader(bytes, _answer, answer.nonce);
+    bytes.setUint16(10, answer.port);
+    bytes.setUint16(12, answer.capabilities);
+    bytes.setUint8(14, address.length);
+    final list = bytes.buffer.asUint8List();
+    list.setAll(15, address);
+    bytes.setUint8(15 + address.length, name.length);
+    list.setAll(16 + address.length, name);
+    return list;
+  }
+
+  /// The answer in [packet], null if it isn't a well-formed one.
+  static DiscoveryAnswer? parseAnswer(Uint8List packet) {
+    final bytes = _readHeader(packet, _answer);
+    if (bytes == null || packet.length < _headerSize + 5) return null;
+
+    final addressLength = bytes.getUint8(14);
+    if (addressLength != 4 && addressLength != 16) return null;
+    final nameOffset = 15 + addressLength;
+    if (packet.length < nameOffset + 1) return null;
+    final nameLength = bytes.getUint8(nameOffset);
+    if (packet.length < nameOffset + 1 + nameLength) return null;
+
+    return DiscoveryAnswer(
+      nonce: bytes.getUint32(6),
+      address: InternetAddress.fromRawAddress(
+          packet.sublist(15, 15 + addressLength)),
+      port: bytes.getUint16(10),
+      capabilities: bytes.getUint16(12),
+      name: utf8.decode(
+          packet.sublist(nameOffset + 1, nameOffset + 1 + nameLength),
+          allowMalformed: true),
+    );
+  }
+
+  static void _writeHeader(ByteData bytes, int kind, int nonce) {
+    for (var i = 0; i < _magic.length; i++) {
+      bytes.setUint8(i, _magic[i]);
+    }
+    bytes.setUint8(4, version);
+    bytes.setUint8(5, kind);
+    bytes.setUint32(6, nonce);
+  }
+
+  static ByteData? _readHeader(Uint8List packet, int kind) {
+    if (packet.length < _headerSize) return null;
+    for (var i = 0; i < _magic.length; i++) {
+      if (packet[i] != _magic[i]) return null;
+    }
+    final bytes = ByteData.sublistView(packet);
+    if (bytes.getUint8(4) < 1 || bytes.getUint8(5) != kind) return null;
+    return bytes;
+  }
+}
+
+class DiscoveryAnswer {
+  const DiscoveryAnswer({
+    required this.address,
+    required this.port,
+    this.nonce = 0,
+    this.capabilities = 0,
+    this.name = "",
+  });
+
+  final InternetAddress address;
+  final int port;
+
+  /// The nonce of the query answered, zero for mDNS answers.
+  final int nonce;
+  final int capabilities;
+  final String name;
+}
@@ -0,0 +1,147 @@
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+import 'discovery_packet.dart';
+import 'mdns.dart';
+
+/// Answers the desktop's discovery queries while waiting for a connection.
+///
+/// Nothing is sent until a query arrives, so an idle phone doesn't keep its
+/// radio awake. With [start]'s `mdns` the service is also advertised over
+/// multicast DNS, which some networks pass when they filter broadcasts.
+class DiscoveryResponder {
+  static void Function(String)? onError;
+
+  static bool get isActive => _socket != null;
+
+  static RawDatagramSocket? _socket, _mdnsSocket;
+  static DiscoveryAnswer? _answer;
+
+  // Android drops multicast packets to apps that don't hold the lock.
+  static const _multicastLock = MethodChannel('camconnect/multicast-lock');
+
+  /// Answers queries on [port] with [address], [port], [name] and
+  /// [capabilities]. Only [DiscoveryPacket.group] is joined on
+  /// [address]'s interface, unicast and broadcast queries work anywhere.
+  static Future<void> start(
+    InternetAddress address,
+    int port, {
+    String name = "",
+    int capabilities = 0,
+    bool mdns = false,
+    int mdnsPort = Mdns.port,
+  }) async {
+    stop();
+    _answer = DiscoveryAnswer(
+      address: address,
+      port: port,
+      capabilities: capabilities,
+      name: name,
+    );
+
+    if (Platform.isAndroid) await _multicastLock.invokeMethod('acquire');
+
+    final NetworkInterface? interface;
+    try {
+      interface = await _interfaceOf(address);
+      _socket = await _bind(port, DiscoveryPacket.group, interface, (datagram) {
+        final nonce = DiscoveryPacket.parseQuery(datagram.data);
+        if (nonce == null || _answer == null) return;
+        _reply(_socket, datagram, DiscoveryPacket.answer(_withNonce(nonce)));
+      });
+    } finally {
+      // stop() releases the lock only once the socket is bound.
+      if (_socket == null && Platform.isAndroid) {
+        _multicastLock.invokeMethod('release');
+      }
+    }
+
+    if (mdns) {
+      try {
+        _mdnsSocket = await _bind(mdnsPort, Mdns.group, interface, (datagram) {
+          final id = Mdns.parseQuery(datagram.data);
+          if (id == null || _answer == null) return;
+          // One-shot queries come from other ports and get a unicast reply.
+          final legacy = datagram.port != Mdns.port;
+          final response =
+              Mdns.response(_answer!, legacyId: legacy ? id : null);
+          if (legacy) {
+            _reply(_mdnsSocket, datagram, response);
+          } else {
+            _mdnsSocket?.send(response, Mdns.group, Mdns.port);
+          }
+        });
+        // Announce once, so listening browsers see the phone unasked.
+        _mdnsSocket!.send(Mdns.response(_answer!), Mdns.group, Mdns.port);
+      } on SocketException catch (e) {
+        onError?.call("mDNS advertising unavailable: ${e.message}");
+      }
+    }
+  }
+
+  static void stop() {
+    if (_socket != null && Platform.isAndroid) {
+      _multicastLock.invokeMethod('release');
+    }
+    _socket?.close();
+    _mdnsSocket?.close();
+    _socket = _mdnsSocket = null;
+    _answer = null;
+  }
+
+  static DiscoveryAnswer _withNonce(int nonce) => DiscoveryAnswer(
+        address: _answer!.address,
+        port: _answer!.port,
+        nonce: nonce,
+        capabilities: _answer!.capabilities,
+        name: _answer!.name,
+      );
+
+  static void _reply(
+      RawDatagramSocket? socket, Datagram query, Uint8List packet) {
+    socket?.send(packet, query.address, query.port);
+  }
+
+  static Future<RawDatagramSocket> _bind(
+    int port,
+    InternetAddress group,
+    NetworkInterface? interface,
+    void Function(Datagram) onDatagram,
+  ) async {
+    // Bound to any address, a socket bound to one doesn't see broadcasts
+    // or multicasts on every platform.
+    final socket = await RawDatagramSocket.bind(
+      InternetAddress.anyIPv4,
+      port,
+      reuseAddress: true,
+    );
+    try {
+      socket.joinMulticast(group, interface);
+    } on SocketException catch (e) {
+      onError?.call("Multicast discovery unavailable: ${e.message}");
+    }
+    socket.listen(
+      (event) {
+        if (event != RawSocketEvent.read) return;
+        final datagram = socket.receive();
+        if (datagram != null) onDatagram(datagram);
+      },
+      cancelOnError: true,
+      onError: (error) => onError?.call(error.toString()),
+    );
+    return socket;
+  }
+
+  static Future<NetworkInterface?> _interfaceOf(InternetAddress address) async {
+    final interfaces =
+        await NetworkInterface.list(type: InternetAddressType.IPv4);
+    for (final interface in interfaces) {
+      if (interface.addresses.any((e) => e.address == address.address)) {
+        return interface;
+      }
+    }
+    return null;
+  }
+}
@@ -0,0 +1,77 @@
+import 'package:flutter_webrtc/flutter_webrtc.dart';
+
+import 'preferences.dart';
+
+/// The camera/microphone stream, captured once and shared by every viewer's
+/// peer connection.
+class LocalMedia {
+  MediaStream? _localStream;
+
+  void Function(String)? onPermissionError;
+  void Function(MediaStream)? onLocalStream;
+
+  /// Called after [updateConstrains] recaptured the stream, so senders can
+  /// switch to its tracks.
+  Future<void> Function(MediaStream)? onTracksReplaced;
+
+  /// Called after [updateLocalStream] got a stream, e.g. once permission
+  /// was granted, so connections without one can add it.
+  Future<void> Function(MediaStream)? onStreamAvailable;
+
+  MediaStream? get localStream => _localStream;
+
+  Future<MediaStream?> getLocalStream() async {
+    if (_localStream != null) return _localStream;
+
+    try {
+      await _initLocalStream();
+      onPermissionError?.call("");
+    } catch (e) {
+      onPermissionError?.call(
+        "Permission Denied. Cannot access "
+        "${Preferences.getMicEnabled() ? 'camera/microphone' : 'camera'}"
+        " without permission, Please grant permission.",
+      );
+    }
+    return _localStream;
+  }
+
+  Future<void> updateConstrains() async {
+    if (_localStream == null) return;
+
+    _localStream!.getTracks().forEach((track) {
+      track.stop();
+    });
+
+    await _initLocalStream();
+    onLocalStream?.call(_localStream!);
+    await onTracksReplaced?.call(_localStream!);
+  }
+
+  Future<void> updateLocalStream() async {
+    final stream = await getLocalStream();
+    if (stream == null) return;
+
+    onLocalStream?.call(stream);
+    await onStreamAvailable?.call(stream);
+  }
+
+  Future<void> _initLocalStream() async {
+    final dimensions =
+        Preferences.getResolution().split('x').map((res) => int.parse(res));
+    // Initialize the local camera stream
+    _localStream = await navigator.mediaDevices.getUserMedia({
+      'audio': Preferences.getMicEnabled(),
+      'video': {
+        'deviceId': Preferences.getCameraId().toString(),
+        'width': dimensions.first,
+        'height': dimensions.last,
+        'frameRate': Preferences.getFps().toDouble(),
+      },
+    });
+  }
+
+  Future<void> dispose() async {
+    await _localStream?.dispose();
+  }
+}
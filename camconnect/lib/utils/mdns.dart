@@ -0,0 +1,272 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'discovery_packet.dart';
+
+/// Just enough DNS-SD over multicast DNS (RFC 6762, RFC 6763) to advertise
+/// and find the camconnect service, for networks that filter broadcasts.
+///
+/// A phone answers PTR queries for [serviceType] with its PTR, SRV, TXT and
+/// A records. The TXT record carries the same fields as a [DiscoveryAnswer].
+class Mdns {
+  static final group = InternetAddress('224.0.0.251');
+  static const port = 5353;
+  static const serviceType = '_camconnect._tcp.local';
+
+  static const _typeA = 1, _typePtr = 12, _typeTxt = 16, _typeSrv = 33;
+  static const _typeAny = 255;
+  static const _classIn = 1;
+  static const _unicastResponse = 0x8000, _cacheFlush = 0x8000;
+  static const _ttl = 120, _legacyTtl = 10;
+
+  /// A one-shot query, the answer comes back by unicast to the socket that
+  /// sent it.
+  static Uint8List query(int id) {
+    final writer = _Writer()
+      ..uint16(id)
+      ..uint16(0) // flags
+      ..uint16(1) // questions
+      ..uint16(0)
+      ..uint16(0)
+      ..uint16(0)
+      ..name(serviceType)
+      ..uint16(_typePtr)
+      ..uint16(_classIn | _unicastResponse);
+    return writer.takeBytes();
+  }
+
+  /// The id of a query asking for [serviceType], null for anything else.
+  static int? parseQuery(Uint8List packet) {
+    try {
+      final reader = _Reader(packet);
+      final id = reader.uint16();
+      final flags = reader.uint16();
+      if (flags & 0x8000 != 0) return null; // a response.
+      final questions = reader.uint16();
+      reader.skip(6);
+      for (var i = 0; i < questions; i++) {
+        final name = reader.name();
+        final type = reader.uint16();
+        reader.skip(2); // class
+        if ((type == _typePtr || type == _typeAny) &&
+            name.toLowerCase() == serviceType) {
+          return id;
+        }
+      }
+    } on RangeError {
+      // Truncated or malformed.
+    }
+    return null;
+  }
+
+  /// The records advertising [answer]. A [legacyId] answers a one-shot
+  /// query, which expects its id and question back and short lifetimes.
+  static Uint8List response(DiscoveryAnswer answer, {int? legacyId}) {
+    final label = _label(answer.name);
+    final instance = '$label.$serviceType';
+    final host = '$label.local';
+    final ttl = legacyId == null ? _ttl : _legacyTtl;
+    final flush = legacyId == null ? _cacheFlush : 0;
+
+    final writer = _Writer()
+      ..uint16(legacyId ?? 0)
+      ..uint16(0x8400) // response, authoritative
+      ..uint16(legacyId == null ? 0 : 1)
+      ..uint16(4)
+      ..uint16(0)
+      ..uint16(0);
+    if (legacyId != null) {
+      writer
+        ..name(serviceType)
+        ..uint16(_typePtr)
+        ..uint16(_classIn);
+    }
+
+    writer.record(
+        serviceType, _typePtr, _classIn, ttl, (w) => w.name(instance));
+    writer.record(instance, _typeSrv, _classIn | flush, ttl, (w) {
+      w
+        ..uint16(0) // priority
+        ..uint16(0) // weight
+        ..uint16(answer.port)
+        ..name(host);
+    });
+    writer.record(instance, _typeTxt, _classIn | flush, ttl, (w) {
+      w
+        ..text('v=${DiscoveryPacket.version}')
+        ..text('caps=${answer.capabilities}')
+        ..text('name=${answer.name}');
+    });
+    writer.record(host, _typeA, _classIn | flush, ttl,
+        (w) => w.bytes(answer.address.rawAddress));
+    return writer.takeBytes();
+  }
+
+  /// The service advertised in a response, null if [packet] has none.
+  /// [source] stands in for the address if the A record is missing.
+  static DiscoveryAnswer? parseResponse(
+      Uint8List packet, InternetAddress source) {
+    try {
+      final reader = _Reader(packet);
+      reader.skip(2);
+      if (reader.uint16() & 0x8000 == 0) return null; // a query.
+      final questions = reader.uint16();
+      final records =
+          reader.uint16() + reader.uint16() + reader.uint16();
+      for (var i = 0; i < questions; i++) {
+        reader.name();
+        reader.skip(4);
+      }
+
+      String? target;
+      int? port;
+      final addresses = <String, InternetAddress>{};
+      final txt = <String, String>{};
+      for (var i = 0; i < records; i++) {
+        final name = reader.name().toLowerCase();
+        final type = reader.uint16();
+        reader.skip(6); // class, ttl
+        final length = reader.uint16();
+        final end = reader.offset + length;
+        if (type == _typeSrv && name.endsWith('.$serviceType')) {
+          reader.skip(4);
+          port = reader.uint16();
+          target = reader.name().toLowerCase();
+        } else if (type == _typeA && length == 4) {
+          addresses[name] =
+              InternetAddress.fromRawAddress(reader.bytes(4));
+        } else if (type == _typeTxt && name.endsWith('.$serviceType')) {
+          while (reader.offset < end) {
+            final entry = utf8.decode(reader.bytes(reader.uint8()),
+                allowMalformed: true);
+            final equals = entry.indexOf('=');
+            if (equals > 0) {
+              txt[entry.substring(0, equals)] = entry.substring(equals + 1);
+            }
+          }
+        }
+        reader.offset = end;
+      }
+
+      if (port == null) return null;
+      return DiscoveryAnswer(
+        address: addresses[target] ?? source,
+        port: port,
+        capabilities: int.tryParse(txt['caps'] ?? '') ?? 0,
+        name: txt['name'] ?? '',
+      );
+    } on RangeError {
+      return null; // Truncated or malformed.
+    }
+  }
+
+  /// [name] as a single DNS label.
+  static String _label(String name) {
+    var label = name.replaceAll(RegExp(r'[^A-Za-z0-9-]+'), '-');
+    label = label.replaceAll(RegExp(r'^-+|-+$'), '');
+    if (label.isEmpty) label = 'camconnect';
+    return label.length > 63 ? label.substring(0, 63) : label;
+  }
+}
+
+class _Writer {
+  final _builder = BytesBuilder();
+
+  void uint8(int value) => _builder.addByte(value);
+
+  void uint16(int value) => _builder
+    ..addByte(value >> 8 & 0xFF)
+    ..addByte(value & 0xFF);
+
+  void uint32(int value) {
+    uint16(value >> 16 & 0xFFFF);
+    uint16(value & 0xFFFF);
+  }
+
+  void bytes(List<int> bytes) => _builder.add(bytes);
+
+  /// Uncompressed, the packets are too small for compression to matter.
+  void name(String name) {
+    for (final label in name.split('.')) {
+      final bytes = utf8.encode(label);
+      uint8(bytes.length);
+      _builder.add(bytes);
+    }
+    uint8(0);
+  }
+
+  void text(String text) {
+    var bytes = utf8.encode(text);
+    if (bytes.length > 255) bytes = bytes.sublist(0, 255);
+    uint8(bytes.length);
+    _builder.add(bytes);
+  }
+
+  void record(String owner, int type, int cls, int ttl,
+      void Function(_Writer) data) {
+    final rdata = _Writer();
+    data(rdata);
+    final bytes = rdata.takeBytes();
+    name(owner);
+    uint16(type);
+    uint16(cls);
+    uint32(ttl);
+    uint16(bytes.length);
+    _builder.add(bytes);
+  }
+
+  Uint8List takeBytes() => _builder.takeBytes();
+}
+
+/// Throws [RangeError] past the end of the packet.
+class _Reader {
+  _Reader(this._packet) : _data = ByteData.sublistView(_packet);
+
+  final Uint8List _packet;
+  final ByteData _data;
+  int offset = 0;
+
+  int uint8() => _data.getUint8(offset++);
+
+  int uint16() {
+    final value = _data.getUint16(offset);
+    offset += 2;
+    return value;
+  }
+
+  void skip(int count) {
+    RangeError.checkValueInInterval(offset + count, 0, _packet.length);
+    offset += count;
+  }
+
+  Uint8List bytes(int count) {
+    final bytes = Uint8List.sublistView(_packet, offset, offset + count);
+    offset += count;
+    return bytes;
+  }
+
+  /// Follows compression pointers, which may only point backwards.
+  String name() {
+    final labels = <String>[];
+    var position = offset;
+    int? resume;
+    for (;;) {
+      final length = _data.getUint8(position);
+      if (length & 0xC0 == 0xC0) {
+        final pointer = _data.getUint16(position) & 0x3FFF;
+        resume ??= position + 2;
+        if (pointer >= position) throw RangeError('Bad name pointer');
+        position = pointer;
+      } else if (length == 0) {
+        offset = resume ?? position + 1;
+        return labels.join('.');
+      } else {
+        labels.add(utf8.decode(
+            Uint8List.sublistView(_packet, position + 1, position + 1 + length),
+            allowMalformed: true));
+        position += 1 + length;
+      }
+    }
+  }
+}
@@ -1,5 +1,7 @@
 import 'package:shared_preferences/shared_preferences.dart';
 
+import 'bitrate_controller.dart';
+
 class Preferences {
   static SharedPreferences? _preferences;
 
@@ -59,6 +61,30 @@ class Preferences {
       _preferences!.setInt('max-fps', fps);
   static int getMaxFps() => _preferences!.getInt('max-fps') ?? 30;
 
+  // Bitrate Mode
+  static Future<bool> setBitrateMode(BitrateMode mode) =>
+      _preferences!.setString('bitrate-mode', mode.name);
+  static BitrateMode getBitrateMode() => BitrateMode.values.firstWhere(
+        (mode) => mode.name == _preferences!.getString('bitrate-mode'),
+        orElse: () => BitrateMode.latencyFirst,
+      );
+
+  // Resume Grace Period, zero tears the session down on the first drop.
+  static Future<bool> setResumeGracePeriod(Duration period) =>
+      _preferences!.setInt('resume-grace-period', period.inMilliseconds);
+  static Duration getResumeGracePeriod() => Duration(
+      milliseconds: _preferences!.getInt('resume-grace-period') ?? 10000);
+
+  // mDNS, advertises the service for networks that filter broadcasts.
+  static Future<bool> setMdnsEnabled(bool value) =>
+      _preferences!.setBool('mdns', value);
+  static bool getMdnsEnabled() => _preferences!.getBool('mdns') ?? false;
+
+  // Max Viewers, desktops that may watch at once.
+  static Future<bool> setMaxViewers(int value) =>
+      _preferences!.setInt('max-viewers', value);
+  static int getMaxViewers() => _preferences!.getInt('max-viewers') ?? 4;
+
   // Orientation
   static Future<bool> setOrientation(String value) =>
       _preferences!.setString('orientation', value);
@@ -1,3 +1,5 @@
+import 'dart:async';
+
 import 'package:flutter/foundation.dart';
 import 'package:flutter_webrtc/flutter_webrtc.dart';
 
@@ -5,165 +7,284 @@ import 'preferences.dart';
 import 'request_names.dart';
 import 'settings_manager.dart';
 
+typedef Reply = void Function(Map<String, dynamic>);
+
+/// Serves the desktop's requests and pushes setting changes to it.
+///
+/// Besides one get-request per setting, a "snapshot-request" gets every
+/// setting in one response, stamped with the sequence number of the last
+/// delta. Changes are then pushed as {'delta': {'seq': n, 'settings': {}}},
+/// coalesced over [_coalescing], so a desktop that sees a gap in the
+/// sequence knows it missed some and takes a new snapshot.
+///
+/// A set-request with several settings is applied in order and atomically:
+/// if one fails the ones before it are restored, and each setting's
+/// set-response says why. Its changes go out as a single delta.
 class RequestHandler {
+  static const protocolVersion = 1;
+
+  /// Responds when a request has no reply of its own.
   static void Function(Map<String, dynamic>)? onSend;
 
-  static final List<String> _requestsBeingServed = [];
+  /// Pushes deltas to every viewer.
+  static void Function(Map<String, dynamic>)? onSendUpdate;
+
+  static const _coalescing = Duration(milliseconds: 20);
+
+  static int _seq = 0;
+  static final Map<String, dynamic> _pendingUpdates = {};
+  static Timer? _flushTimer;
+  static int _setRequestsBeingServed = 0;
+
+  static final Map<String, Future<dynamic> Function()> _getters = {
+    RequestName.port: () async => Preferences.getPort(),
+    RequestName.microphone: () async => Variables.isMicOn,
+    RequestName.torch: () async => Variables.isTorchOn,
+    RequestName.hasTorch: () => SettingsManager.getHasTorch(),
+    RequestName.cameraId: () async => Preferences.getCameraId(),
+    RequestName.cameras: () => SettingsManager.getCameras(),
+    RequestName.framerate: () async => Preferences.getFps(),
+    RequestName.maxFramerate: () async => Preferences.getMaxFps(),
+    RequestName.orientation: () async => Preferences.getOrientation(),
+    RequestName.resolution: () async => Preferences.getResolution(),
+    RequestName.resolutionPresets: () async => _serializeResolutionPresets(
+        await SettingsManager.getResolutionPresets()),
+  };
 
-  static void handleRequest(Map<String, dynamic> request) {
+  /// Serves [request], responding with [reply] or else [onSend].
+  static void handleRequest(Map<String, dynamic> request, [Reply? reply]) {
+    final respond = reply ?? (message) => onSend?.call(message);
     if (request.containsKey('get-request')) {
       try {
-        _handleGetRequest(request['get-request']);
+        _handleGetRequest(request['get-request'], respond);
       } catch (_) {
-        onSend?.call({'invalid-get-request': request['get-request']});
+        respond({'invalid-get-request': request['get-request']});
       }
     } else if (request.containsKey('set-request')) {
+      final Map<String, dynamic> settings;
       try {
-        request['set-request'].forEach((name, value) async {
-          _requestsBeingServed.add(name);
-          await _handleSetRequest(name, value);
-          _requestsBeingServed.remove(name);
-        });
+        settings = request['set-request'];
       } catch (_) {
-        onSend?.call({'invalid-set-request': request['set-request']});
+        return respond({'invalid-set-request': request['set-request']});
       }
+      _handleSetRequests(settings, respond);
+    } else if (request.containsKey('snapshot-request')) {
+      _handleSnapshotRequest(respond);
     } else {
-      onSend?.call({'unknown-request': request});
+      respond({'unknown-request': request});
     }
   }
 
   static void sendUpdate(String name, dynamic value) {
-    if (_requestsBeingServed.contains(name)) {
-      return; // currently serving set-request
-      // No need to send set-update request
-    }
-    onSend?.call({
-      'set-update': {name: value}
+    _pendingUpdates[name] = value;
+    _scheduleFlush();
+  }
+
+  static void _scheduleFlush() {
+    if (_setRequestsBeingServed > 0 || _pendingUpdates.isEmpty) return;
+    _flushTimer ??= Timer(_coalescing, _flush);
+  }
+
+  static void _flush() {
+    _flushTimer = null;
+    // Held back until the set-requests being served are done.
+    if (_setRequestsBeingServed > 0 || _pendingUpdates.isEmpty) return;
+    onSendUpdate?.call({
+      'delta': {'seq': ++_seq, 'settings': Map.of(_pendingUpdates)}
     });
+    _pendingUpdates.clear();
   }
 
-  static void _handleGetRequest(String name) {
-    void sendResponse(Future<dynamic> Function() callback) async {
-      final Map<String, dynamic> response = {};
+  static Future<void> _handleSnapshotRequest(Reply reply) async {
+    // Deltas after this one are applied on top, whether or not the values
+    // read below already have them.
+    final seq = _seq;
+    final settings = <String, dynamic>{};
+    final errors = <String, String>{};
+    await Future.wait(_getters.entries.map((getter) async {
       try {
-        response['result'] = await callback();
+        settings[getter.key] = await getter.value();
       } catch (e) {
-        response['error'] = e.toString();
+        errors[getter.key] = e.toString();
       }
-      onSend?.call({
-        'get-response': {name: response}
-      });
+    }));
+    reply({
+      'snapshot-response': {
+        'version': protocolVersion,
+        'seq': seq,
+        'settings': settings,
+        'errors': errors,
+      }
+    });
+  }
+
+  static Future<void> _handleGetRequest(String name, Reply reply) async {
+    final getter = _getters[name];
+    if (getter == null) {
+      return reply({'unknown-get-request': name});
     }
 
-    switch (name) {
-      case RequestName.microphone:
-        sendResponse(() async => Variables.isMicOn);
-        break;
-      case RequestName.torch:
-        sendResponse(() async => Variables.isTorchOn);
-        break;
-      case RequestName.hasTorch:
-        sendResponse(() => SettingsManager.getHasTorch());
-        break;
-      case RequestName.cameraId:
-        sendResponse(() async => Preferences.getCameraId());
-        break;
-      case RequestName.cameras:
-        sendResponse(() => SettingsManager.getCameras());
-        break;
-      case RequestName.framerate:
-        sendResponse(() async => Preferences.getFps());
-        break;
-      case RequestName.maxFramerate:
-        sendResponse(() async => Preferences.getMaxFps());
-        break;
-      case RequestName.orientation:
-        sendResponse(() async => Preferences.getOrientation());
-        break;
-      case RequestName.resolution:
-        sendResponse(() async => Preferences.getResolution());
-        break;
-      case RequestName.resolutionPresets:
-        sendResponse(() async => _serializeResolutionPresets(
-            await SettingsManager.getResolutionPresets()));
-        break;
-      default:
-        onSend?.call({'unknown-get-request': name});
-        break;
+    final Map<String, dynamic> response = {};
+    try {
+      response['result'] = await getter();
+    } catch (e) {
+      response['error'] = e.toString();
     }
+    reply({
+      'get-response': {name: response}
+    });
   }
 
-  static Future<void> _handleSetRequest(String name, dynamic value) async {
-    Future<void> sendResponse(AsyncCallback callback) async {
-      final Map<String, dynamic> response = {};
-      try {
-        await callback();
-        response['result'] = 'success';
-      } catch (e) {
-        response['result'] = 'failure';
-        response['error'] = e.toString();
+  static Future<void> _handleSetRequests(
+      Map<String, dynamic> settings, Reply reply) async {
+    Map<String, dynamic> aborted(String failed) =>
+        {'result': 'failure', 'error': 'aborted: $failed failed'};
+
+    if (settings.isEmpty) return;
+    final batched = settings.length > 1;
+    final setters = <String, AsyncCallback>{};
+    for (final entry in settings.entries) {
+      final setter = _setter(entry.key, entry.value, batched, reply);
+      if (setter == null) {
+        // Rejected and responded to, so none of the others is applied.
+        final others = settings.keys.where((name) => name != entry.key);
+        if (others.isEmpty) return;
+        return reply({
+          'set-response': {for (final name in others) name: aborted(entry.key)}
+        });
       }
-      onSend?.call({
-        'set-response': {name: response}
-      });
+      setters[entry.key] = setter;
     }
 
+    _setRequestsBeingServed++;
+    String? failed;
+    Object? error;
+    try {
+      final previous = <String, dynamic>{};
+      if (batched) {
+        for (final name in setters.keys) {
+          try {
+            previous[name] = await _getters[name]!();
+          } catch (e) {
+            // Nothing to roll back to, so none of them is applied.
+            failed = name;
+            error = e;
+            break;
+          }
+        }
+      }
+
+      final applied = <String>[];
+      for (final entry in setters.entries) {
+        if (failed != null) break;
+        try {
+          await entry.value();
+          applied.add(entry.key);
+        } catch (e) {
+          failed = entry.key;
+          error = e;
+          break;
+        }
+      }
+
+      if (failed != null) {
+        for (final name in applied.reversed) {
+          try {
+            await _setter(name, previous[name], batched, (_) {})!();
+          } catch (_) {
+            // Best effort, the delta tells the desktop what's in effect.
+          }
+        }
+      }
+    } finally {
+      _setRequestsBeingServed--;
+      _scheduleFlush(); // one delta for the whole request.
+    }
+
+    reply({
+      'set-response': {
+        for (final name in setters.keys)
+          name: failed == null
+              ? {'result': 'success'}
+              : name == failed
+                  ? {'result': 'failure', 'error': error.toString()}
+                  : aborted(failed),
+      }
+    });
+  }
+
+  /// Applies setting [name], null if [value] was rejected and responded to.
+  static AsyncCallback? _setter(
+      String name, dynamic value, bool batched, Reply reply) {
     switch (name) {
       case RequestName.port:
-        int? port = _cast<int>(name, value);
-        if (port == null) return;
-        return sendResponse(() => SettingsManager.setPort(port));
+        int? port = _cast<int>(name, value, reply);
+        if (port == null) return null;
+        return () => SettingsManager.setPort(port);
 
       case RequestName.switchCamera:
-        return sendResponse(() => SettingsManager.switchCamera());
+        if (batched) {
+          // Can't be undone if another setting fails.
+          reply({
+            'set-response': {
+              name: {
+                'result': 'failure',
+                'error': 'invalid-argument: $name can\'t be batched'
+              }
+            }
+          });
+          return null;
+        }
+        return () => SettingsManager.switchCamera();
 
       case RequestName.cameraId:
-        int? cameraId = _cast<int>(name, value);
-        if (cameraId == null) return;
-        return sendResponse(() => SettingsManager.setCameraId(cameraId));
+        int? cameraId = _cast<int>(name, value, reply);
+        if (cameraId == null) return null;
+        return () => SettingsManager.setCameraId(cameraId);
 
       case RequestName.torch:
-        bool? turnOn = _cast<bool>(name, value);
-        if (turnOn == null) return;
-        return sendResponse(() => SettingsManager.setTorch(turnOn));
+        bool? turnOn = _cast<bool>(name, value, reply);
+        if (turnOn == null) return null;
+        return () => SettingsManager.setTorch(turnOn);
 
       case RequestName.microphone:
-        bool? turnOn = _cast<bool>(name, value);
-        if (turnOn == null) return;
-        return sendResponse(() async => SettingsManager.setMic(turnOn));
+        bool? turnOn = _cast<bool>(name, value, reply);
+        if (turnOn == null) return null;
+        return () async => SettingsManager.setMic(turnOn);
 
       case RequestName.framerate:
-        int? fps = _cast<int>(name, value);
-        if (fps == null) return;
-        return sendResponse(() => SettingsManager.setFps(fps));
+        int? fps = _cast<int>(name, value, reply);
+        if (fps == null) return null;
+        return () => SettingsManager.setFps(fps);
 
       case RequestName.maxFramerate:
-        int? fps = _cast<int>(name, value);
-        if (fps == null) return;
-        return sendResponse(() => SettingsManager.setMaxFps(fps));
+        int? fps = _cast<int>(name, value, reply);
+        if (fps == null) return null;
+        return () => SettingsManager.setMaxFps(fps);
 
       case RequestName.resolution:
-        String? resolution = _cast<String>(name, value);
-        if (resolution == null) return;
-        return sendResponse(() => SettingsManager.setResolution(resolution));
+        String? resolution = _cast<String>(name, value, reply);
+        if (resolution == null) return null;
+        return () => SettingsManager.setResolution(resolution);
 
       case RequestName.orientation:
-        String? orientation = _cast<String>(name, value);
-        if (orientation == null) return;
-        return sendResponse(() => SettingsManager.setOrientation(orientation));
+        String? orientation = _cast<String>(name, value, reply);
+        if (orientation == null) return null;
+        return () => SettingsManager.setOrientation(orientation);
 
       default:
-        return onSend?.call({
+        reply({
           'unknown-set-request': {name: value}
         });
+        return null;
     }
   }
 
-  static T? _cast<T>(String name, dynamic value) {
+  static T? _cast<T>(String name, dynamic value, Reply reply) {
     if (value is T) {
       return value;
     }
-    onSend?.call({
+    reply({
       'set-response': {
         name: {
           'result': 'failure',
@@ -1,30 +1,86 @@
 import 'dart:convert';
 import 'dart:io';
+import 'dart:math';
 
+import 'local_media.dart';
+import 'preferences.dart';
 import 'signaling.dart';
 
+/// One connected desktop, with its own peer connection.
+class Viewer {
+  Viewer._(this.id, this.signaling, this.address);
+
+  /// Names the session and is the only credential for resuming it, so it's
+  /// random and sent to this viewer alone.
+  final String id;
+  final Signaling signaling;
+  final InternetAddress? address;
+
+  WebSocket? _socket;
+  void Function(String)? _onSoftError;
+
+  /// Sends [message] to this viewer only.
+  void send(Map<String, dynamic> message) {
+    try {
+      _socket?.add(json.encode(message));
+    } catch (e) {
+      _onSoftError?.call(e.toString());
+    }
+  }
+}
+
+/// Serves up to [Preferences.getMaxViewers] desktops at once, all watching
+/// the one [media] capture.
+///
+/// A desktop connects with "/?layer=<full|half|quarter>" to pick the
+/// resolution it's sent. The first message it gets names its session, with
+/// which it can come back to an interrupted session on "/resume?session=",
+/// replacing its old socket if that hasn't noticed the drop yet.
 class Server {
   void Function()? onConnected;
   void Function()? onDisconnected;
   void Function(String)? onError;
   void Function(String)? onSoftError;
 
-  void Function(Map<String, dynamic>)? onReceivedMessage;
+  /// Requests of a viewer, [Viewer.send] replies to it.
+  void Function(Map<String, dynamic>, Viewer)? onReceivedMessage;
 
-  InternetAddress? remoteAddress;
+  final media = LocalMedia();
 
-  final signaling = Signaling();
+  /// Creates the peer connection side of a viewer, replaceable for tests.
+  final Signaling Function(LocalMedia, VideoLayer) createSignaling;
 
-  Server() {
-    signaling.onError = onError;
-    signaling.onClose = _onClose;
-    signaling.onMessageSend = sendMessage;
+  Server({Signaling Function(LocalMedia, VideoLayer)? createSignaling})
+      : createSignaling = createSignaling ??
+            ((media, layer) => Signaling(media, layer: layer)) {
+    media.onTracksReplaced = (stream) async {
+      for (final viewer in List.of(_viewers)) {
+        await viewer.signaling.replaceTracks(stream);
+      }
+    };
+    media.onStreamAvailable = (stream) async {
+      for (final viewer in List.of(_viewers)) {
+        await viewer.signaling.addStreamIfMissing(stream);
+      }
+    };
   }
 
+  static final _random = Random.secure();
+
   HttpServer? _server;
-  WebSocket? _socket;
+  final _viewers = <Viewer>[];
+
+  /// Viewers connected or joining, each holds a slot until it's closed.
+  int _slots = 0;
   bool _intentionalDisconnect = false;
 
+  List<Viewer> get viewers => List.unmodifiable(_viewers);
+
+  InternetAddress? get remoteAddress =>
+      _viewers.isEmpty ? null : _viewers.first.address;
+
+  int get viewerCount => _viewers.length;
+
   Future<void> connect(InternetAddress address, int port) async {
     _server = await HttpServer.bind(address, port);
 
@@ -38,18 +94,44 @@ class Server {
           return;
         }
 
-        remoteAddress = request.connectionInfo?.remoteAddress;
-        _socket = await WebSocketTransformer.upgrade(request);
+        if (request.uri.path == '/resume') {
+          return _resume(request, request.uri.queryParameters['session']);
+        }
+
+        // The server stays bound while viewers are connected, so more can
+        // join up to the limit. The slot is taken before the first await so
+        // concurrent joins can't overshoot it.
+        if (_slots >= Preferences.getMaxViewers()) {
+          request.response.statusCode = HttpStatus.conflict;
+          await request.response.close();
+          return;
+        }
+        if (_slots++ == 0) {
+          onConnected?.call(); // signal first client connected.
+        }
 
+        final layer = VideoLayer.parse(request.uri.queryParameters['layer']);
+        final viewer = Viewer._(
+          _newSessionId(),
+          createSignaling(media, layer),
+          request.connectionInfo?.remoteAddress,
+        );
+        viewer._onSoftError = onSoftError;
         try {
-          await _handleWebSocket(_socket!);
+          viewer._socket = await WebSocketTransformer.upgrade(request);
         } catch (e) {
-          // socket might not have been closed
-          return onError?.call(e.toString());
+          onSoftError?.call(e.toString());
+          _slots--;
+          return _onSlotReleased();
         }
+        _viewers.add(viewer);
 
-        onConnected?.call(); // signal client connected.
-        await _server?.close(force: true); // serve only one client.
+        try {
+          await _handleWebSocket(viewer);
+        } catch (e) {
+          onError?.call(e.toString());
+          await _onSessionClosed(viewer); // socket might not have been closed
+        }
       },
       cancelOnError: true,
       onError: (e) => onError?.call(e.toString()),
@@ -60,13 +142,56 @@ class Server {
 
   Future<void> disconnect() async {
     _intentionalDisconnect = true;
-    await _socket?.close();
+    for (final viewer in List.of(_viewers)) {
+      await _closeViewer(viewer);
+    }
     await _server?.close(force: true);
   }
 
-  Future<void> _handleWebSocket(WebSocket webSocket) async {
+  /// Sends [message] to every viewer but [except].
+  void sendMessage(Map<String, dynamic> message, {Viewer? except}) {
+    for (final viewer in _viewers) {
+      if (viewer != except) viewer.send(message);
+    }
+  }
+
+  Future<void> _handleWebSocket(Viewer viewer) async {
+    final signaling = viewer.signaling
+      ..onError = onError
+      ..onClose = (() => _onSessionClosed(viewer))
+      ..onMessageSend = viewer.send;
+
+    viewer.send({'type': 'session', 'id': viewer.id});
     await signaling.setupPeerConnection();
+    _listen(viewer, viewer._socket!);
+    await signaling.addLocalStream();
+    await signaling.createOffer(); // send offer
+  }
+
+  Future<void> _resume(HttpRequest request, String? sessionId) async {
+    final viewer = sessionId == null
+        ? null
+        : _viewers.where((viewer) => _sameId(viewer.id, sessionId)).firstOrNull;
+    if (viewer == null || !viewer.signaling.canResume) {
+      request.response.statusCode = HttpStatus.conflict;
+      await request.response.close();
+      return;
+    }
+
+    // The old socket may not have noticed the drop yet (half-open). It's
+    // replaced, and its onDone then finds it isn't the viewer's anymore.
+    final stale = viewer._socket;
+    final socket = viewer._socket = await WebSocketTransformer.upgrade(request);
+    try {
+      await stale?.close();
+    } catch (e) {
+      onSoftError?.call(e.toString());
+    }
+    _listen(viewer, socket);
+    await viewer.signaling.attachSignaling();
+  }
 
+  void _listen(Viewer viewer, WebSocket webSocket) {
     webSocket.listen(
       (data) {
         Map<String, dynamic> message;
@@ -77,13 +202,13 @@ class Server {
         }
 
         if (!message.containsKey("type")) {
-          return onReceivedMessage?.call(message);
+          return onReceivedMessage?.call(message, viewer);
         }
 
         // Handle possible remote peer invalid value that may cause type casting error.
         bool status = false; // false -> unknown remote peer signaling message.
         try {
-          status = signaling.handleSignalingMessage(message);
+          status = viewer.signaling.handleSignalingMessage(message);
         } catch (e) {
           return onSoftError?.call(e.toString());
         }
@@ -93,33 +218,72 @@ class Server {
         }
       },
       onDone: () async {
+        if (viewer._socket != webSocket) return; // replaced by a resumed one.
+        viewer._socket = null;
+
+        // The client may come back within the grace period.
+        if (!_intentionalDisconnect && viewer.signaling.canResume) {
+          return viewer.signaling.detachSignaling();
+        }
+
         try {
-          await _socket?.close(); // socket might be open.
-          await signaling.close(); // close peer connection.
+          await webSocket.close(); // socket might be open.
         } catch (e) {
           onSoftError?.call(e.toString());
         }
-        _onClose();
+        await _onSessionClosed(viewer);
       },
       cancelOnError: true,
       onError: (e) => onError?.call(e.toString()),
     );
+  }
 
-    await signaling.addLocalStream();
-    await signaling.createOffer(); // send offer
+  /// The viewer left, or didn't come back within the grace period.
+  Future<void> _onSessionClosed(Viewer viewer) async {
+    if (!_viewers.contains(viewer)) return;
+    await _closeViewer(viewer);
   }
 
-  void _onClose() {
-    if (!_intentionalDisconnect) {
+  /// Called once a slot was given back, the last one disconnects.
+  void _onSlotReleased() {
+    if (_slots == 0 && !_intentionalDisconnect) {
       onDisconnected?.call();
     }
   }
 
-  void sendMessage(Map<String, dynamic> message) {
+  Future<void> _closeViewer(Viewer viewer) async {
+    if (!_viewers.remove(viewer)) return;
+    _slots--;
+    final socket = viewer._socket;
+    viewer._socket = null;
     try {
-      _socket?.add(json.encode(message));
+      await socket?.close();
+      await viewer.signaling.close(); // close peer connection.
     } catch (e) {
       onSoftError?.call(e.toString());
     }
+    _onSlotReleased();
+  }
+
+  String _newSessionId() =>
+      List.generate(16, (_) => _random.nextInt(256).toRadixString(16))
+          .map((byte) => byte.padLeft(2, '0'))
+          .join();
+
+  /// Compares in time independent of where the ids differ.
+  static bool _sameId(String a, String b) {
+    if (a.length != b.length) return false;
+    var difference = 0;
+    for (var i = 0; i < a.length; i++) {
+      difference |= a.codeUnitAt(i) ^ b.codeUnitAt(i);
+    }
+    return difference == 0;
+  }
+
+  Future<void> dispose() async {
+    for (final viewer in List.of(_viewers)) {
+      await viewer.signaling.dispose();
+    }
+    await media.dispose();
   }
 }
@@ -10,7 +10,7 @@ class SettingsManager {
   static void Function(int)? onPortChanged;
 
   static MediaStream? get localStream =>
-      ConnectionManager.signaling.localStream;
+      ConnectionManager.media.localStream;
 
   static void init() {
     ConnectionManager.localStream.listen((stream) async {
@@ -126,13 +126,13 @@ class SettingsManager {
 
   static Future<void> setCameraId(int cameraId) async {
     await Preferences.setCameraId(cameraId);
-    await ConnectionManager.signaling.updateConstrains();
+    await ConnectionManager.media.updateConstrains();
     RequestHandler.sendUpdate(RequestName.cameraId, cameraId);
   }
 
   static Future<void> setFps(int framerate) async {
     await Preferences.setFps(framerate);
-    await ConnectionManager.signaling.updateConstrains();
+    await ConnectionManager.media.updateConstrains();
     RequestHandler.sendUpdate(RequestName.framerate, framerate);
   }
 
@@ -143,7 +143,7 @@ class SettingsManager {
 
   static Future<void> setResolution(String resolution) async {
     await Preferences.setResolution(resolution);
-    await ConnectionManager.signaling.updateConstrains();
+    await ConnectionManager.media.updateConstrains();
     RequestHandler.sendUpdate(RequestName.resolution, resolution);
   }
 
@@ -157,10 +157,10 @@ class SettingsManager {
   static Future<bool> setMicEnabled(bool value) async {
     try {
       await Preferences.setMicEnabled(value);
-      await ConnectionManager.signaling.updateConstrains();
+      await ConnectionManager.media.updateConstrains();
     } catch (_) {
       await Preferences.setMicEnabled(false);
-      ConnectionManager.signaling.updateConstrains();
+      ConnectionManager.media.updateConstrains();
       return false;
     }
     return true; // success
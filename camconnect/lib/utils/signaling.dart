@@ -1,76 +1,76 @@
 import 'package:flutter_webrtc/flutter_webrtc.dart';
 
+import 'bitrate_controller.dart';
+import 'local_media.dart';
 import 'preferences.dart';
+import 'session_resumer.dart';
 
+/// The resolution a viewer asks for. Every layer is scaled from the one
+/// shared capture, so a viewer's choice doesn't restart the camera.
+enum VideoLayer {
+  full(1),
+  half(2),
+  quarter(4);
+
+  const VideoLayer(this.scale);
+
+  final double scale;
+
+  static VideoLayer parse(String? name) =>
+      values.firstWhere((layer) => layer.name == name, orElse: () => full);
+}
+
+/// The peer connection to one viewer, sending the shared [LocalMedia].
 class Signaling {
-  MediaStream? _localStream;
+  Signaling(this._media, {this.layer = VideoLayer.full});
+
+  final LocalMedia _media;
+  final VideoLayer layer;
+
   RTCPeerConnection? _peerConnection;
+  SenderBitrateController? _bitrateController;
+
+  /// Bumped by every start and [close], a start that awaited across another
+  /// one drops its sender.
+  int _bitrateGeneration = 0;
 
   void Function()? onClose;
   void Function(String)? onError;
   void Function(Map<String, dynamic>)? onMessageSend;
 
-  void Function(String)? onPermissionError;
-  void Function(MediaStream)? onLocalStream;
+  void Function()? onInterrupted;
+  void Function(Duration)? onResumed;
 
-  bool get isConnected =>
-      _peerConnection?.connectionState ==
-      RTCPeerConnectionState.RTCPeerConnectionStateConnected;
-
-  MediaStream? get localStream => _localStream;
-
-  Future<MediaStream?> getLocalStream() async {
-    if (_localStream != null) return _localStream;
-
-    try {
-      await _initLocalStream();
-      onPermissionError?.call("");
-    } catch (e) {
-      onPermissionError?.call(
-        "Permission Denied. Cannot access "
-        "${Preferences.getMicEnabled() ? 'camera/microphone' : 'camera'}"
-        " without permission, Please grant permission.",
-      );
-    }
-    return _localStream;
-  }
+  late final _resumer = SessionResumer(onExpired: () => onClose?.call());
+  bool _signalingAttached = true;
 
-  Future<void> updateConstrains() async {
-    if (_localStream == null) return;
+  /// Whether a dropped connection is given a grace period to come back.
+  bool get canResume =>
+      _peerConnection != null &&
+      Preferences.getResumeGracePeriod() > Duration.zero;
 
-    _localStream!.getTracks().forEach((track) {
-      track.stop();
-    });
+  bool get isInterrupted => _resumer.isInterrupted;
 
-    await _initLocalStream();
-    onLocalStream?.call(_localStream!);
+  bool get isConnected =>
+      _peerConnection?.connectionState ==
+      RTCPeerConnectionState.RTCPeerConnectionStateConnected;
 
+  /// Sends the tracks of [stream], recaptured with new constraints.
+  Future<void> replaceTracks(MediaStream stream) async {
     final senders = await _peerConnection?.getSenders();
     if (senders == null) return;
 
     // replace sending stream tracks
-    _localStream!.getTracks().forEach((track) {
+    stream.getTracks().forEach((track) {
       for (final sender in senders) {
         if (sender.track?.kind == track.kind) {
           sender.replaceTrack(track);
         }
       }
     });
-  }
 
-  Future<void> _initLocalStream() async {
-    final dimensions =
-        Preferences.getResolution().split('x').map((res) => int.parse(res));
-    // Initialize the local camera stream
-    _localStream = await navigator.mediaDevices.getUserMedia({
-      'audio': Preferences.getMicEnabled(),
-      'video': {
-        'deviceId': Preferences.getCameraId().toString(),
-        'width': dimensions.first,
-        'height': dimensions.last,
-        'frameRate': Preferences.getFps().toDouble(),
-      },
-    });
+    // The profile depends on the configured resolution and fps.
+    if (isConnected) await _startBitrateController();
   }
 
   Future<void> setupPeerConnection() async {
@@ -87,21 +87,98 @@ class Signaling {
       });
     };
 
+    _peerConnection!.onConnectionState = (state) {
+      if (state == RTCPeerConnectionState.RTCPeerConnectionStateConnected) {
+        _startBitrateController();
+      }
+    };
+
     _peerConnection!.onIceConnectionState = (connectionState) {
       switch (connectionState) {
         case RTCIceConnectionState.RTCIceConnectionStateDisconnected:
-          onClose?.call();
-          break;
         case RTCIceConnectionState.RTCIceConnectionStateFailed:
-          onError?.call("WebRTC connection failed.");
+          if (!canResume) {
+            return connectionState ==
+                    RTCIceConnectionState.RTCIceConnectionStateFailed
+                ? onError?.call("WebRTC connection failed.")
+                : onClose?.call();
+          }
+          _interrupt();
+          if (_signalingAttached) restartIce();
+          break;
+        case RTCIceConnectionState.RTCIceConnectionStateConnected:
+        case RTCIceConnectionState.RTCIceConnectionStateCompleted:
+          if (_signalingAttached) _resume();
           break;
         default:
       }
     };
   }
 
+  /// Keeps the session through the grace period while the signaling socket
+  /// is gone, the remote peer may come back with [attachSignaling].
+  void detachSignaling() {
+    _signalingAttached = false;
+    _interrupt();
+  }
+
+  /// Resumes an interrupted session over a new signaling socket.
+  Future<void> attachSignaling() async {
+    _signalingAttached = true;
+    if (isConnected) return _resume();
+    await restartIce();
+  }
+
+  /// Offers new ICE credentials, so the connection is re-established over
+  /// whatever path works now without renegotiating the media.
+  Future<void> restartIce() async {
+    try {
+      final desc = await _peerConnection!.createOffer(_iceRestartConstraints);
+      await _peerConnection!.setLocalDescription(desc);
+      onMessageSend?.call({'type': 'offer', 'sdp': desc.sdp});
+    } catch (_) {
+      // Retried on the next drop or resumed socket, the grace period ends
+      // the session if none comes.
+    }
+  }
+
+  void _interrupt() {
+    if (!isInterrupted) onInterrupted?.call();
+    _resumer.interrupt(Preferences.getResumeGracePeriod());
+  }
+
+  void _resume() {
+    final interruption = _resumer.resume();
+    if (interruption != null) onResumed?.call(interruption);
+  }
+
+  /// Adapts the video sender's encoding to the link until [close].
+  Future<void> _startBitrateController() async {
+    _bitrateController?.stop();
+    _bitrateController = null;
+    final generation = ++_bitrateGeneration;
+
+    final senders = await _peerConnection?.getSenders();
+    if (generation != _bitrateGeneration || _peerConnection == null) return;
+    final sender = senders?.where((s) => s.track?.kind == 'video').firstOrNull;
+    if (sender == null) return;
+
+    final dimensions =
+        Preferences.getResolution().split('x').map((res) => int.parse(res));
+    _bitrateController = SenderBitrateController(
+      sender,
+      BitrateController(
+        profile: BitrateProfile.of(Preferences.getBitrateMode()),
+        width: dimensions.first ~/ layer.scale,
+        height: dimensions.last ~/ layer.scale,
+        fps: Preferences.getFps(),
+      ),
+      layerScale: layer.scale,
+    )..start();
+  }
+
   Future<void> addLocalStream() async {
-    final stream = await getLocalStream();
+    final stream = await _media.getLocalStream();
     if (stream == null) return;
 
     // sdpSemantics: 'plan-b'
@@ -113,12 +190,8 @@ class Signaling {
     // });
   }
 
-  Future<void> updateLocalStream() async {
-    final stream = await getLocalStream();
-    if (stream == null) return;
-
-    onLocalStream?.call(stream);
-
+  /// Sends [stream] if this connection isn't sending any.
+  Future<void> addStreamIfMissing(MediaStream stream) async {
     if ((await _peerConnection?.getSenders())?.isEmpty ?? false) {
       // restart peer connection, if not sending any streams.
       await close();
@@ -136,6 +209,15 @@ class Signaling {
     'optional': [],
   };
 
+  static const _iceRestartConstraints = <String, dynamic>{
+    'mandatory': {
+      'OfferToReceiveAudio': true,
+      'OfferToReceiveVideo': true,
+      'IceRestart': true,
+    },
+    'optional': [],
+  };
+
   Future<void> createOffer() async {
     final desc = await _peerConnection!.createOffer(_mediaConstraints);
     await _peerConnection!.setLocalDescription(desc);
@@ -181,12 +263,19 @@ class Signaling {
   }
 
   Future<void> close() async {
+    _resumer.cancel();
+    _signalingAttached = true;
+    _bitrateGeneration++;
+    _bitrateController?.stop();
+    _bitrateController = null;
     await _peerConnection?.close();
     _peerConnection = null;
   }
 
   Future<void> dispose() async {
-    await _localStream?.dispose();
+    _resumer.cancel();
+    _bitrateGeneration++;
+    _bitrateController?.stop();
     await _peerConnection?.close();
     await _peerConnection?.dispose();
   }
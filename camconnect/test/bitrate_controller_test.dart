@@ -0,0 +1,120 @@
+import 'dart:math';
+
+import 'package:camconnect/utils/bitrate_controller.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+void main() {
+  group("latency-first", () => _testProfile(BitrateProfile.latencyFirst));
+  group("quality-first", () => _testProfile(BitrateProfile.qualityFirst));
+
+  test("latency-first keeps the frame rate", () {
+    final link = ShapedLink(BitrateController(
+      profile: BitrateProfile.latencyFirst,
+      width: 1280,
+      height: 720,
+      fps: 30,
+    ));
+    link.run(capacity: 800000, seconds: 20);
+    expect(link.controller.target.maxFramerate, 30);
+    expect(link.controller.target.scaleResolutionDownBy, greaterThan(1));
+  });
+
+  test("quality-first keeps the resolution", () {
+    final link = ShapedLink(BitrateController(
+      profile: BitrateProfile.qualityFirst,
+      width: 1280,
+      height: 720,
+      fps: 30,
+    ));
+    link.run(capacity: 1600000, seconds: 20);
+    expect(link.controller.target.scaleResolutionDownBy, 1);
+    expect(link.controller.target.maxFramerate, lessThan(30));
+  });
+}
+
+void _testProfile(BitrateProfile profile) {
+  BitrateController controller() => BitrateController(
+        profile: profile,
+        width: 1280,
+        height: 720,
+        fps: 30,
+      );
+
+  test("clear link stays at full quality", () {
+    final link = ShapedLink(controller());
+    link.run(capacity: 20000000, seconds: 30);
+    expect(link.controller.rung, 0);
+    expect(link.rungChanges, 0);
+  });
+
+  test("congested link degrades within seconds", () {
+    final link = ShapedLink(controller());
+    link.run(capacity: 20000000, seconds: 5);
+    final seconds = link.run(
+      capacity: 600000,
+      seconds: 30,
+      until: (link) => link.loss == 0 && link.sending <= 600000,
+    );
+    expect(seconds, lessThan(5));
+    link.run(capacity: 600000, seconds: 15);
+    expect(link.controller.rung, greaterThan(0));
+    expect(link.loss, 0);
+  });
+
+  test("recovered link returns to full quality", () {
+    final link = ShapedLink(controller());
+    link.run(capacity: 400000, seconds: 30);
+    expect(link.controller.rung, greaterThan(0));
+    link.run(capacity: 20000000, seconds: 60);
+    expect(link.controller.rung, 0);
+  });
+
+  test("link at a rung's edge doesn't flap", () {
+    final link = ShapedLink(controller());
+    link.run(capacity: 20000000, seconds: 5);
+    // Wobbles 10% either side of what the first rung needs.
+    final need = 1280 * 720 * 30 * 0.08 / 0.85;
+    for (var i = 0; i < 60; i++) {
+      link.run(capacity: need * (i.isEven ? 1.1 : 0.9), seconds: 1);
+    }
+    expect(link.rungChanges, lessThanOrEqualTo(2));
+  });
+}
+
+/// A bottleneck of a given capacity in front of the receiver. Sending over
+/// it queues, raising the round trip time, and the overflow is lost.
+class ShapedLink {
+  ShapedLink(this.controller) : sending = controller.target.maxBitrate;
+
+  final BitrateController controller;
+  int sending;
+  double loss = 0;
+  double queue = 0; // Seconds of queued data.
+  int rungChanges = 0;
+
+  /// Feeds one sample per second for [seconds], or until [until] holds.
+  /// Returns the seconds it ran.
+  int run({
+    required double capacity,
+    required int seconds,
+    bool Function(ShapedLink)? until,
+  }) {
+    for (var second = 1; second <= seconds; second++) {
+      final overflow = sending - capacity;
+      queue = overflow > 0 ? min(queue + overflow / capacity, 0.5) : 0.0;
+      loss = overflow > 0 && queue >= 0.5 ? overflow / sending : 0.0;
+
+      final rung = controller.rung;
+      final target = controller.onSample(LinkSample(
+        availableBitrate: capacity,
+        rtt: 0.02 + queue,
+        loss: loss,
+      ));
+      if (controller.rung != rung) rungChanges++;
+      if (target != null) sending = target.maxBitrate;
+
+      if (until != null && until(this)) return second;
+    }
+    return seconds;
+  }
+}
@@ -0,0 +1,153 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:camconnect/utils/discovery_packet.dart';
+import 'package:camconnect/utils/discovery_responder.dart';
+import 'package:camconnect/utils/mdns.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+void main() {
+  group("Packets", _testPackets);
+  group("Time To Discovery", _testTimeToDiscovery);
+}
+
+final _answer = DiscoveryAnswer(
+  address: InternetAddress('192.168.1.20'),
+  port: 8080,
+  nonce: 0xCAFE1234,
+  capabilities: DiscoveryCapability.audio | DiscoveryCapability.resume,
+  name: "Pixel 7 (camconnect)",
+);
+
+void _testPackets() {
+  test("query round trip", () {
+    expect(DiscoveryPacket.parseQuery(DiscoveryPacket.query(42)), 42);
+    expect(DiscoveryPacket.parseAnswer(DiscoveryPacket.query(42)), isNull);
+  });
+
+  test("answer round trip", () {
+    final answer =
+        DiscoveryPacket.parseAnswer(DiscoveryPacket.answer(_answer))!;
+    expect(answer.address, _answer.address);
+    expect(answer.port, _answer.port);
+    expect(answer.nonce, _answer.nonce);
+    expect(answer.capabilities, _answer.capabilities);
+    expect(answer.name, _answer.name);
+  });
+
+  test("answer from a later version with appended fields", () {
+    final packet = DiscoveryPacket.answer(_answer);
+    packet[4] = DiscoveryPacket.version + 1;
+    final extended = Uint8List.fromList([...packet, 1, 2, 3]);
+    expect(DiscoveryPacket.parseAnswer(extended)?.name, _answer.name);
+  });
+
+  test("foreign and truncated packets", () {
+    expect(DiscoveryPacket.parseQuery(Uint8List.fromList(
+        "camconnect broadcast".codeUnits)), isNull);
+    final packet = DiscoveryPacket.answer(_answer);
+    expect(DiscoveryPacket.parseAnswer(packet.sublist(0, packet.length - 1)),
+        isNull);
+  });
+
+  test("mDNS query and response", () {
+    expect(Mdns.parseQuery(Mdns.query(7)), 7);
+    expect(Mdns.parseQuery(Mdns.response(_answer)), isNull);
+
+    final source = InternetAddress('10.0.0.1');
+    final answer =
+        Mdns.parseResponse(Mdns.response(_answer, legacyId: 7), source)!;
+    expect(answer.address, _answer.address);
+    expect(answer.port, _answer.port);
+    expect(answer.capabilities, _answer.capabilities);
+    expect(answer.name, _answer.name);
+    expect(Mdns.parseResponse(Mdns.query(7), source), isNull);
+  });
+}
+
+void _testTimeToDiscovery() {
+  final port = 40000 + Random().nextInt(20000);
+
+  tearDown(DiscoveryResponder.stop);
+
+  test("loopback", () async {
+    await DiscoveryResponder.start(InternetAddress.loopbackIPv4, port,
+        name: "loopback");
+    final time = await _timeToAnswer(
+      DiscoveryPacket.query(1),
+      InternetAddress.loopbackIPv4,
+      port,
+      (packet) => DiscoveryPacket.parseAnswer(packet)?.nonce == 1,
+    );
+    expect(time, lessThan(const Duration(milliseconds: 100)));
+  });
+
+  test("loopback mDNS", () async {
+    await DiscoveryResponder.start(InternetAddress.loopbackIPv4, port,
+        name: "loopback", mdns: true, mdnsPort: port + 1);
+    final time = await _timeToAnswer(
+      Mdns.query(1),
+      InternetAddress.loopbackIPv4,
+      port + 1,
+      (packet) =>
+          Mdns.parseResponse(packet, InternetAddress.loopbackIPv4)?.port ==
+          port,
+    );
+    expect(time, lessThan(const Duration(milliseconds: 100)));
+  });
+
+  test("multicast", () async {
+    // Loopback doesn't carry multicast on most systems, use a LAN address
+    // and send the query out of that same interface.
+    final interfaces =
+        await NetworkInterface.list(type: InternetAddressType.IPv4);
+    final address = interfaces
+        .expand((interface) => interface.addresses)
+        .where((address) => !address.isLoopback && !address.isLinkLocal)
+        .firstOrNull;
+    if (address == null) {
+      return markTestSkipped("No interface to join the group on.");
+    }
+
+    await DiscoveryResponder.start(address, port, name: "multicast");
+    final time = await _timeToAnswer(
+      DiscoveryPacket.query(2),
+      DiscoveryPacket.group,
+      port,
+      (packet) => DiscoveryPacket.parseAnswer(packet)?.nonce == 2,
+      interface: address,
+    );
+    expect(time, lessThan(const Duration(milliseconds: 100)));
+  });
+}
+
+/// Sends [query] once and times the first reply [isAnswer] accepts.
+///
+/// Multicast queries leave through the interface of [interface] if given.
+Future<Duration> _timeToAnswer(Uint8List query, InternetAddress address,
+    int port, bool Function(Uint8List) isAnswer,
+    {InternetAddress? interface}) async {
+  final socket = await RawDatagramSocket.bind(InternetAddress.anyIPv4, 0);
+  if (interface != null) {
+    socket.setRawOption(RawSocketOption(RawSocketOption.levelIPv4,
+        RawSocketOption.IPv4MulticastInterface, interface.rawAddress));
+  }
+  final answered = Completer<void>();
+  socket.listen((event) {
+    final datagram = socket.receive();
+    if (datagram != null && isAnswer(datagram.data) && !answered.isCompleted) {
+      answered.complete();
+    }
+  });
+
+  final stopwatch = Stopwatch()..start();
+  socket.send(query, address, port);
+  try {
+    await answered.future.timeout(const Duration(seconds: 1));
+  } finally {
+    socket.close();
+  }
+  return stopwatch.elapsed;
+}
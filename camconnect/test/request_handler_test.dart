@@ -6,6 +6,8 @@ import 'package:flutter/material.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:shared_preferences/shared_preferences.dart';
 
+import 'test_utils.dart';
+
 void main() async {
   WidgetsFlutterBinding.ensureInitialized();
   SharedPreferences.setMockInitialValues({});
@@ -13,6 +15,7 @@ void main() async {
 
   group("Get Requests", _testGetRequests);
   group("Set Requests", _testSetRequests);
+  group("Snapshots and Deltas", _testSnapshotsAndDeltas);
 
   test("invalid-get-request", () {
     const request = {
@@ -214,6 +217,145 @@ void _testSetRequests() {
   });
 }
 
+void _testSnapshotsAndDeltas() {
+  final deltas = <Map<String, dynamic>>[];
+
+  setUp(() async {
+    // Let updates of earlier tests flush first.
+    await Future.delayed(const Duration(milliseconds: 100));
+    deltas.clear();
+    RequestHandler.onSendUpdate = (update) => deltas.add(update['delta']);
+  });
+
+  test("snapshot-request: every setting in one response", () async {
+    final responses = <Map<String, dynamic>>[];
+    final stopwatch = Stopwatch()..start();
+
+    RequestHandler.handleRequest(
+        {'snapshot-request': RequestHandler.protocolVersion}, responses.add);
+    await waitUntil(() => responses.isNotEmpty);
+
+    // One response instead of a round trip per setting, and no deltas.
+    expect(stopwatch.elapsed, lessThan(_latencyBound));
+    await Future.delayed(const Duration(milliseconds: 50));
+    expect(responses, hasLength(1));
+    expect(deltas, isEmpty);
+
+    final snapshot = responses.single['snapshot-response'];
+    expect(snapshot['version'], RequestHandler.protocolVersion);
+    expect(snapshot['seq'], isA<int>());
+    expect(<dynamic>{...snapshot['settings'].keys, ...snapshot['errors'].keys},
+        containsAll(_settingNames));
+    expect(snapshot['settings'][RequestName.framerate], Preferences.getFps());
+    expect(snapshot['settings'][RequestName.resolution],
+        Preferences.getResolution());
+  });
+
+  test("updates are coalesced into numbered deltas", () async {
+    final stopwatch = Stopwatch()..start();
+
+    RequestHandler.sendUpdate(RequestName.torch, true);
+    RequestHandler.sendUpdate(RequestName.microphone, true);
+    RequestHandler.sendUpdate(RequestName.torch, false);
+    await waitUntil(() => deltas.isNotEmpty);
+
+    // Three updates, one message, flushed promptly.
+    expect(stopwatch.elapsed, lessThan(_latencyBound));
+    await Future.delayed(const Duration(milliseconds: 50));
+    expect(deltas, hasLength(1));
+    expect(deltas.single['settings'],
+        {RequestName.torch: false, RequestName.microphone: true});
+
+    RequestHandler.sendUpdate(RequestName.framerate, Preferences.getFps());
+    await waitUntil(() => deltas.length == 2);
+    expect(deltas.last['seq'], deltas.first['seq'] + 1);
+  });
+
+  test("set-request: several settings in one response and delta", () async {
+    final responses = <Map<String, dynamic>>[];
+    final stopwatch = Stopwatch()..start();
+
+    RequestHandler.handleRequest({
+      'set-request': {
+        RequestName.framerate: 30,
+        RequestName.maxFramerate: 30,
+      }
+    }, responses.add);
+    await waitUntil(() => responses.isNotEmpty);
+
+    expect(stopwatch.elapsed, lessThan(_latencyBound));
+    expect(responses.single['set-response'], {
+      RequestName.framerate: {'result': 'success'},
+      RequestName.maxFramerate: {'result': 'success'},
+    });
+
+    await waitUntil(() => deltas.isNotEmpty);
+    await Future.delayed(const Duration(milliseconds: 50));
+    // Two settings, one response and one delta.
+    expect(responses, hasLength(1));
+    expect(deltas.single['settings'],
+        {RequestName.framerate: 30, RequestName.maxFramerate: 30});
+  });
+
+  test("set-request: a failing setting undoes the others", () async {
+    await Preferences.setFps(25);
+    final responses = <Map<String, dynamic>>[];
+
+    // The microphone fails without a local stream.
+    RequestHandler.handleRequest({
+      'set-request': {
+        RequestName.framerate: 30,
+        RequestName.microphone: true,
+      }
+    }, responses.add);
+    await waitUntil(() => responses.isNotEmpty);
+
+    final response = responses.single['set-response'];
+    expect(response[RequestName.microphone]['result'], 'failure');
+    expect(response[RequestName.framerate],
+        {'result': 'failure', 'error': 'aborted: microphone failed'});
+    expect(Preferences.getFps(), 25);
+
+    await waitUntil(() => deltas.isNotEmpty);
+    expect(deltas.single['settings'], {RequestName.framerate: 25});
+  });
+
+  test("set-request: an invalid setting applies none", () async {
+    final resolution = Preferences.getResolution();
+    final responses = <Map<String, dynamic>>[];
+
+    RequestHandler.handleRequest({
+      'set-request': {
+        RequestName.framerate: 'fast',
+        RequestName.resolution: '640x480',
+      }
+    }, responses.add);
+    await waitUntil(() => responses.length == 2);
+
+    expect(responses.first['set-response'][RequestName.framerate]['result'],
+        'failure');
+    expect(responses.last['set-response'][RequestName.resolution],
+        {'result': 'failure', 'error': 'aborted: framerate failed'});
+    expect(Preferences.getResolution(), resolution);
+  });
+}
+
+/// Far above what one request takes, so loaded machines don't flake, but
+/// still short of waitUntil's deadline to catch a stalled response.
+const _latencyBound = Duration(seconds: 1);
+
+const _settingNames = [
+  RequestName.cameras,
+  RequestName.cameraId,
+  RequestName.microphone,
+  RequestName.torch,
+  RequestName.hasTorch,
+  RequestName.framerate,
+  RequestName.maxFramerate,
+  RequestName.resolution,
+  RequestName.resolutionPresets,
+];
+
 class TestRequest {
   final String name;
   final dynamic result;
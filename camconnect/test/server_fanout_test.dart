@@ -0,0 +1,253 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:camconnect/utils/local_media.dart';
+import 'package:camconnect/utils/preferences.dart';
+import 'package:camconnect/utils/server.dart';
+import 'package:camconnect/utils/signaling.dart';
+import 'package:flutter/material.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+import 'test_utils.dart';
+
+/// Signaling without a peer connection, recording what it's sent.
+class _FakeSignaling extends Signaling {
+  _FakeSignaling(super.media, {super.layer});
+
+  final received = <Map<String, dynamic>>[];
+  bool closed = false;
+  bool resumable = false;
+  int attached = 0;
+
+  @override
+  Future<void> setupPeerConnection() async {}
+
+  @override
+  Future<void> addLocalStream() async {}
+
+  @override
+  Future<void> createOffer() async =>
+      onMessageSend?.call({'type': 'offer', 'sdp': layer.name});
+
+  @override
+  bool handleSignalingMessage(Map<String, dynamic> message) {
+    received.add(message);
+    return true;
+  }
+
+  @override
+  bool get canResume => resumable;
+
+  @override
+  Future<void> attachSignaling() async => attached++;
+
+  @override
+  Future<void> close() async {
+    closed = true;
+  }
+}
+
+/// A desktop's signaling socket.
+class _Desktop {
+  _Desktop._(this.socket) {
+    socket.listen((data) {
+      final message = json.decode(data) as Map<String, dynamic>;
+      messages.add(message);
+      _controller.add(message);
+    });
+  }
+
+  static Future<_Desktop> connect(int port, {String layer = 'full'}) async =>
+      _Desktop._(
+          await WebSocket.connect('ws://127.0.0.1:$port/?layer=$layer'));
+
+  static Future<_Desktop> resume(int port, String session) async => _Desktop._(
+      await WebSocket.connect('ws://127.0.0.1:$port/resume?session=$session'));
+
+  final WebSocket socket;
+  final messages = <Map<String, dynamic>>[];
+  final _controller = StreamController<Map<String, dynamic>>.broadcast();
+
+  Future<Map<String, dynamic>> next(bool Function(Map<String, dynamic>) test) {
+    final earlier = messages.where(test);
+    if (earlier.isNotEmpty) return Future.value(earlier.first);
+    return _controller.stream
+        .firstWhere(test)
+        .timeout(const Duration(seconds: 2));
+  }
+
+  Future<void> send(Map<String, dynamic> message) async =>
+      socket.add(json.encode(message));
+}
+
+Future<int> _freePort() async {
+  final socket = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  final port = socket.port;
+  await socket.close();
+  return port;
+}
+
+void main() async {
+  WidgetsFlutterBinding.ensureInitialized();
+  SharedPreferences.setMockInitialValues({});
+  await Preferences.init();
+
+  late Server server;
+  late List<_FakeSignaling> signalings;
+  late int port, connected, disconnected;
+  final desktops = <_Desktop>[];
+
+  setUp(() async {
+    await Preferences.setMaxViewers(4);
+    signalings = [];
+    connected = disconnected = 0;
+    server = Server(createSignaling: (LocalMedia media, VideoLayer layer) {
+      final signaling = _FakeSignaling(media, layer: layer);
+      signalings.add(signaling);
+      return signaling;
+    })
+      ..onConnected = (() => connected++)
+      ..onDisconnected = (() => disconnected++);
+    port = await _freePort();
+    await server.connect(InternetAddress.loopbackIPv4, port);
+  });
+
+  tearDown(() async {
+    for (final desktop in desktops) {
+      await desktop.socket.close();
+    }
+    desktops.clear();
+    await server.disconnect();
+  });
+
+  Future<_Desktop> join({String layer = 'full'}) async {
+    final desktop = await _Desktop.connect(port, layer: layer);
+    desktops.add(desktop);
+    await desktop.next((message) => message['type'] == 'offer');
+    return desktop;
+  }
+
+  test("each viewer gets its own session and layer", () async {
+    const layers = ['full', 'half', 'quarter'];
+    for (final layer in layers) {
+      await join(layer: layer);
+    }
+
+    expect(server.viewerCount, layers.length);
+    expect(connected, 1);
+
+    final ids = <String>{};
+    for (var i = 0; i < layers.length; i++) {
+      final session =
+          await desktops[i].next((message) => message['type'] == 'session');
+      ids.add(session['id']);
+      final offer =
+          await desktops[i].next((message) => message['type'] == 'offer');
+      expect(offer['sdp'], layers[i]);
+      expect(signalings[i].layer, VideoLayer.parse(layers[i]));
+    }
+    expect(ids, hasLength(layers.length));
+  });
+
+  test("signaling and requests are routed per viewer", () async {
+    final requests = <(Map<String, dynamic>, Viewer)>[];
+    server.onReceivedMessage = (request, viewer) {
+      requests.add((request, viewer));
+      viewer.send({'get-response': request['get-request']});
+      server.sendMessage({'set-update': 'others'}, except: viewer);
+    };
+
+    final first = await join();
+    final second = await join();
+    final third = await join();
+
+    await second.send({'type': 'answer', 'sdp': 'second'});
+    await waitUntil(() => signalings[1].received.isNotEmpty);
+    expect(signalings[0].received, isEmpty);
+    expect(signalings[2].received, isEmpty);
+    expect(signalings[1].received.single['sdp'], 'second');
+
+    await first.send({'get-request': 'torch'});
+    final response =
+        await first.next((message) => message.containsKey('get-response'));
+    expect(response['get-response'], 'torch');
+    expect(requests.single.$2, server.viewers.first);
+
+    await second.next((message) => message.containsKey('set-update'));
+    await third.next((message) => message.containsKey('set-update'));
+    expect(second.messages.where((m) => m.containsKey('get-response')),
+        isEmpty);
+    expect(first.messages.where((m) => m.containsKey('set-update')), isEmpty);
+  });
+
+  test("a viewer leaving doesn't end the others' sessions", () async {
+    final first = await join();
+    await join();
+
+    await first.socket.close();
+    desktops.remove(first);
+    await waitUntil(() => server.viewerCount == 1);
+    expect(signalings[0].closed, isTrue);
+    expect(signalings[1].closed, isFalse);
+    expect(disconnected, 0);
+
+    await desktops.single.socket.close();
+    desktops.clear();
+    await waitUntil(() => server.viewerCount == 0);
+    expect(disconnected, 1);
+  });
+
+  test("viewers past the limit are refused", () async {
+    await Preferences.setMaxViewers(2);
+    await join();
+    await join();
+
+    await expectLater(
+        _Desktop.connect(port), throwsA(isA<WebSocketException>()));
+    expect(server.viewerCount, 2);
+
+    // A slot freed by a leaving viewer can be taken again.
+    final leaving = desktops.removeAt(0);
+    await leaving.socket.close();
+    await waitUntil(() => server.viewerCount == 1);
+    await join();
+    expect(server.viewerCount, 2);
+  });
+
+  test("concurrent joins don't overshoot the limit", () async {
+    await Preferences.setMaxViewers(2);
+    final results = await Future.wait(List.generate(
+        4,
+        (_) => _Desktop.connect(port).then<_Desktop?>((desktop) {
+              desktops.add(desktop);
+              return desktop;
+            }, onError: (_) => null)));
+
+    expect(results.whereType<_Desktop>(), hasLength(2));
+    await waitUntil(() => server.viewerCount == 2);
+    expect(connected, 1);
+  });
+
+  test("a resume replaces a socket that hasn't noticed the drop", () async {
+    final first = await join();
+    final session = await first.next((message) => message['type'] == 'session');
+    signalings[0].resumable = true;
+
+    await expectLater(_Desktop.resume(port, 'not-a-session'),
+        throwsA(isA<WebSocketException>()));
+
+    // The first socket is still open, as after a half-open drop.
+    final resumed = await _Desktop.resume(port, session['id']);
+    desktops.add(resumed);
+    await waitUntil(() => signalings[0].attached == 1);
+    await waitUntil(() => first.socket.closeCode != null);
+    expect(signalings[0].closed, isFalse);
+    expect(server.viewerCount, 1);
+    expect(disconnected, 0);
+
+    server.viewers.single.send({'type': 'ping'});
+    await resumed.next((message) => message['type'] == 'ping');
+  });
+}
@@ -0,0 +1,63 @@
+import 'package:camconnect/utils/session_resumer.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+void main() {
+  const grace = Duration(milliseconds: 200);
+
+  test("resuming within the grace period keeps the session", () async {
+    var expired = 0;
+    final resumer = SessionResumer(onExpired: () => expired++);
+
+    resumer.interrupt(grace);
+    expect(resumer.isInterrupted, isTrue);
+    await Future.delayed(const Duration(milliseconds: 50));
+
+    final interruption = resumer.resume();
+    expect(interruption, isNotNull);
+    expect(interruption!,
+        greaterThanOrEqualTo(const Duration(milliseconds: 50)));
+    expect(interruption, lessThan(grace));
+    expect(resumer.isInterrupted, isFalse);
+
+    await Future.delayed(grace * 2);
+    expect(expired, 0);
+  });
+
+  test("grace period running out ends the session once", () async {
+    var expired = 0;
+    final resumer = SessionResumer(onExpired: () => expired++);
+
+    resumer.interrupt(grace);
+    await Future.delayed(grace ~/ 2);
+    resumer.interrupt(grace); // a second drop doesn't extend it.
+    await Future.delayed(grace * 3 ~/ 4);
+
+    expect(expired, 1);
+    expect(resumer.isInterrupted, isFalse);
+    expect(resumer.resume(), isNull);
+  });
+
+  test("zero grace period ends the session at once", () {
+    var expired = 0;
+    final resumer = SessionResumer(onExpired: () => expired++);
+
+    resumer.interrupt(Duration.zero);
+    expect(expired, 1);
+    expect(resumer.isInterrupted, isFalse);
+  });
+
+  test("resume without an interruption reports nothing", () {
+    final resumer = SessionResumer(onExpired: () => fail("expired"));
+    expect(resumer.resume(), isNull);
+  });
+
+  test("cancel ends the grace period without expiring", () async {
+    var expired = 0;
+    final resumer = SessionResumer(onExpired: () => expired++);
+
+    resumer.interrupt(grace);
+    resumer.cancel();
+    await Future.delayed(grace * 2);
+    expect(expired, 0);
+  });
+}
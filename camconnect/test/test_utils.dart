@@ -0,0 +1,10 @@
+import 'package:flutter_test/flutter_test.dart';
+
+/// Polls [condition] until it holds, failing the test after two seconds.
+Future<void> waitUntil(bool Function() condition) async {
+  final deadline = DateTime.now().add(const Duration(seconds: 2));
+  while (!condition()) {
+    if (DateTime.now().isAfter(deadline)) fail("Timed out waiting.");
+    await Future.delayed(const Duration(milliseconds: 5));
+  }
+}
@@ -15,7 +15,13 @@ class FlutterWebRTCPluginImpl : public FlutterWebRTCPlugin {
   static void RegisterWithRegistrar(PluginRegistrar* registrar) {
     auto channel = std::make_unique<MethodChannel>(
         registrar->messenger(), kChannelName,
+#ifdef FLUTTER_WEBRTC_BYTE_LIST_VIEWS
+        // Large binary arguments are read in place, see GetBytes().
+        &flutter::StandardMethodCodec::GetInstance(
+            &flutter::StandardCodecSerializer::GetByteListViewInstance()));
+#else
         &flutter::StandardMethodCodec::GetInstance());
+#endif
 
     auto* channel_pointer = channel.get();
 
@@ -2,21 +2,42 @@
 #define DRIVER_INTERFACE_HANDLER_H
 
 #include "flutter_common.h"
+#include "flutter_webrtc_base.h"
 #include "driver_interface.h"
-#include "driver_interface_video_proc_thread.h"
+#include "driver_interface_video_output.h"
+#include "frame_buffer_pool.h"
 
-inline bool HandleDriverInterfaceMethodCall(const MethodCallProxy& method_call, std::unique_ptr<MethodResultProxy>& result)
+namespace driver_interface {
+
+/**
+ * @brief Route the errors and stats of an output to the event channel.
+ */
+inline void ConfigureOutputEvents(VideoOutput& output);
+
+}  // namespace driver_interface
+
+inline bool HandleDriverInterfaceMethodCall(const MethodCallProxy& method_call,
+                                            std::unique_ptr<MethodResultProxy>& result,
+                                            flutter_webrtc_plugin::FlutterWebRTCBase* base)
 {
-  const flutter::EncodableValue* arguments = method_call.arguments();
-  if (!arguments) {
-    result->Error("Bad Arguments", "Null arguments received");
-    return false;
-  }
+  using driver_interface::VideoOutput;
+  using Handler = void (*)(const EncodableMap* params, MethodResultProxy* result,
+                           flutter_webrtc_plugin::FlutterWebRTCBase* base);
 
-  const flutter::EncodableMap* params = std::get_if<EncodableMap>(arguments);
+  // Resolves the "output" argument, defaulting to the default output.
+  // Reports an error and returns nullptr for unknown handles.
+  static const auto findOutput = [](const EncodableMap* params, MethodResultProxy* result,
+                                    const std::string& method) -> std::shared_ptr<VideoOutput> {
+    const int handle = params != nullptr ? findInt(*params, "output") : -1;
+    std::shared_ptr<VideoOutput> output = VideoOutput::Get(handle < 0 ? VideoOutput::kDefaultHandle : handle);
+    if (output == nullptr) {
+      result->Error("Invalid Argument", method + " unknown output " + std::to_string(handle) + ".");
+    }
+    return output;
+  };
 
-  static const std::unordered_map<std::string, std::function<void()>> methodHandlers = {
-    {"DriverInterface::GetDevices", [&] {
+  static const std::unordered_map<std::string, Handler> methodHandlers = {
+    {"DriverInterface::GetDevices", [](const EncodableMap*, MethodResultProxy* result, auto) {
       EncodableList deviceInfoList;
 
       for (const DeviceInfo deviceInfo: DriverInterface::GetDevices()) {
@@ -28,20 +49,38 @@ inline bool HandleDriverInterfaceMethodCall(const MethodCallProxy& method_call,
 
       result->Success(EncodableValue(deviceInfoList));
     }},
-    {"DriverInterface::SetDevice", [&] {
+    {"DriverInterface::CreateOutput", [](const EncodableMap*, MethodResultProxy* result, auto) {
+      const int handle = VideoOutput::Create();
+      driver_interface::ConfigureOutputEvents(*VideoOutput::Get(handle));
+      result->Success(EncodableValue(handle));
+    }},
+    {"DriverInterface::ReleaseOutput", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      const int handle = params != nullptr ? findInt(*params, "output") : -1;
+      if (!VideoOutput::Release(handle < 0 ? VideoOutput::kDefaultHandle : handle)) {
+        return result->Error("Invalid Argument",
+          "DriverInterface::ReleaseOutput unknown output " + std::to_string(handle) + ".");
+      }
+      result->Success();
+    }},
+    {"DriverInterface::SetDevice", [](const EncodableMap* params, MethodResultProxy* result, auto) {
         if (params == nullptr) {
           return result->Error("Missing Arguments",
             "DriverInterface::SetDevice requires an argument named 'devicePath'."
           );
         }
 
-        const std::string devicePath = findString(*params, "devicePath");
+        const std::string& devicePath = findStringRef(*params, "devicePath");
         if (devicePath.empty()) {
           return result->Error("Invalid Argument",
             "DriverInterface::SetDevice argument 'devicePath' cannot be empty.");
         }
 
-        const int status = DriverInterface::SetDevice(devicePath);
+        std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::SetDevice");
+        if (output == nullptr) {
+          return;
+        }
+
+        const int status = output->SetDevice(devicePath);
 
         switch (status) {
           case 0:
@@ -57,26 +96,113 @@ inline bool HandleDriverInterfaceMethodCall(const MethodCallProxy& method_call,
             break;
         }
     }},
-    {"DriverInterface::DestroyDevice", [&] {
-      DriverInterface::DestroyDevice();
-      result->Success();
+    {"DriverInterface::DestroyDevice", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      if (std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::DestroyDevice")) {
+        output->DestroyDevice();
+        result->Success();
+      }
     }},
-    {"DriverInterface::StartVideoProcessing", [&] {
-      driver_interface::VideoProcessingThread::Start();
+    {"DriverInterface::SetVideoTrack", [](const EncodableMap* params, MethodResultProxy* result,
+                                          flutter_webrtc_plugin::FlutterWebRTCBase* base) {
+      std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::SetVideoTrack");
+      if (output == nullptr) {
+        return;
+      }
+
+      const std::string* trackId = params != nullptr ? findPtr<std::string>(*params, "trackId") : nullptr;
+      if (trackId == nullptr || trackId->empty()) {
+        output->SetVideoTrack(nullptr);
+        return result->Success();
+      }
+
+      libwebrtc::scoped_refptr<libwebrtc::RTCMediaTrack> track = base->MediaTracksForId(*trackId);
+      if (track == nullptr || track->kind().std_string() != "video") {
+        return result->Error("Invalid Argument",
+          "DriverInterface::SetVideoTrack no video track with id '" + *trackId + "'.");
+      }
+      output->SetVideoTrack(static_cast<libwebrtc::RTCVideoTrack*>(track.get()));
       result->Success();
     }},
-    {"DriverInterface::StopVideoProcessing", [&] {
-      driver_interface::VideoProcessingThread::Stop();
+    {"DriverInterface::StartVideoProcessing", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      if (std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::StartVideoProcessing")) {
+        output->thread().Start();
+        result->Success();
+      }
+    }},
+    {"DriverInterface::StopVideoProcessing", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      if (std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::StopVideoProcessing")) {
+        output->thread().Stop();
+        result->Success();
+      }
+    }},
+    {"DriverInterface::SetDeliveryPolicy", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      if (params == nullptr) {
+        return result->Error("Missing Arguments",
+          "DriverInterface::SetDeliveryPolicy requires an argument named 'policy'."
+        );
+      }
+
+      static const std::unordered_map<std::string, driver_interface::DeliveryPolicy> policies = {
+        {"latest", driver_interface::DeliveryPolicy::kLatest},
+        {"ring", driver_interface::DeliveryPolicy::kRing},
+        {"block", driver_interface::DeliveryPolicy::kBlock},
+      };
+
+      auto policy = policies.find(findStringRef(*params, "policy"));
+      if (policy == policies.end()) {
+        return result->Error("Invalid Argument",
+          "DriverInterface::SetDeliveryPolicy argument 'policy' must be one of: latest, ring, block.");
+      }
+
+      std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::SetDeliveryPolicy");
+      if (output == nullptr) {
+        return;
+      }
+
+      const int capacity = findInt(*params, "capacity");
+      output->thread().SetDeliveryPolicy(policy->second, capacity > 0 ? static_cast<size_t>(capacity) : 1);
       result->Success();
     }},
+    {"DriverInterface::SetMaxResolution", [](const EncodableMap* params, MethodResultProxy* result, auto) {
+      if (params == nullptr) {
+        return result->Error("Missing Arguments",
+          "DriverInterface::SetMaxResolution requires arguments named 'width' and 'height'."
+        );
+      }
+
+      const int width = findInt(*params, "width");
+      const int height = findInt(*params, "height");
+      if (width < 0 || height < 0) {
+        return result->Error("Invalid Argument",
+          "DriverInterface::SetMaxResolution arguments 'width' and 'height' cannot be negative.");
+      }
+
+      if (std::shared_ptr<VideoOutput> output = findOutput(params, result, "DriverInterface::SetMaxResolution")) {
+        output->SetMaxResolution(width, height);
+        result->Success();
+      }
+    }},
+    {"DriverInterface::GetFramePoolStats", [](const EncodableMap*, MethodResultProxy* result, auto) {
+      const FrameBufferPoolStats stats = FrameBufferPool::GetStats();
+
+      EncodableMap info;
+      info[EncodableValue("hits")] = EncodableValue(static_cast<int64_t>(stats.hits));
+      info[EncodableValue("misses")] = EncodableValue(static_cast<int64_t>(stats.misses));
+      info[EncodableValue("buffers")] = EncodableValue(static_cast<int64_t>(stats.buffers));
+      info[EncodableValue("inUse")] = EncodableValue(static_cast<int64_t>(stats.inUse));
+
+      result->Success(EncodableValue(info));
+    }},
   };
 
   auto it = methodHandlers.find(method_call.method_name());
-  if (it != methodHandlers.end()) {
-    it->second();
-  } else {
+  if (it == methodHandlers.end()) {
     return false;
   }
+
+  const flutter::EncodableValue* arguments = method_call.arguments();
+  const flutter::EncodableMap* params = arguments ? std::get_if<EncodableMap>(arguments) : nullptr;
+  it->second(params, result.get(), base);
   return true;
 }
 
@@ -84,6 +210,37 @@ namespace driver_interface {
 
 std::unique_ptr<EventChannelProxy> event_channel_;
 
+inline void ConfigureOutputEvents(VideoOutput& output) {
+  const int handle = output.handle();
+
+  output.thread().SetCallback([handle](const std::string& errorMsg) {
+      EncodableMap params;
+      params[EncodableValue("event")] = EncodableValue("videoProcessingError");
+      params[EncodableValue("output")] = EncodableValue(handle);
+      params[EncodableValue("message")] = EncodableValue(errorMsg);
+      // Only the current error of an output matters, an empty one clears it.
+      event_channel_->Coalesce("videoProcessingError" + std::to_string(handle), EncodableValue(params));
+  });
+
+  // Reports come in about once per second, sent and skipped are also
+  // reported as per-report deltas so listeners can tell an idle camera at a glance.
+  output.thread().SetStatsCallback([handle, last = VideoProcessingStats()](const VideoProcessingStats& stats) mutable {
+      EncodableMap params;
+      params[EncodableValue("event")] = EncodableValue("videoProcessingStats");
+      params[EncodableValue("output")] = EncodableValue(handle);
+      params[EncodableValue("enqueued")] = EncodableValue(static_cast<int64_t>(stats.enqueued));
+      params[EncodableValue("dropped")] = EncodableValue(static_cast<int64_t>(stats.dropped));
+      params[EncodableValue("delivered")] = EncodableValue(static_cast<int64_t>(stats.delivered));
+      params[EncodableValue("sent")] = EncodableValue(static_cast<int64_t>(stats.sent));
+      params[EncodableValue("skipped")] = EncodableValue(static_cast<int64_t>(stats.skipped));
+      params[EncodableValue("sentPerSecond")] = EncodableValue(static_cast<int64_t>(stats.sent - last.sent));
+      params[EncodableValue("skippedPerSecond")] = EncodableValue(static_cast<int64_t>(stats.skipped - last.skipped));
+      last = stats;
+      // Stats are only meaningful live, don't queue them up before a listener attaches.
+      event_channel_->Coalesce("videoProcessingStats" + std::to_string(handle), EncodableValue(params), false);
+  });
+}
+
 class DriverInterfaceEventHandler {
 public:
   static void Initialize(BinaryMessenger* messenger) {
@@ -91,9 +248,7 @@ public:
 
     event_channel_ = EventChannelProxy::Create(messenger, channel_name);
 
-    VideoProcessingThread::SetCallback([&](const std::string& errorMsg) {
-        event_channel_->Success(EncodableValue(errorMsg));
-    });
+    ConfigureOutputEvents(*VideoOutput::Get(VideoOutput::kDefaultHandle));
   }
 
   static void Release() {
@@ -103,4 +258,4 @@ public:
 
 }  // namespace driver_interface
 
-#endif // DRIVER_INTERFACE_HANDLER_H
\ No newline at end of file
+#endif // DRIVER_INTERFACE_HANDLER_H
@@ -0,0 +1,131 @@
+#ifndef DRIVER_INTERFACE_VIDEO_OUTPUT_H
+#define DRIVER_INTERFACE_VIDEO_OUTPUT_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "driver_interface.h"
+#include "driver_interface_video_proc_thread.h"
+#include "flutter_frame_hub.h"
+
+namespace driver_interface {
+
+/**
+ * @brief One virtual camera output: a device, the worker thread feeding it
+ * and the video track it's fed from.
+ *
+ * Outputs are addressed by handle. Handle 0 is the default output, it always
+ * exists and follows the most recently rendered video track. Other outputs
+ * are created on demand and only show the track explicitly set on them.
+ */
+class VideoOutput : public flutter_webrtc_plugin::FrameSink {
+public:
+    static constexpr int kDefaultHandle = 0;
+
+    /**
+     * @brief Create a new output.
+     *
+     * @return The handle of the output.
+     */
+    static int Create();
+
+    /**
+     * @brief Get an output by handle.
+     *
+     * @param handle The output handle.
+     *
+     * @return The output, nullptr if there is no output with this handle.
+     */
+    static std::shared_ptr<VideoOutput> Get(int handle);
+
+    /**
+     * @brief Get all outputs, the default output first.
+     */
+    static std::vector<std::shared_ptr<VideoOutput>> GetAll();
+
+    /**
+     * @brief Stop and remove an output, the default output is only stopped and reset.
+     *
+     * @param handle The output handle.
+     *
+     * @return false if there is no output with this handle.
+     */
+    static bool Release(int handle);
+
+    /**
+     * @brief Detach outputs that follow the rendered track from track.
+     *
+     * @param track The video track no longer rendered.
+     */
+    static void ReleaseRenderedTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track);
+
+    /**
+     * @brief Attach outputs that follow the rendered track to track.
+     *
+     * @param track The video track now being rendered.
+     */
+    static void SetRenderedTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track);
+
+    explicit VideoOutput(int handle);
+    ~VideoOutput();
+
+    int handle() const { return handle_; }
+
+    /**
+     * @brief Set the device this output sends to.
+     *
+     * @param devicePath The device path to send to.
+     *
+     * @return 0: Success, 1: Failure (device not found).
+     */
+    int SetDevice(const std::string& devicePath);
+
+    /**
+     * @brief Stop sending to the device.
+     */
+    void DestroyDevice();
+
+    /**
+     * @brief Set the largest resolution sent to the device, larger frames
+     * are scaled down keeping their aspect ratio.
+     *
+     * @param maxWidth Maximum width, 0 for no limit.
+     * @param maxHeight Maximum height, 0 for no limit.
+     */
+    void SetMaxResolution(int maxWidth, int maxHeight);
+
+    /**
+     * @brief Set the track feeding this output, replacing the current one.
+     *
+     * @param track The video track, nullptr to detach.
+     */
+    void SetVideoTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track);
+
+    VideoProcessingThread& thread() { return thread_; }
+
+    void OnFrame(const flutter_webrtc_plugin::HubFrame& frame) override;
+
+private:
+    int Send(const VideoProcessingTask& task);
+
+    const int handle_;
+    // Whether the output follows the most recently rendered track.
+    bool follow_rendered_track_;
+
+    std::mutex device_mutex_;
+    std::unique_ptr<VirtualCameraOutput> device_;
+    int max_width_ = 0;
+    int max_height_ = 0;
+
+    std::mutex hub_mutex_;
+    libwebrtc::scoped_refptr<flutter_webrtc_plugin::FrameFanoutHub> hub_;
+
+    VideoProcessingThread thread_;
+};
+
+}  // namespace driver_interface
+
+#endif // DRIVER_INTERFACE_VIDEO_OUTPUT_H
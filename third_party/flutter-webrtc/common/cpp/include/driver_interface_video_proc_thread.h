@@ -1,55 +1,135 @@
 #ifndef DRIVER_INTERFACE_VIDEO_PROCESSING_THREAD_H
 #define DRIVER_INTERFACE_VIDEO_PROCESSING_THREAD_H
 
+#include <atomic>
 #include <thread>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
 
+#include "rtc_video_frame.h"
+
 namespace driver_interface {
 using ErrorCallback = std::function<void(const std::string&)>;
 
 typedef struct {
-    uint8_t* buffer;
-    size_t width;
-    size_t height;
+    // Decoded frame, converted straight into the driver's shared memory.
+    libwebrtc::scoped_refptr<libwebrtc::RTCVideoFrame> frame;
 } VideoProcessingTask;
 
+/**
+ * @brief How pending tasks are handled when the driver falls behind.
+ */
+enum class DeliveryPolicy {
+    kLatest,  // Keep only the newest frame, replacing any pending one.
+    kRing,    // Keep up to N frames, dropping the oldest when full.
+    kBlock,   // Keep up to N frames, blocking the producer when full.
+};
+
+typedef struct {
+    uint64_t enqueued;   // Frames accepted by AddTask.
+    uint64_t dropped;    // Frames replaced by a newer frame before delivery.
+    uint64_t delivered;  // Frames handed to the driver.
+    uint64_t sent;       // Delivered frames written to the virtual camera.
+    uint64_t skipped;    // Delivered frames skipped unconverted, no app was reading the camera.
+} VideoProcessingStats;
+
+using StatsCallback = std::function<void(const VideoProcessingStats&)>;
+
+/**
+ * @brief Sends the frame of a task, returning a DriverInterface status code.
+ */
+using SendFunction = std::function<int(const VideoProcessingTask&)>;
+
+/**
+ * @brief A worker thread feeding one virtual camera output.
+ */
 class VideoProcessingThread {
 public:
+    /**
+     * @brief Create a stopped processing thread.
+     *
+     * @param send Called on the processing thread for every delivered task.
+     */
+    explicit VideoProcessingThread(SendFunction send);
+
+    ~VideoProcessingThread();
+
     /**
      * @brief Start the video processing thread.
      */
-    static void Start();
+    void Start();
 
     /**
      * @brief Stop the video processing thread.
      */
-    static void Stop();
+    void Stop();
 
     /**
      * @brief Add a task to the processing queue.
-     * 
+     *
      * @param task The VideoProcessingTask to add.
      */
-    static void AddTask(const VideoProcessingTask& task);
+    void AddTask(const VideoProcessingTask& task);
+
+    /**
+     * @brief Set how tasks are queued when the driver falls behind.
+     *
+     * @param policy The delivery policy to use.
+     * @param capacity Maximum pending tasks, ignored for DeliveryPolicy::kLatest.
+     */
+    void SetDeliveryPolicy(DeliveryPolicy policy, size_t capacity);
+
+    /**
+     * @brief Get the frame delivery counters.
+     */
+    VideoProcessingStats GetStats() const;
 
     /**
      * @brief Set the callback function to handle errors.
-     * 
+     *
      * @param callback The callback function for error handling.
      */
-    static void SetCallback(ErrorCallback callback);
+    void SetCallback(ErrorCallback callback);
+
+    /**
+     * @brief Set the callback function receiving the delivery counters,
+     * called from the processing thread at most once per second.
+     *
+     * @param callback The callback function for stats reporting.
+     */
+    void SetStatsCallback(StatsCallback callback);
 
 private:
     /**
      * @brief The main loop of the processing thread.
      */
-    static void ProcessingLoop();
+    void ProcessingLoop();
+
+    SendFunction send_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable space_condition_;
+    std::thread processing_thread_;
+    std::deque<VideoProcessingTask> task_queue_;
+    bool stop_thread_ = false;
+    bool running_ = false;
+    int status_ = 2;
+    ErrorCallback error_callback_;
+    StatsCallback stats_callback_;
+
+    DeliveryPolicy policy_ = DeliveryPolicy::kLatest;
+    size_t capacity_ = 1;
+
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> skipped_{0};
 };
 
 }  // namespace driver_interface
 
-#endif // DRIVER_INTERFACE_VIDEO_PROCESSING_THREAD_H
\ No newline at end of file
+#endif // DRIVER_INTERFACE_VIDEO_PROCESSING_THREAD_H
@@ -13,6 +13,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 
 typedef flutter::EncodableValue EncodableValue;
 typedef flutter::EncodableMap EncodableMap;
@@ -30,81 +31,136 @@ typedef flutter::MethodResult<EncodableValue> MethodResult;
 // foo.IsString() becomes std::holds_alternative<std::string>(foo)
 
 template <typename T>
-inline bool TypeIs(const EncodableValue val) {
+inline bool TypeIs(const EncodableValue& val) {
   return std::holds_alternative<T>(val);
 }
 
 template <typename T>
-inline const T GetValue(EncodableValue val) {
+inline const T GetValue(const EncodableValue& val) {
   return std::get<T>(val);
 }
 
+// Non-owning accessors. The returned pointers and references point into
+// |map| and stay valid for as long as it does, nothing is copied. Prefer
+// them over the by-value find* helpers below in method handlers.
+
+// Looks |key| up without building an EncodableValue for it. String keys
+// sort together by value, so the scan stops at the first one past |key|.
+inline const EncodableValue* findValuePtr(const EncodableMap& map,
+                                          std::string_view key) {
+  for (const auto& entry : map) {
+    const std::string* name = std::get_if<std::string>(&entry.first);
+    if (name == nullptr)
+      continue;
+    const int order = std::string_view(*name).compare(key);
+    if (order == 0)
+      return &entry.second;
+    if (order > 0)
+      break;
+  }
+  return nullptr;
+}
+
+// Returns nullptr if |key| is missing or holds another type.
+template <typename T>
+inline const T* findPtr(const EncodableMap& map, std::string_view key) {
+  return std::get_if<T>(findValuePtr(map, key));
+}
+
+template <typename T>
+inline const T& findRef(const EncodableMap& map, std::string_view key) {
+  static const T empty;
+  const T* value = findPtr<T>(map, key);
+  return value != nullptr ? *value : empty;
+}
+
+inline const EncodableMap& findMapRef(const EncodableMap& map,
+                                      std::string_view key) {
+  return findRef<EncodableMap>(map, key);
+}
+
+inline const EncodableList& findListRef(const EncodableMap& map,
+                                        std::string_view key) {
+  return findRef<EncodableList>(map, key);
+}
+
+inline const std::string& findStringRef(const EncodableMap& map,
+                                        std::string_view key) {
+  return findRef<std::string>(map, key);
+}
+
+inline const std::vector<uint8_t>& findVectorRef(const EncodableMap& map,
+                                                 std::string_view key) {
+  return findRef<std::vector<uint8_t>>(map, key);
+}
+
+// Points |data| and |size| at the bytes of a byte list argument. Where the
+// method channel reads large byte lists as views into the platform message
+// (FLUTTER_WEBRTC_BYTE_LIST_VIEWS), they arrive as flutter::ByteListView
+// instead of std::vector<uint8_t>.
+inline bool GetBytes(const EncodableValue& value,
+                     const uint8_t** data,
+                     size_t* size) {
+  if (const auto* bytes = std::get_if<std::vector<uint8_t>>(&value)) {
+    *data = bytes->data();
+    *size = bytes->size();
+    return true;
+  }
+#ifdef FLUTTER_WEBRTC_BYTE_LIST_VIEWS
+  if (const flutter::ByteListView* view = flutter::GetByteListView(value)) {
+    *data = view->data;
+    *size = view->size;
+    return true;
+  }
+#endif
+  return false;
+}
+
 inline EncodableValue findEncodableValue(const EncodableMap& map,
                                          const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end())
-    return it->second;
-  return EncodableValue();
+  const EncodableValue* value = findValuePtr(map, key);
+  return value != nullptr ? *value : EncodableValue();
 }
 
 inline EncodableMap findMap(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<EncodableMap>(it->second))
-    return GetValue<EncodableMap>(it->second);
-  return EncodableMap();
+  return findMapRef(map, key);
 }
 
 inline EncodableList findList(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<EncodableList>(it->second))
-    return GetValue<EncodableList>(it->second);
-  return EncodableList();
+  return findListRef(map, key);
 }
 
 inline std::string findString(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<std::string>(it->second))
-    return GetValue<std::string>(it->second);
-  return std::string();
+  return findStringRef(map, key);
 }
 
 inline int findInt(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<int>(it->second))
-    return GetValue<int>(it->second);
-  return -1;
+  const int* value = findPtr<int>(map, key);
+  return value != nullptr ? *value : -1;
 }
 
 inline bool findBoolean(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<bool>(it->second))
-    return GetValue<bool>(it->second);
-  return false;
+  const bool* value = findPtr<bool>(map, key);
+  return value != nullptr ? *value : false;
 }
 
 inline double findDouble(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<double>(it->second))
-    return GetValue<double>(it->second);
-  return 0.0;
+  const double* value = findPtr<double>(map, key);
+  return value != nullptr ? *value : 0.0;
 }
 
 inline std::vector<uint8_t> findVector(const EncodableMap& map,
                                        const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<std::vector<uint8_t>>(it->second))
-    return GetValue<std::vector<uint8_t>>(it->second);
-  return std::vector<uint8_t>();
+  return findVectorRef(map, key);
 }
 
 inline int64_t findLongInt(const EncodableMap& map, const std::string& key) {
-  for (auto it : map) {
-    if (key == GetValue<std::string>(it.first)) {
-      if (TypeIs<int64_t>(it.second)) {
-        return GetValue<int64_t>(it.second);
-      } else if (TypeIs<int32_t>(it.second)) {
-        return GetValue<int32_t>(it.second);
-      }
+  const EncodableValue* value = findValuePtr(map, key);
+  if (value != nullptr) {
+    if (TypeIs<int64_t>(*value)) {
+      return GetValue<int64_t>(*value);
+    } else if (TypeIs<int32_t>(*value)) {
+      return GetValue<int32_t>(*value);
     }
   }
 
@@ -167,8 +223,22 @@ class EventChannelProxy {
 
   virtual ~EventChannelProxy() = default;
 
+  // Sends |event| to the listener on the platform thread, from any thread.
+  // Without a listener it is cached until one attaches if |cache_event| is
+  // set, the oldest cached events are dropped once the cache is full.
   virtual void Success(const EncodableValue& event,
                        bool cache_event = true) = 0;
+
+  // Like Success, but an event with the same |key| still waiting to be
+  // delivered or cached is replaced by |event|. For updates where only the
+  // latest value matters.
+  virtual void Coalesce(const std::string& key,
+                        const EncodableValue& event,
+                        bool cache_event = true) = 0;
+
+  // Events dropped because the cache was full. Drops are also logged when a
+  // listener attaches, or when the channel is destroyed without one.
+  virtual uint64_t dropped_events() const = 0;
 };
 
 #endif  // FLUTTER_WEBRTC_COMMON_HXX
@@ -1,16 +1,37 @@
 #ifndef FLUTTER_WEBRTC_RTC_DATA_CHANNEL_HXX
 #define FLUTTER_WEBRTC_RTC_DATA_CHANNEL_HXX
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "flutter_common.h"
 #include "flutter_webrtc_base.h"
 
 namespace flutter_webrtc_plugin {
 
+// Data channel payloads travel on a binary message channel of their own,
+// without StandardMethodCodec. Each frame starts with a one byte header
+// holding its kind, followed by the payload.
+enum DataChannelFrameKind : uint8_t {
+  kDataChannelFrameBinary = 0,
+  kDataChannelFrameText = 1,
+  // Sent once by the Dart side when it listens, carries no payload.
+  kDataChannelFrameAttach = 2,
+};
+
+constexpr size_t kDataChannelFrameHeaderSize = 1;
+
+class DataChannelFrameTarget;
+
 class FlutterRTCDataChannelObserver : public RTCDataChannelObserver {
  public:
+  // |channel_name| is the event channel, |frame_channel_name| the binary
+  // channel carrying frames.
   FlutterRTCDataChannelObserver(scoped_refptr<RTCDataChannel> data_channel,
                                 BinaryMessenger* messenger,
-                                const std::string& channel_name);
+                                const std::string& channel_name,
+                                const std::string& frame_channel_name);
   virtual ~FlutterRTCDataChannelObserver();
 
   virtual void OnStateChange(RTCDataChannelState state) override;
@@ -20,8 +41,18 @@ class FlutterRTCDataChannelObserver : public RTCDataChannelObserver {
   scoped_refptr<RTCDataChannel> data_channel() { return data_channel_; }
 
  private:
+  // Sends the payload of a frame from Dart, straight out of the message.
+  void OnFrame(const uint8_t* frame, size_t size);
+
   std::unique_ptr<EventChannelProxy> event_channel_;
   scoped_refptr<RTCDataChannel> data_channel_;
+  BinaryMessenger* messenger_;
+  std::string frame_channel_name_;
+  // Received frames are posted here and sent on the platform thread.
+  std::shared_ptr<DataChannelFrameTarget> frame_target_;
+  // Set once Dart listens for frames, messages received before are queued
+  // as events.
+  std::atomic<bool> frames_attached_{false};
 };
 
 class FlutterDataChannel {
@@ -0,0 +1,45 @@
+#ifndef FLUTTER_WEBRTC_EVENT_BUS_HXX
+#define FLUTTER_WEBRTC_EVENT_BUS_HXX
+
+#include "flutter_common.h"
+
+#include <memory>
+#include <string>
+
+namespace flutter_webrtc_plugin {
+
+// Receives events posted to the EventBus, on the platform thread.
+class EventBusTarget {
+ public:
+  virtual ~EventBusTarget() = default;
+
+  // |key| is empty for events that are never coalesced.
+  virtual void Deliver(const std::string& key,
+                       EncodableValue event,
+                       bool cache_event) = 0;
+};
+
+// Hands events from any thread to their targets on the platform thread.
+//
+// Producers push onto a lock-free multi-producer, single-consumer queue and
+// the platform thread drains it in batches. Of the events in a batch that
+// share a target and a non-empty key, only the newest one is delivered, so
+// a burst of size or stats updates costs one delivery once the platform
+// thread gets to it. Events posted on the platform thread itself are
+// delivered right away, after whatever is still queued.
+class EventBus {
+ public:
+  // Binds the bus to the calling thread, which must be the platform thread.
+  // Events posted before are delivered on the posting thread.
+  static void Start();
+
+  // Queues |event| for |target|, dropped if |target| is gone by then.
+  static void Post(std::weak_ptr<EventBusTarget> target,
+                   std::string key,
+                   EncodableValue event,
+                   bool cache_event);
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // FLUTTER_WEBRTC_EVENT_BUS_HXX
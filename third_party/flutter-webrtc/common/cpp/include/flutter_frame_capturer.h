@@ -4,34 +4,59 @@
 #include "flutter_common.h"
 #include "flutter_webrtc_base.h"
 
-#include "rtc_video_frame.h"
-#include "rtc_video_renderer.h"
+#include "flutter_frame_hub.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace flutter_webrtc_plugin {
 
 using namespace libwebrtc;
 
+// Saves the next frames of a video track as PNG or raw I420 files without
+// blocking the calling thread. One sink collects the frames, a worker thread waits for
+// them, converts and encodes them, then replies.
 class FlutterFrameCapturer
-    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>> {
+    : public FrameSink,
+      public std::enable_shared_from_this<FlutterFrameCapturer> {
  public:
-  FlutterFrameCapturer(RTCVideoTrack* track, std::string path);
+  // Captures the next |count| frames of |track|. Frame i of a burst is
+  // written to |path| with "_i" inserted before the extension, a single
+  // frame to |path| itself. A ".yuv" or ".i420" extension writes the raw
+  // I420 planes, anything else a PNG. Replies with a {path, width, height}
+  // map per file written once |count| frames arrived, or for those that
+  // arrived within |timeout|. Fails if none did.
+  static void Capture(RTCVideoTrack* track,
+                      const std::string& path,
+                      size_t count,
+                      std::chrono::milliseconds timeout,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  virtual void OnFrame(const HubFrame& hub_frame) override;
 
-  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+ private:
+  FlutterFrameCapturer(const std::string& path, size_t count);
 
-  void CaptureFrame(std::unique_ptr<MethodResultProxy> result);
+  // Runs on the worker thread.
+  void Run(scoped_refptr<FrameFanoutHub> hub,
+           std::chrono::milliseconds timeout,
+           std::unique_ptr<MethodResultProxy> result);
+
+  std::string FramePath(size_t index) const;
+
+  static bool SaveFrame(const scoped_refptr<RTCVideoFrame>& frame,
+                        const std::string& path);
 
- private:
-  RTCVideoTrack* track_;
   std::string path_;
+  size_t count_;
   std::mutex mutex_;
-  scoped_refptr<RTCVideoFrame> frame_;
-  volatile bool catch_frame_;
-
-  bool SaveFrame();
+  std::condition_variable frames_ready_;
+  std::vector<scoped_refptr<RTCVideoFrame>> frames_;
 };
 
 }  // namespace flutter_webrtc_plugin
 
-#endif  // !FLUTTER_WEBRTC_RTC_FRAME_CAPTURER_HXX
\ No newline at end of file
+#endif  // !FLUTTER_WEBRTC_RTC_FRAME_CAPTURER_HXX
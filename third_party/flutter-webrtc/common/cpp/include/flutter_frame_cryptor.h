@@ -25,7 +25,7 @@ class FlutterFrameCryptor {
 
   bool HandleFrameCryptorMethodCall(
     const MethodCallProxy& method_call,
-    std::unique_ptr<MethodResultProxy> result);
+    std::unique_ptr<MethodResultProxy>& result);
 
   void FrameCryptorFactoryCreateFrameCryptor(
       const EncodableMap& constraints,
@@ -0,0 +1,82 @@
+#ifndef FLUTTER_WEBRTC_FRAME_HUB_HXX
+#define FLUTTER_WEBRTC_FRAME_HUB_HXX
+
+#include "rtc_video_frame.h"
+#include "rtc_video_renderer.h"
+#include "rtc_video_track.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+using namespace libwebrtc;
+
+// A decoded frame as delivered to a FrameSink.
+struct HubFrame {
+  scoped_refptr<RTCVideoFrame> frame;
+};
+
+struct FrameSinkOptions {
+  // Maximum frames per second delivered to the sink, 0 for no limit.
+  int max_fps = 0;
+};
+
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  // Called on the track's delivery thread.
+  virtual void OnFrame(const HubFrame& frame) = 0;
+};
+
+// Registers once as a renderer on a video track and fans its frames out to
+// any number of sinks, each with its own frame rate cap.
+// Frames flow at capture cadence regardless of whether any Flutter texture
+// is being painted.
+class FrameFanoutHub : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>,
+                       public RefCountInterface {
+ public:
+  // Returns the hub of |track|, creating it if needed.
+  static scoped_refptr<FrameFanoutHub> ForTrack(
+      scoped_refptr<RTCVideoTrack> track);
+
+  // Adds or updates a sink. Sinks must not be added or removed from
+  // within FrameSink::OnFrame.
+  void AddSink(FrameSink* sink, const FrameSinkOptions& options);
+
+  // Removes a sink, once this returns the sink won't be called anymore.
+  void RemoveSink(FrameSink* sink);
+
+  void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+
+  scoped_refptr<RTCVideoTrack> track() { return track_; }
+
+  // The last Release() unregisters the hub under the registry lock, so
+  // ForTrack() never hands out a hub that is being destroyed.
+  int AddRef() const override;
+  int Release() const override;
+
+ protected:
+  explicit FrameFanoutHub(scoped_refptr<RTCVideoTrack> track);
+  ~FrameFanoutHub();
+
+ private:
+  struct SinkEntry {
+    FrameSink* sink;
+    FrameSinkOptions options;
+    std::chrono::steady_clock::time_point last_delivery;
+  };
+
+  scoped_refptr<RTCVideoTrack> track_;
+  std::vector<SinkEntry> sinks_;
+  std::mutex mutex_;
+  mutable std::atomic<int> ref_count_{0};
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_FRAME_HUB_HXX
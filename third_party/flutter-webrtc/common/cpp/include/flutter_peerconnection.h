@@ -2,8 +2,12 @@
 #define FLUTTER_WEBRTC_RTC_PEER_CONNECTION_HXX
 
 #include "flutter_common.h"
+#include "flutter_stats_subscription.h"
+#include "flutter_video_recorder.h"
 #include "flutter_webrtc_base.h"
 
+#include <chrono>
+
 namespace flutter_webrtc_plugin {
 
 class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
@@ -143,8 +147,22 @@ class FlutterPeerConnection {
 
   void CaptureFrame(RTCVideoTrack* track,
                     std::string path,
+                    size_t count,
+                    std::chrono::milliseconds timeout,
                     std::unique_ptr<MethodResultProxy> result);
 
+  void StartRecordToFile(int recorder_id,
+                         RTCVideoTrack* track,
+                         const std::string& path,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  // Replies with the recorder's final stats.
+  void StopRecordToFile(int recorder_id,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void GetRecorderStats(int recorder_id,
+                        std::unique_ptr<MethodResultProxy> result);
+
   scoped_refptr<RTCRtpTransceiver> getRtpTransceiverById(RTCPeerConnection* pc,
                                                          std::string id);
 
@@ -170,6 +188,18 @@ class FlutterPeerConnection {
                 RTCPeerConnection* pc,
                 std::unique_ptr<MethodResultProxy> result);
 
+  // Pushes the selected |fields| of |pc|'s stats every |interval| on the
+  // "FlutterWebRTC/statsSubscription<subscription_id>" event channel, see
+  // FlutterStatsSubscription.
+  void SubscribeStats(const std::string& peer_connection_id,
+                      int subscription_id,
+                      const EncodableList& fields,
+                      std::chrono::milliseconds interval,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void UnsubscribeStats(int subscription_id,
+                        std::unique_ptr<MethodResultProxy> result);
+
   void MediaStreamAddTrack(scoped_refptr<RTCMediaStream> stream,
                            scoped_refptr<RTCMediaTrack> track,
                            std::unique_ptr<MethodResultProxy> result);
@@ -189,6 +219,11 @@ class FlutterPeerConnection {
 
  private:
   FlutterWebRTCBase* base_;
+  // Platform thread only. Destroyed, and so stopped, before the base
+  // terminates libwebrtc.
+  std::map<int, std::unique_ptr<FlutterVideoRecorder>> video_recorders_;
+  std::map<int, std::unique_ptr<FlutterStatsSubscription>>
+      stats_subscriptions_;
 };
 
 std::string RTCMediaTypeToString(RTCMediaType type);
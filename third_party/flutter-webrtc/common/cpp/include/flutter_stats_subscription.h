@@ -0,0 +1,99 @@
+#ifndef FLUTTER_WEBRTC_RTC_STATS_SUBSCRIPTION_HXX
+#define FLUTTER_WEBRTC_RTC_STATS_SUBSCRIPTION_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+using namespace libwebrtc;
+
+// Polls the stats of a peer connection at a fixed interval and pushes the
+// selected numeric members to an event channel, off the platform thread.
+//
+// Fields are selected as "<report type>.<member>", e.g. "inbound-rtp.jitter".
+// Every matching report contributes a column. Columns are described once by
+//   {"event": "statsSchema", "first": n,
+//    "columns": [[report id, report type, member], ...]}
+// numbering them from |first| on, and values are sent as
+//   {"event": "statsDelta", "timestampUs": t,
+//    "indices": Int32List, "values": Float64List}
+// holding only the columns that changed since the previous delta. A delta
+// is sent for every poll that found a selected report, empty if nothing
+// changed, so rates fall to zero when counters stall. Booleans are sent
+// as 0 or 1, string members can't be selected.
+class FlutterStatsSubscription {
+ public:
+  static std::unique_ptr<FlutterStatsSubscription> Start(
+      BinaryMessenger* messenger,
+      const std::string& channel_name,
+      const std::string& peer_connection_id,
+      scoped_refptr<RTCPeerConnection> pc,
+      const EncodableList& fields,
+      std::chrono::milliseconds interval);
+
+  // Stops like Stop().
+  ~FlutterStatsSubscription();
+
+  // Stops polling, nothing is sent once this returns.
+  void Stop();
+
+  const std::string& peer_connection_id() const { return peer_connection_id_; }
+
+ private:
+  // Column state, shared with the stats callbacks which may outlive the
+  // subscription.
+  struct Poller {
+    // Where the selected members of a report are, by position in
+    // MediaRTCStats::Members(). Resolved by name once per report, and
+    // again if its member count changes.
+    struct ReportColumns {
+      size_t member_count = 0;
+      std::vector<std::pair<size_t, int32_t>> columns;
+    };
+
+    void OnReports(const vector<scoped_refptr<MediaRTCStats>>& reports);
+
+    std::mutex mutex;
+    bool stopped = false;
+    bool in_flight = false;
+    EventChannelProxy* event_channel = nullptr;
+    // Selected members by report type.
+    std::unordered_map<std::string, std::vector<std::string>> fields;
+    std::unordered_map<std::string, ReportColumns> reports;
+    // Column of "<report id>\n<member>", kept across re-resolves.
+    std::unordered_map<std::string, int32_t> column_ids;
+    // The value last sent per column, NaN before the first.
+    std::vector<double> values;
+  };
+
+  FlutterStatsSubscription(const std::string& peer_connection_id,
+                           scoped_refptr<RTCPeerConnection> pc,
+                           std::chrono::milliseconds interval);
+
+  void Run();
+
+  std::string peer_connection_id_;
+  scoped_refptr<RTCPeerConnection> pc_;
+  std::chrono::milliseconds interval_;
+  std::unique_ptr<EventChannelProxy> event_channel_;
+  std::shared_ptr<Poller> poller_;
+
+  std::mutex mutex_;
+  std::condition_variable stop_requested_;
+  bool stopping_ = false;
+  std::thread timer_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTC_STATS_SUBSCRIPTION_HXX
@@ -0,0 +1,109 @@
+#ifndef FLUTTER_WEBRTC_RTC_VIDEO_RECORDER_HXX
+#define FLUTTER_WEBRTC_RTC_VIDEO_RECORDER_HXX
+
+#include "flutter_common.h"
+#include "flutter_frame_hub.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+using namespace libwebrtc;
+
+struct VideoRecorderStats {
+  uint64_t frames_written = 0;
+  // Frames not recorded because every slot was waiting for the disk.
+  uint64_t frames_dropped = 0;
+  // Frames not recorded because their size differs from the first frame.
+  uint64_t frames_resized = 0;
+  uint64_t bytes_written = 0;
+  bool write_failed = false;
+};
+
+// Streams the decoded frames of a video track to a file, for offline
+// quality and latency analysis. A ".y4m" path gets a YUV4MPEG2 stream of
+// I420 frames, anything else raw NV12 frames back to back. Either way
+// "<path>.idx" gets a "<offset> <width> <height> <arrival_us>" line per
+// frame, arrival measured from the first frame.
+//
+// The delivery thread only copies a frame into a free slot of a small ring
+// and returns, a writer thread writes each slot out with a single write.
+// When every slot is still waiting for the disk the frame is dropped and
+// counted instead of stalling the live path.
+class FlutterVideoRecorder : public FrameSink {
+ public:
+  static constexpr size_t kSlots = 8;
+
+  // Opens |path| and its index and starts recording |track|. Returns null
+  // with |error| set if a file can't be created.
+  static std::unique_ptr<FlutterVideoRecorder> Start(
+      scoped_refptr<RTCVideoTrack> track,
+      const std::string& path,
+      std::string* error);
+
+  // Stops like Stop().
+  ~FlutterVideoRecorder();
+
+  // Detaches from the track, writes out the frames already queued and
+  // closes the files. Safe to call more than once.
+  void Stop();
+
+  VideoRecorderStats stats() const;
+
+  virtual void OnFrame(const HubFrame& hub_frame) override;
+
+ private:
+  // Frame storage, aligned for the writes and allocated on first use.
+  struct Slot {
+    std::vector<uint8_t> storage;
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    int64_t arrival_us = 0;
+  };
+
+  FlutterVideoRecorder(bool y4m, FILE* file, FILE* index);
+
+  void Run();
+
+  bool WriteSlot(const Slot& slot);
+
+  const bool y4m_;
+  FILE* file_;
+  FILE* index_;
+  scoped_refptr<FrameFanoutHub> hub_;
+  std::thread writer_;
+
+  // Fixed by the first frame on the delivery thread. The writer reads them
+  // after taking a slot from |ready_|.
+  int width_ = 0;
+  int height_ = 0;
+  size_t frame_size_ = 0;
+  std::chrono::steady_clock::time_point first_arrival_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_changed_;
+  Slot slots_[kSlots];
+  std::vector<size_t> free_;
+  std::deque<size_t> ready_;
+  bool stopping_ = false;
+
+  uint64_t offset_ = 0;  // Writer thread only.
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> frames_dropped_{0};
+  std::atomic<uint64_t> frames_resized_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<bool> write_failed_{false};
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTC_VIDEO_RECORDER_HXX
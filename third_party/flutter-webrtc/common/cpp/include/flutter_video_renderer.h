@@ -4,8 +4,9 @@
 #include "flutter_common.h"
 #include "flutter_webrtc_base.h"
 
-#include "rtc_video_frame.h"
-#include "rtc_video_renderer.h"
+#include "flutter_frame_hub.h"
+
+#include "frame_buffer_pool.h"
 
 #include <mutex>
 
@@ -13,9 +14,34 @@ namespace flutter_webrtc_plugin {
 
 using namespace libwebrtc;
 
-class FlutterVideoRenderer
-    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>,
-      public RefCountInterface {
+// Counters of a renderer, all cumulative.
+struct VideoRendererStats {
+  // New frames made ready for the engine, converted once each off the
+  // raster thread.
+  uint64_t frames = 0;
+  // CopyPixelBuffer calls on the raster thread.
+  uint64_t pulls = 0;
+  // Pulls without a new frame since the last one, these republish the
+  // ready buffer and used to convert the same frame again.
+  uint64_t repeat_pulls = 0;
+  // Raster thread time spent in CopyPixelBuffer.
+  uint64_t pull_time_us = 0;
+  uint64_t max_pull_time_us = 0;
+  // Delivery thread time spent scaling and converting frames.
+  uint64_t convert_time_us = 0;
+  // Size of the last converted frame.
+  uint64_t width = 0;
+  uint64_t height = 0;
+};
+
+// Limits of a renderer's preview on top of its on-screen size, 0 for none.
+struct VideoRendererPreviewPolicy {
+  int max_width = 0;
+  int max_height = 0;
+  int max_fps = 0;
+};
+
+class FlutterVideoRenderer : public FrameSink, public RefCountInterface {
  public:
   FlutterVideoRenderer() = default;
   ~FlutterVideoRenderer();
@@ -28,7 +54,7 @@ class FlutterVideoRenderer
   virtual const FlutterDesktopPixelBuffer* CopyPixelBuffer(size_t width,
                                                            size_t height) const;
 
-  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+  virtual void OnFrame(const HubFrame& hub_frame) override;
 
   void SetVideoTrack(scoped_refptr<RTCVideoTrack> track);
 
@@ -38,6 +64,10 @@ class FlutterVideoRenderer
 
   bool CheckVideoTrack(std::string mediaId);
 
+  VideoRendererStats GetStats() const;
+
+  void SetPreviewPolicy(const VideoRendererPreviewPolicy& policy);
+
   std::string media_stream_id;
 
  private:
@@ -51,10 +81,35 @@ class FlutterVideoRenderer
   std::unique_ptr<EventChannelProxy> event_channel_;
   int64_t texture_id_ = -1;
   scoped_refptr<RTCVideoTrack> track_ = nullptr;
-  scoped_refptr<RTCVideoFrame> frame_;
+  scoped_refptr<FrameFanoutHub> hub_ = nullptr;
   std::unique_ptr<flutter::TextureVariant> texture_;
+
+  // Size frames are converted to for the requested on-screen size and the
+  // preview policy, called with mutex_ held.
+  void PreviewSize(size_t frame_width,
+                   size_t frame_height,
+                   int* width,
+                   int* height) const;
+
+  // An ABGR frame, scaled and converted on the track's delivery thread.
+  struct PixelFrame {
+    ConstFrameBufferLease pixels;
+    size_t width = 0;
+    size_t height = 0;
+    uint64_t generation = 0;
+  };
+  // The newest frame, swapped in by OnFrame.
+  PixelFrame ready_;
+  // The frame last handed to the engine, it must stay valid until the next
+  // pull. With the one the hub is converting that makes three buffers in
+  // flight, so neither thread waits on the other's pixel work.
+  mutable PixelFrame published_;
+  uint64_t generation_ = 0;
+  // On-screen size the engine last asked for, 0 until the first pull.
+  mutable FrameSize requested_size_ = {0, 0};
+  VideoRendererPreviewPolicy policy_;
   std::shared_ptr<FlutterDesktopPixelBuffer> pixel_buffer_;
-  mutable std::shared_ptr<uint8_t> rgb_buffer_;
+  mutable VideoRendererStats stats_;
   mutable std::mutex mutex_;
   RTCVideoFrame::VideoRotation rotation_ = RTCVideoFrame::kVideoRotation_0;
 };
@@ -73,6 +128,14 @@ class FlutterVideoRendererManager {
   void VideoRendererDispose(int64_t texture_id,
                             std::unique_ptr<MethodResultProxy> result);
 
+  void VideoRendererGetStats(int64_t texture_id,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void VideoRendererSetPreviewPolicy(
+      int64_t texture_id,
+      const VideoRendererPreviewPolicy& policy,
+      std::unique_ptr<MethodResultProxy> result);
+
  private:
   FlutterWebRTCBase* base_;
   std::map<int64_t, scoped_refptr<FlutterVideoRenderer>> renderers_;
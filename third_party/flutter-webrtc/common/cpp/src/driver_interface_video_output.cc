@@ -0,0 +1,173 @@
+#include "driver_interface_video_output.h"
+
+namespace driver_interface {
+
+using flutter_webrtc_plugin::FrameFanoutHub;
+
+namespace {
+
+std::mutex outputs_mutex_;
+std::map<int, std::shared_ptr<VideoOutput>> outputs_;
+int next_handle_ = VideoOutput::kDefaultHandle + 1;
+
+// Callers hold outputs_mutex_.
+std::shared_ptr<VideoOutput> DefaultOutput() {
+    std::shared_ptr<VideoOutput>& output = outputs_[VideoOutput::kDefaultHandle];
+    if (output == nullptr) {
+        output = std::make_shared<VideoOutput>(VideoOutput::kDefaultHandle);
+    }
+    return output;
+}
+
+}  // namespace
+
+int VideoOutput::Create() {
+    std::lock_guard<std::mutex> lock(outputs_mutex_);
+    const int handle = next_handle_++;
+    outputs_[handle] = std::make_shared<VideoOutput>(handle);
+    return handle;
+}
+
+std::shared_ptr<VideoOutput> VideoOutput::Get(int handle) {
+    std::lock_guard<std::mutex> lock(outputs_mutex_);
+    if (handle == kDefaultHandle) {
+        return DefaultOutput();
+    }
+    auto it = outputs_.find(handle);
+    return it != outputs_.end() ? it->second : nullptr;
+}
+
+std::vector<std::shared_ptr<VideoOutput>> VideoOutput::GetAll() {
+    std::lock_guard<std::mutex> lock(outputs_mutex_);
+    DefaultOutput();
+    std::vector<std::shared_ptr<VideoOutput>> outputs;
+    for (const auto& entry : outputs_) {
+        outputs.push_back(entry.second);
+    }
+    return outputs;
+}
+
+bool VideoOutput::Release(int handle) {
+    std::shared_ptr<VideoOutput> output;
+    {
+        std::lock_guard<std::mutex> lock(outputs_mutex_);
+        auto it = outputs_.find(handle);
+        if (it == outputs_.end()) {
+            return handle == kDefaultHandle;
+        }
+        output = it->second;
+        if (handle != kDefaultHandle) {
+            outputs_.erase(it);
+        }
+    }
+
+    // Tear down outside of outputs_mutex_, stopping joins the worker thread.
+    output->thread().Stop();
+    output->DestroyDevice();
+    if (handle != kDefaultHandle) {
+        output->SetVideoTrack(nullptr);
+    }
+    return true;
+}
+
+void VideoOutput::SetRenderedTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track) {
+    for (const std::shared_ptr<VideoOutput>& output : GetAll()) {
+        if (output->follow_rendered_track_) {
+            output->SetVideoTrack(track);
+        }
+    }
+}
+
+void VideoOutput::ReleaseRenderedTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track) {
+    for (const std::shared_ptr<VideoOutput>& output : GetAll()) {
+        if (!output->follow_rendered_track_) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(output->hub_mutex_);
+        const bool attached = output->hub_ != nullptr && output->hub_->track() == track;
+        lock.unlock();
+        if (attached) {
+            output->SetVideoTrack(nullptr);
+        }
+    }
+}
+
+VideoOutput::VideoOutput(int handle)
+    : handle_(handle),
+      follow_rendered_track_(handle == kDefaultHandle),
+      thread_([this](const VideoProcessingTask& task) { return Send(task); }) {}
+
+VideoOutput::~VideoOutput() {
+    // Stop first, a blocked AddTask would otherwise keep RemoveSink waiting.
+    thread_.Stop();
+    SetVideoTrack(nullptr);
+}
+
+int VideoOutput::SetDevice(const std::string& devicePath) {
+    std::unique_ptr<VirtualCameraOutput> device = VirtualCameraOutput::Create(devicePath);
+    if (device == nullptr) {
+        return 1; // device not found.
+    }
+
+    std::lock_guard<std::mutex> lock(device_mutex_);
+    device->SetMaxResolution(max_width_, max_height_);
+    device_ = std::move(device);
+    return 0;
+}
+
+void VideoOutput::DestroyDevice() {
+    std::lock_guard<std::mutex> lock(device_mutex_);
+    device_ = nullptr;
+}
+
+void VideoOutput::SetMaxResolution(int maxWidth, int maxHeight) {
+    std::lock_guard<std::mutex> lock(device_mutex_);
+    max_width_ = maxWidth;
+    max_height_ = maxHeight;
+    if (device_ != nullptr) {
+        device_->SetMaxResolution(maxWidth, maxHeight);
+    }
+}
+
+void VideoOutput::SetVideoTrack(libwebrtc::scoped_refptr<libwebrtc::RTCVideoTrack> track) {
+    std::lock_guard<std::mutex> lock(hub_mutex_);
+    if (hub_ != nullptr) {
+        if (hub_->track() == track) {
+            return;
+        }
+        hub_->RemoveSink(this);
+        hub_ = nullptr;
+    }
+
+    if (track != nullptr) {
+        hub_ = FrameFanoutHub::ForTrack(track);
+        hub_->AddSink(this, flutter_webrtc_plugin::FrameSinkOptions());
+    }
+}
+
+void VideoOutput::OnFrame(const flutter_webrtc_plugin::HubFrame& frame) {
+    VideoProcessingTask task;
+    task.frame = frame.frame;
+    thread_.AddTask(task);
+}
+
+int VideoOutput::Send(const VideoProcessingTask& task) {
+    std::lock_guard<std::mutex> lock(device_mutex_);
+    if (device_ == nullptr) {
+        return -1;
+    }
+
+    const libwebrtc::RTCVideoFrame* frame = task.frame.get();
+    I420Buffer buffer;
+    buffer.dataY = frame->DataY();
+    buffer.dataU = frame->DataU();
+    buffer.dataV = frame->DataV();
+    buffer.strideY = frame->StrideY();
+    buffer.strideU = frame->StrideU();
+    buffer.strideV = frame->StrideV();
+    buffer.width = frame->width();
+    buffer.height = frame->height();
+    return device_->SendBuffer(buffer);
+}
+
+}  // namespace driver_interface
@@ -1,28 +1,40 @@
-#include "driver_interface.h"
+#include <atomic>
+#include <chrono>
+
 #include "driver_interface_video_proc_thread.h"
 
 namespace driver_interface {
 
-std::mutex mutex_;
-std::condition_variable condition_;
-std::thread processing_thread_;
-std::queue<VideoProcessingTask> task_queue_;
-bool stop_thread_ = false;
-int status_ = 2;
-ErrorCallback error_callback_;
+constexpr auto kStatsInterval = std::chrono::seconds(1);
+
+VideoProcessingThread::VideoProcessingThread(SendFunction send)
+    : send_(std::move(send)) {}
 
+VideoProcessingThread::~VideoProcessingThread() {
+    Stop();
+}
 
 void VideoProcessingThread::Start() {
     if (!processing_thread_.joinable()) {
-        stop_thread_ = false;
-        processing_thread_ = std::thread(ProcessingLoop);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_thread_ = false;
+            running_ = true;
+        }
+        processing_thread_ = std::thread(&VideoProcessingThread::ProcessingLoop, this);
     }
 }
 
 void VideoProcessingThread::Stop() {
     if (processing_thread_.joinable()) {
-        stop_thread_ = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_thread_ = true;
+            running_ = false;
+            task_queue_.clear();
+        }
         condition_.notify_one();
+        space_condition_.notify_all();
         processing_thread_.join();
         status_ = 2; // reset status for error propagation
     }
@@ -32,53 +44,130 @@ void VideoProcessingThread::SetCallback(ErrorCallback callback) {
     error_callback_ = std::move(callback);
 }
 
+void VideoProcessingThread::SetStatsCallback(StatsCallback callback) {
+    stats_callback_ = std::move(callback);
+}
+
+void VideoProcessingThread::SetDeliveryPolicy(DeliveryPolicy policy, size_t capacity) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = policy;
+        capacity_ = (policy == DeliveryPolicy::kLatest || capacity == 0) ? 1 : capacity;
+
+        while (task_queue_.size() > capacity_) {
+            task_queue_.pop_front();
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    space_condition_.notify_all();
+}
+
+VideoProcessingStats VideoProcessingThread::GetStats() const {
+    VideoProcessingStats stats;
+    stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.sent = sent_.load(std::memory_order_relaxed);
+    stats.skipped = skipped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void VideoProcessingThread::AddTask(const VideoProcessingTask& task) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!stop_thread_) {
-        task_queue_.push(task);
-        condition_.notify_one();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        return;
     }
+
+    if (policy_ == DeliveryPolicy::kBlock) {
+        // Apply backpressure on the producer until the driver catches up.
+        space_condition_.wait(lock, [this] { return task_queue_.size() < capacity_ || !running_; });
+        if (!running_) {
+            return;
+        }
+    }
+
+    // Drop stale frames so the virtual camera never lags more than capacity_ frames.
+    while (task_queue_.size() >= capacity_) {
+        task_queue_.pop_front();
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    task_queue_.push_back(task);
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    condition_.notify_one();
 }
 
 void VideoProcessingThread::ProcessingLoop() {
+    auto last_report = std::chrono::steady_clock::now();
+    uint64_t last_delivered = delivered_.load(std::memory_order_relaxed);
+    uint64_t last_dropped = dropped_.load(std::memory_order_relaxed);
+
     while (!stop_thread_) {
         std::unique_lock<std::mutex> lock(mutex_);
 
-        // Wait for a task to be added to the queue
-        condition_.wait(lock, [] { return !task_queue_.empty() || stop_thread_; });
+        // Wait for a task to be added to the queue, waking up
+        // periodically so stats are reported while frames are dropped.
+        const bool has_task = condition_.wait_for(lock, kStatsInterval,
+            [this] { return !task_queue_.empty() || stop_thread_; });
 
         // Check if the thread is being stopped
         if (stop_thread_) {
             break;
         }
 
-        // Retrieve and process the task
-        const VideoProcessingTask task = task_queue_.front();
-        task_queue_.pop();
-
-        lock.unlock();  // Release the lock after fetching task
-
-        // Send frame buffer to virtual camera driver using DriverInterface.
-        const int status = DriverInterface::SendBuffer(task.buffer, static_cast<int>(task.width), static_cast<int>(task.height));
-
-        if (status != status_ && error_callback_) {
-            switch (status)
-            {
-            case -1:
-                error_callback_("DriverInterface::SetBuffer Error: No active device.");
-                break;
-            case 0:
-                error_callback_("DriverInterface::SetBuffer Error: Buffer too large.");
-                break;
-            case 2:
-                error_callback_("");  // on success.
-                break;
-            default:
-                break;
+        if (has_task) {
+            // Retrieve and process the task
+            const VideoProcessingTask task = std::move(task_queue_.front());
+            task_queue_.pop_front();
+
+            lock.unlock();  // Release the lock after fetching task
+            space_condition_.notify_one();
+
+            int status = send_(task);
+            delivered_.fetch_add(1, std::memory_order_relaxed);
+            if (status == 1 || status == 2) {
+                sent_.fetch_add(1, std::memory_order_relaxed);
+                status = 2;  // a frame-skip warning is still a success.
+            } else if (status == -2) {
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // A skip means nobody wants a frame, which neither raises nor
+            // clears an error.
+            if (status != -2 && status != status_ && error_callback_) {
+                switch (status)
+                {
+                case -1:
+                    error_callback_("DriverInterface::SetBuffer Error: No active device.");
+                    break;
+                case 0:
+                    error_callback_("DriverInterface::SetBuffer Error: Buffer too large.");
+                    break;
+                case 2:
+                    error_callback_("");  // on success.
+                    break;
+                default:
+                    break;
+                }
+                status_ = status;
             }
-            status_ = status;
+        } else {
+            lock.unlock();
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_report < kStatsInterval || !stats_callback_) {
+            continue;
+        }
+
+        const VideoProcessingStats stats = GetStats();
+        if (stats.delivered != last_delivered || stats.dropped != last_dropped) {
+            stats_callback_(stats);
+            last_delivered = stats.delivered;
+            last_dropped = stats.dropped;
         }
+        last_report = now;
     }
 }
 
-}  // namespace driver_interface
\ No newline at end of file
+}  // namespace driver_interface
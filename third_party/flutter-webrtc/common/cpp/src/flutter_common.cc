@@ -1,5 +1,10 @@
 #include "flutter_common.h"
 
+#include <atomic>
+#include <iostream>
+
+#include "flutter_event_bus.h"
+
 class MethodCallProxyImpl : public MethodCallProxy {
  public:
   explicit MethodCallProxyImpl(const MethodCall& method_call)
@@ -65,11 +70,17 @@ std::unique_ptr<MethodResultProxy> MethodResultProxy::Create(
   return std::make_unique<MethodResultProxyImpl>(std::move(method_result));
 }
 
-class EventChannelProxyImpl : public EventChannelProxy {
+// Cached events per channel while nothing listens.
+constexpr size_t kMaxCachedEvents = 256;
+
+// The platform thread side of an EventChannelProxyImpl, it outlives the
+// proxy for as long as the EventBus is delivering to it.
+class EventChannelTarget : public flutter_webrtc_plugin::EventBusTarget {
  public:
-  EventChannelProxyImpl(BinaryMessenger* messenger,
-                        const std::string& channelName)
-      : channel_(std::make_unique<EventChannel>(
+  EventChannelTarget(BinaryMessenger* messenger,
+                     const std::string& channelName)
+      : channel_name_(channelName),
+        channel_(std::make_unique<EventChannel>(
             messenger,
             channelName,
             &flutter::StandardMethodCodec::GetInstance())) {
@@ -79,8 +90,9 @@ class EventChannelProxyImpl : public EventChannelProxy {
             std::unique_ptr<flutter::EventSink<EncodableValue>>&& events)
             -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
           sink_ = std::move(events);
+          ReportDroppedEvents();
           for (auto& event : event_queue_) {
-            sink_->Success(event);
+            sink_->Success(event.second);
           }
           event_queue_.clear();
           on_listen_called_ = true;
@@ -95,23 +107,86 @@ class EventChannelProxyImpl : public EventChannelProxy {
     channel_->SetStreamHandler(std::move(handler));
   }
 
-  virtual ~EventChannelProxyImpl() {}
+  ~EventChannelTarget() { ReportDroppedEvents(); }
 
-  void Success(const EncodableValue& event, bool cache_event = true) override {
+  void Deliver(const std::string& key,
+               EncodableValue event,
+               bool cache_event) override {
     if (on_listen_called_) {
       sink_->Success(event);
-    } else {
-      if (cache_event) {
-        event_queue_.push_back(event);
+      return;
+    }
+    if (!cache_event) {
+      return;
+    }
+    if (!key.empty()) {
+      for (auto it = event_queue_.begin(); it != event_queue_.end(); ++it) {
+        if (it->first == key) {
+          event_queue_.erase(it);
+          break;
+        }
       }
     }
+    if (event_queue_.size() == kMaxCachedEvents) {
+      event_queue_.pop_front();
+      dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+    event_queue_.emplace_back(key, std::move(event));
+  }
+
+  uint64_t dropped_events() const {
+    return dropped_events_.load(std::memory_order_relaxed);
   }
 
  private:
+  // Logs the events dropped since the last report, when a listener attaches
+  // and when the channel goes away without one.
+  void ReportDroppedEvents() {
+    const uint64_t dropped = dropped_events();
+    if (dropped != reported_dropped_events_) {
+      std::cerr << "EventChannel " << channel_name_ << ": dropped "
+                << dropped - reported_dropped_events_
+                << " events while nothing listened" << std::endl;
+      reported_dropped_events_ = dropped;
+    }
+  }
+
+  std::string channel_name_;
   std::unique_ptr<EventChannel> channel_;
   std::unique_ptr<EventSink> sink_;
-  std::list<EncodableValue> event_queue_;
+  // Coalescing key and event.
+  std::list<std::pair<std::string, EncodableValue>> event_queue_;
   bool on_listen_called_ = false;
+  std::atomic<uint64_t> dropped_events_{0};
+  uint64_t reported_dropped_events_ = 0;
+};
+
+class EventChannelProxyImpl : public EventChannelProxy {
+ public:
+  EventChannelProxyImpl(BinaryMessenger* messenger,
+                        const std::string& channelName)
+      : target_(std::make_shared<EventChannelTarget>(messenger, channelName)) {
+  }
+
+  virtual ~EventChannelProxyImpl() {}
+
+  void Success(const EncodableValue& event, bool cache_event = true) override {
+    flutter_webrtc_plugin::EventBus::Post(target_, std::string(), event,
+                                          cache_event);
+  }
+
+  void Coalesce(const std::string& key,
+                const EncodableValue& event,
+                bool cache_event = true) override {
+    flutter_webrtc_plugin::EventBus::Post(target_, key, event, cache_event);
+  }
+
+  uint64_t dropped_events() const override {
+    return target_->dropped_events();
+  }
+
+ private:
+  std::shared_ptr<EventChannelTarget> target_;
 };
 
 std::unique_ptr<EventChannelProxy> EventChannelProxy::Create(
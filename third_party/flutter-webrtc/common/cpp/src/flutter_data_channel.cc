@@ -1,19 +1,79 @@
 #include "flutter_data_channel.h"
 
+#include <cstring>
 #include <vector>
 
+#include "flutter_event_bus.h"
+
 namespace flutter_webrtc_plugin {
 
+// Sends received frames on the platform thread, where the messenger may be
+// used. Going through the EventBus also keeps frames behind the events
+// queued before Dart attached.
+class DataChannelFrameTarget : public EventBusTarget {
+ public:
+  DataChannelFrameTarget(BinaryMessenger* messenger,
+                         const std::string& channel_name)
+      : messenger_(messenger), channel_name_(channel_name) {}
+
+  void Deliver(const std::string& key,
+               EncodableValue event,
+               bool cache_event) override {
+    const auto* frame = std::get_if<std::vector<uint8_t>>(&event);
+    if (frame) {
+      messenger_->Send(channel_name_, frame->data(), frame->size());
+    }
+  }
+
+ private:
+  BinaryMessenger* messenger_;
+  std::string channel_name_;
+};
+
 FlutterRTCDataChannelObserver::FlutterRTCDataChannelObserver(
     scoped_refptr<RTCDataChannel> data_channel,
     BinaryMessenger* messenger,
-    const std::string& channelName)
+    const std::string& channelName,
+    const std::string& frameChannelName)
     : event_channel_(EventChannelProxy::Create(messenger, channelName)),
-      data_channel_(data_channel) {
+      data_channel_(data_channel),
+      messenger_(messenger),
+      frame_channel_name_(frameChannelName),
+      frame_target_(std::make_shared<DataChannelFrameTarget>(
+          messenger,
+          frameChannelName)) {
+  messenger_->SetMessageHandler(
+      frame_channel_name_,
+      [this](const uint8_t* message, size_t message_size,
+             flutter::BinaryReply reply) {
+        OnFrame(message, message_size);
+        reply(nullptr, 0);
+      });
   data_channel_->RegisterObserver(this);
 }
 
-FlutterRTCDataChannelObserver::~FlutterRTCDataChannelObserver() {}
+FlutterRTCDataChannelObserver::~FlutterRTCDataChannelObserver() {
+  messenger_->SetMessageHandler(frame_channel_name_, nullptr);
+}
+
+void FlutterRTCDataChannelObserver::OnFrame(const uint8_t* frame,
+                                            size_t size) {
+  if (size < kDataChannelFrameHeaderSize) {
+    return;
+  }
+  switch (frame[0]) {
+    case kDataChannelFrameBinary:
+    case kDataChannelFrameText:
+      data_channel_->Send(
+          frame + kDataChannelFrameHeaderSize,
+          static_cast<uint32_t>(size - kDataChannelFrameHeaderSize),
+          frame[0] == kDataChannelFrameBinary);
+      break;
+    case kDataChannelFrameAttach:
+      frames_attached_ = true;
+      break;
+  }
+}
 
 void FlutterDataChannel::CreateDataChannel(
     const std::string& peerConnectionId,
@@ -51,10 +111,12 @@ void FlutterDataChannel::CreateDataChannel(
   std::string uuid = base_->GenerateUUID();
   std::string event_channel =
       "FlutterWebRTC/dataChannelEvent" + peerConnectionId + uuid;
+  std::string frame_channel =
+      "FlutterWebRTC/dataChannelFrame" + peerConnectionId + uuid;
 
   std::unique_ptr<FlutterRTCDataChannelObserver> observer(
       new FlutterRTCDataChannelObserver(data_channel, base_->messenger_,
-                                        event_channel));
+                                        event_channel, frame_channel));
 
   base_->lock();
   base_->data_channel_observers_[uuid] = std::move(observer);
@@ -74,12 +136,12 @@ void FlutterDataChannel::DataChannelSend(
     const EncodableValue& data,
     std::unique_ptr<MethodResultProxy> result) {
   bool is_binary = type == "binary";
-  if (is_binary && TypeIs<std::vector<uint8_t>>(data)) {
-    std::vector<uint8_t> buffer = GetValue<std::vector<uint8_t>>(data);
-    data_channel->Send(buffer.data(), static_cast<uint32_t>(buffer.size()),
-                       true);
+  const uint8_t* bytes = nullptr;
+  size_t size = 0;
+  if (is_binary && GetBytes(data, &bytes, &size)) {
+    data_channel->Send(bytes, static_cast<uint32_t>(size), true);
   } else {
-    std::string str = GetValue<std::string>(data);
+    const std::string& str = std::get<std::string>(data);
     data_channel->Send(reinterpret_cast<const uint8_t*>(str.c_str()),
                        static_cast<uint32_t>(str.length()), false);
   }
@@ -134,15 +196,24 @@ void FlutterRTCDataChannelObserver::OnStateChange(RTCDataChannelState state) {
 void FlutterRTCDataChannelObserver::OnMessage(const char* buffer,
                                               int length,
                                               bool binary) {
+  if (frames_attached_) {
+    std::vector<uint8_t> frame(kDataChannelFrameHeaderSize + length);
+    frame[0] = binary ? kDataChannelFrameBinary : kDataChannelFrameText;
+    memcpy(frame.data() + kDataChannelFrameHeaderSize, buffer, length);
+    EventBus::Post(frame_target_, std::string(),
+                   EncodableValue(std::move(frame)), true);
+    return;
+  }
+
   EncodableMap params;
   params[EncodableValue("event")] = EncodableValue("dataChannelReceiveMessage");
 
   params[EncodableValue("id")] = EncodableValue(data_channel_->id());
   params[EncodableValue("type")] = EncodableValue(binary ? "binary" : "text");
-  std::string str(buffer, length);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
   params[EncodableValue("data")] =
-      binary ? EncodableValue(std::vector<uint8_t>(str.begin(), str.end()))
-             : EncodableValue(str);
+      binary ? EncodableValue(std::vector<uint8_t>(bytes, bytes + length))
+             : EncodableValue(std::string(buffer, length));
 
   auto data = EncodableValue(params);
   event_channel_->Success(data);
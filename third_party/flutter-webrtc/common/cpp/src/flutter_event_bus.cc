@@ -0,0 +1,203 @@
+#include "flutter_event_bus.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WINDOWS)
+#include <windows.h>
+#else
+#include <glib.h>
+#endif
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+struct Node {
+  std::atomic<Node*> next{nullptr};
+  std::weak_ptr<EventBusTarget> target;
+  std::string key;
+  EncodableValue event;
+  bool cache_event = true;
+};
+
+// Intrusive MPSC queue after Dmitry Vyukov's design. Push is wait-free,
+// Pop is only called by the platform thread and returns null both when the
+// queue is empty and while a producer is between its two steps of Push.
+class NodeQueue {
+ public:
+  NodeQueue() : head_(&stub_), tail_(&stub_) {}
+
+  void Push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  Node* Pop() {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    Push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  bool Empty() const {
+    return tail_ == &stub_ &&
+           stub_.next.load(std::memory_order_acquire) == nullptr &&
+           head_.load(std::memory_order_acquire) == &stub_;
+  }
+
+ private:
+  std::atomic<Node*> head_;
+  Node* tail_;
+  Node stub_;
+};
+
+NodeQueue g_queue;
+std::atomic<bool> g_started{false};
+std::atomic<bool> g_drain_scheduled{false};
+std::thread::id g_platform_thread;
+
+void Drain();
+
+#if defined(_WINDOWS)
+constexpr UINT kDrainMessage = WM_APP + 1;
+HWND g_window = nullptr;
+
+LRESULT CALLBACK EventBusWindowProc(HWND window,
+                                    UINT message,
+                                    WPARAM wparam,
+                                    LPARAM lparam) {
+  if (message == kDrainMessage) {
+    Drain();
+    return 0;
+  }
+  return DefWindowProc(window, message, wparam, lparam);
+}
+
+// A message-only window, its messages are dispatched by the platform
+// thread's message loop.
+void CreateDrainWindow() {
+  const wchar_t* kClassName = L"FlutterWebRTCEventBus";
+  WNDCLASSW window_class = {};
+  window_class.lpfnWndProc = EventBusWindowProc;
+  window_class.hInstance = GetModuleHandle(nullptr);
+  window_class.lpszClassName = kClassName;
+  RegisterClassW(&window_class);
+  g_window = CreateWindowExW(0, kClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE,
+                             nullptr, window_class.hInstance, nullptr);
+}
+
+void ScheduleDrain() {
+  PostMessage(g_window, kDrainMessage, 0, 0);
+}
+#else
+gboolean DrainSource(gpointer) {
+  Drain();
+  return G_SOURCE_REMOVE;
+}
+
+void ScheduleDrain() {
+  g_idle_add(DrainSource, nullptr);
+}
+#endif
+
+void Drain() {
+  g_drain_scheduled.store(false, std::memory_order_release);
+
+  std::vector<std::unique_ptr<Node>> batch;
+  while (Node* node = g_queue.Pop()) {
+    batch.emplace_back(node);
+  }
+
+  // Walking back, the first event seen for a target and key is the newest.
+  std::vector<std::shared_ptr<EventBusTarget>> targets(batch.size());
+  std::set<std::pair<EventBusTarget*, std::string>> newest;
+  std::vector<bool> superseded(batch.size(), false);
+  for (size_t i = batch.size(); i-- > 0;) {
+    targets[i] = batch[i]->target.lock();
+    if (!targets[i]) {
+      continue;
+    }
+    if (!batch[i]->key.empty()) {
+      superseded[i] = !newest.emplace(targets[i].get(), batch[i]->key).second;
+    }
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (targets[i] && !superseded[i]) {
+      targets[i]->Deliver(batch[i]->key, std::move(batch[i]->event),
+                          batch[i]->cache_event);
+    }
+  }
+
+  // A producer was mid-push when the queue looked empty, come back for it.
+  if (!g_queue.Empty() &&
+      !g_drain_scheduled.exchange(true, std::memory_order_acq_rel)) {
+    ScheduleDrain();
+  }
+}
+
+}  // namespace
+
+void EventBus::Start() {
+  if (g_started.load(std::memory_order_acquire)) {
+    return;
+  }
+  g_platform_thread = std::this_thread::get_id();
+#if defined(_WINDOWS)
+  CreateDrainWindow();
+#endif
+  g_started.store(true, std::memory_order_release);
+}
+
+void EventBus::Post(std::weak_ptr<EventBusTarget> target,
+                    std::string key,
+                    EncodableValue event,
+                    bool cache_event) {
+  if (!g_started.load(std::memory_order_acquire) ||
+      std::this_thread::get_id() == g_platform_thread) {
+    if (g_started.load(std::memory_order_relaxed)) {
+      Drain();
+    }
+    if (auto locked = target.lock()) {
+      locked->Deliver(key, std::move(event), cache_event);
+    }
+    return;
+  }
+
+  Node* node = new Node();
+  node->target = std::move(target);
+  node->key = std::move(key);
+  node->event = std::move(event);
+  node->cache_event = cache_event;
+  g_queue.Push(node);
+  if (!g_drain_scheduled.exchange(true, std::memory_order_acq_rel)) {
+    ScheduleDrain();
+  }
+}
+
+}  // namespace flutter_webrtc_plugin
@@ -3,74 +3,118 @@
 #endif
 
 #include "flutter_frame_capturer.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include "svpng.hpp"
+#include <thread>
+#include "snapshot_encoder.h"
 
 namespace flutter_webrtc_plugin {
 
-FlutterFrameCapturer::FlutterFrameCapturer(RTCVideoTrack* track,
-                                           std::string path) {
-  track_ = track;
-  path_ = path;
+void FlutterFrameCapturer::Capture(RTCVideoTrack* track,
+                                   const std::string& path,
+                                   size_t count,
+                                   std::chrono::milliseconds timeout,
+                                   std::unique_ptr<MethodResultProxy> result) {
+  // Uses new instead of make_shared due to private constructor.
+  std::shared_ptr<FlutterFrameCapturer> capturer(
+      new FlutterFrameCapturer(path, count));
+
+  scoped_refptr<FrameFanoutHub> hub = FrameFanoutHub::ForTrack(track);
+  hub->AddSink(capturer.get(), FrameSinkOptions());
+
+  std::thread([capturer, hub, timeout, result = std::move(result)]() mutable {
+    capturer->Run(hub, timeout, std::move(result));
+  }).detach();
 }
 
-void FlutterFrameCapturer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
-  if (frame_ != nullptr) {
+FlutterFrameCapturer::FlutterFrameCapturer(const std::string& path,
+                                           size_t count)
+    : path_(path), count_(count) {
+  frames_.reserve(count_);
+}
+
+void FlutterFrameCapturer::OnFrame(const HubFrame& hub_frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (frames_.size() == count_) {
     return;
   }
 
-  frame_ = frame.get()->Copy();
-  catch_frame_ = true;
+  frames_.push_back(hub_frame.frame);
+  if (frames_.size() == count_) {
+    frames_ready_.notify_one();
+  }
 }
 
-void FlutterFrameCapturer::CaptureFrame(
-    std::unique_ptr<MethodResultProxy> result) {
-  mutex_.lock();
-  // Here init catch_frame_ flag
-  catch_frame_ = false;
-
-  track_->AddRenderer(this);
-  // Here waiting for catch_frame_ is set to true
-  while(!catch_frame_){}
-  // Here unlock the mutex
-  mutex_.unlock();
-
-  mutex_.lock();
-  track_->RemoveRenderer(this);
+void FlutterFrameCapturer::Run(scoped_refptr<FrameFanoutHub> hub,
+                               std::chrono::milliseconds timeout,
+                               std::unique_ptr<MethodResultProxy> result) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    frames_ready_.wait_for(lock, timeout,
+                           [this] { return frames_.size() == count_; });
+  }
+  // OnFrame isn't called anymore once this returns, |frames_| is ours.
+  hub->RemoveSink(this);
+  hub = nullptr;
 
-  bool success = SaveFrame();
-  mutex_.unlock();
+  if (frames_.empty()) {
+    result->Error("captureFrame",
+                  "captureFrame() timed out waiting for a frame");
+    return;
+  }
 
-  std::shared_ptr<MethodResultProxy> result_ptr(result.release());
-  if (success) {
-    result_ptr->Success();
-  } else {
-    result_ptr->Error("1", "Cannot save the frame as .png file");
+  EncodableList saved;
+  for (size_t i = 0; i < frames_.size(); i++) {
+    std::string path = FramePath(i);
+    if (!SaveFrame(frames_[i], path)) {
+      result->Error("1", "Cannot save the frame to " + path);
+      return;
+    }
+    EncodableMap info;
+    info[EncodableValue("path")] = EncodableValue(path);
+    info[EncodableValue("width")] = EncodableValue(frames_[i]->width());
+    info[EncodableValue("height")] = EncodableValue(frames_[i]->height());
+    saved.push_back(EncodableValue(info));
   }
+  result->Success(EncodableValue(saved));
 }
 
-bool FlutterFrameCapturer::SaveFrame() {
-  if (frame_ == nullptr) {
-    return false;
+std::string FlutterFrameCapturer::FramePath(size_t index) const {
+  if (count_ == 1) {
+    return path_;
   }
+  size_t dot = path_.find_last_of('.');
+  size_t separator = path_.find_last_of("/\\");
+  if (dot == std::string::npos ||
+      (separator != std::string::npos && dot < separator)) {
+    dot = path_.size();
+  }
+  return path_.substr(0, dot) + "_" + std::to_string(index) +
+         path_.substr(dot);
+}
 
-  int width = frame_.get()->width();
-  int height = frame_.get()->height();
-  int bytes_per_pixel = 4;
-  uint8_t* pixels = new uint8_t[width * height * bytes_per_pixel];
-
-  frame_.get()->ConvertToARGB(RTCVideoFrame::Type::kABGR, pixels,
-                              /* unused */ -1, width, height);
-
-  FILE* file = fopen(path_.c_str(), "wb");
-  if (!file) {
-    return false;
+bool FlutterFrameCapturer::SaveFrame(const scoped_refptr<RTCVideoFrame>& frame,
+                                     const std::string& path) {
+  int width = frame->width();
+  int height = frame->height();
+  std::vector<uint8_t> data;
+
+  if (SnapshotFormatForPath(path.c_str()) == SnapshotFormat::kI420) {
+    if (PackI420(frame->DataY(), frame->StrideY(), frame->DataU(),
+                 frame->StrideU(), frame->DataV(), frame->StrideV(), width,
+                 height, &data) != 0) {
+      return false;
+    }
+  } else {
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    frame->ConvertToARGB(RTCVideoFrame::Type::kABGR, pixels.data(),
+                         /* unused */ -1, width, height);
+    // Camera frames are opaque, the alpha channel is dropped.
+    if (EncodePng(pixels.data(), width * 4, width, height, false, &data) !=
+        0) {
+      return false;
+    }
   }
 
-  svpng(file, width, height, pixels, 1);
-  fclose(file);
-  return true;
+  return WriteSnapshotFile(path.c_str(), data) == 0;
 }
 
-}  // namespace flutter_webrtc_plugin
\ No newline at end of file
+}  // namespace flutter_webrtc_plugin
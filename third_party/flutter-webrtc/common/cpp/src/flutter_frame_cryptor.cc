@@ -48,75 +48,63 @@ void FlutterFrameCryptorObserver::OnFrameCryptionStateChanged(
 
 bool FlutterFrameCryptor::HandleFrameCryptorMethodCall(
     const MethodCallProxy& method_call,
-    std::unique_ptr<MethodResultProxy> result) {
-  const std::string& method_name = method_call.method_name();
-  if (!method_call.arguments()) {
+    std::unique_ptr<MethodResultProxy>& result) {
+  using Handler = void (FlutterFrameCryptor::*)(
+      const EncodableMap& constraints,
+      std::unique_ptr<MethodResultProxy> result);
+  static const std::unordered_map<std::string, Handler> methods = {
+      {"frameCryptorFactoryCreateFrameCryptor",
+       &FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor},
+      {"frameCryptorSetKeyIndex",
+       &FlutterFrameCryptor::FrameCryptorSetKeyIndex},
+      {"frameCryptorGetKeyIndex",
+       &FlutterFrameCryptor::FrameCryptorGetKeyIndex},
+      {"frameCryptorSetEnabled", &FlutterFrameCryptor::FrameCryptorSetEnabled},
+      {"frameCryptorGetEnabled", &FlutterFrameCryptor::FrameCryptorGetEnabled},
+      {"frameCryptorDispose", &FlutterFrameCryptor::FrameCryptorDispose},
+      {"frameCryptorFactoryCreateKeyProvider",
+       &FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider},
+      {"keyProviderSetSharedKey",
+       &FlutterFrameCryptor::KeyProviderSetSharedKey},
+      {"keyProviderRatchetSharedKey",
+       &FlutterFrameCryptor::KeyProviderRatchetSharedKey},
+      {"keyProviderExportSharedKey",
+       &FlutterFrameCryptor::KeyProviderExportSharedKey},
+      {"keyProviderSetKey", &FlutterFrameCryptor::KeyProviderSetKey},
+      {"keyProviderRatchetKey", &FlutterFrameCryptor::KeyProviderRatchetKey},
+      {"keyProviderExportKey", &FlutterFrameCryptor::KeyProviderExportKey},
+      {"keyProviderSetSifTrailer",
+       &FlutterFrameCryptor::KeyProviderSetSifTrailer},
+      {"keyProviderDispose", &FlutterFrameCryptor::KeyProviderDispose},
+  };
+
+  auto it = methods.find(method_call.method_name());
+  if (it == methods.end()) {
+    return false;
+  }
+
+  const EncodableValue* arguments = method_call.arguments();
+  const EncodableMap* params =
+      arguments ? std::get_if<EncodableMap>(arguments) : nullptr;
+  if (params == nullptr) {
     result->Error("Bad Arguments", "Null arguments received");
     return true;
   }
-  const EncodableMap params = GetValue<EncodableMap>(*method_call.arguments());
-
-  if (method_name == "frameCryptorFactoryCreateFrameCryptor") {
-    FrameCryptorFactoryCreateFrameCryptor(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetKeyIndex") {
-    FrameCryptorSetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetKeyIndex") {
-    FrameCryptorGetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetEnabled") {
-    FrameCryptorSetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetEnabled") {
-    FrameCryptorGetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorDispose") {
-    FrameCryptorDispose(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorFactoryCreateKeyProvider") {
-    FrameCryptorFactoryCreateKeyProvider(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderSetSharedKey") {
-    KeyProviderSetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetSharedKey") {
-    KeyProviderRatchetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportSharedKey") {
-    KeyProviderExportSharedKey(params, std::move(result));
-    return true;
-  }else if (method_name == "keyProviderSetKey") {
-    KeyProviderSetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetKey") {
-    KeyProviderRatchetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportKey") {
-    KeyProviderExportKey(params, std::move(result));
-    return true;
-  }  else if (method_name == "keyProviderSetSifTrailer") {
-    KeyProviderSetSifTrailer(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderDispose") {
-    KeyProviderDispose(params, std::move(result));
-    return true;
-  }
-
-  return false;
+  (this->*it->second)(*params, std::move(result));
+  return true;
 }
 
 void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto type = findString(constraints, "type");
+  const auto& type = findStringRef(constraints, "type");
   if (type == std::string()) {
     result->Error("FrameCryptorFactoryCreateFrameCryptorFailed",
                   "type is null");
     return;
   }
 
-  auto peerConnectionId = findString(constraints, "peerConnectionId");
+  const auto& peerConnectionId = findStringRef(constraints, "peerConnectionId");
   if (peerConnectionId == std::string()) {
     result->Error("FrameCryptorFactoryCreateFrameCryptorFailed",
                   "peerConnectionId is null");
@@ -131,8 +119,8 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
     return;
   }
 
-  auto rtpSenderId = findString(constraints, "rtpSenderId");
-  auto rtpReceiverId = findString(constraints, "rtpReceiverId");
+  const auto& rtpSenderId = findStringRef(constraints, "rtpSenderId");
+  const auto& rtpReceiverId = findStringRef(constraints, "rtpReceiverId");
 
   if (rtpReceiverId == std::string() && rtpSenderId == std::string()) {
     result->Error("FrameCryptorFactoryCreateFrameCryptorFailed",
@@ -141,8 +129,8 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
   }
 
   auto algorithm = findInt(constraints, "algorithm");
-  auto participantId = findString(constraints, "participantId");
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& participantId = findStringRef(constraints, "participantId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
 
   if (type == "sender") {
     auto sender = base_->GetRtpSenderById(pc, rtpSenderId);
@@ -209,7 +197,7 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
 void FlutterFrameCryptor::FrameCryptorSetKeyIndex(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto frameCryptorId = findString(constraints, "frameCryptorId");
+  const auto& frameCryptorId = findStringRef(constraints, "frameCryptorId");
   if (frameCryptorId == std::string()) {
     result->Error("FrameCryptorGetKeyIndexFailed", "frameCryptorId is null");
     return;
@@ -229,7 +217,7 @@ void FlutterFrameCryptor::FrameCryptorSetKeyIndex(
 void FlutterFrameCryptor::FrameCryptorGetKeyIndex(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto frameCryptorId = findString(constraints, "frameCryptorId");
+  const auto& frameCryptorId = findStringRef(constraints, "frameCryptorId");
   if (frameCryptorId == std::string()) {
     result->Error("FrameCryptorGetKeyIndexFailed", "frameCryptorId is null");
     return;
@@ -247,7 +235,7 @@ void FlutterFrameCryptor::FrameCryptorGetKeyIndex(
 void FlutterFrameCryptor::FrameCryptorSetEnabled(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto frameCryptorId = findString(constraints, "frameCryptorId");
+  const auto& frameCryptorId = findStringRef(constraints, "frameCryptorId");
   if (frameCryptorId == std::string()) {
     result->Error("FrameCryptorSetEnabledFailed", "frameCryptorId is null");
     return;
@@ -267,7 +255,7 @@ void FlutterFrameCryptor::FrameCryptorSetEnabled(
 void FlutterFrameCryptor::FrameCryptorGetEnabled(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto frameCryptorId = findString(constraints, "frameCryptorId");
+  const auto& frameCryptorId = findStringRef(constraints, "frameCryptorId");
   if (frameCryptorId == std::string()) {
     result->Error("FrameCryptorGetEnabledFailed", "frameCryptorId is null");
     return;
@@ -285,7 +273,7 @@ void FlutterFrameCryptor::FrameCryptorGetEnabled(
 void FlutterFrameCryptor::FrameCryptorDispose(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto frameCryptorId = findString(constraints, "frameCryptorId");
+  const auto& frameCryptorId = findStringRef(constraints, "frameCryptorId");
   if (frameCryptorId == std::string()) {
     result->Error("FrameCryptorDisposeFailed", "frameCryptorId is null");
     return;
@@ -309,7 +297,7 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider(
   libwebrtc::KeyProviderOptions options;
   
 
-  auto keyProviderOptions = findMap(constraints, "keyProviderOptions");
+  const auto& keyProviderOptions = findMapRef(constraints, "keyProviderOptions");
   if (keyProviderOptions == EncodableMap()) {
     result->Error("FrameCryptorFactoryCreateKeyProviderFailed", "keyProviderOptions is null");
     return;
@@ -319,12 +307,12 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider(
   options.shared_key = sharedKey;
 
 
-  auto uncryptedMagicBytes = findVector(keyProviderOptions, "uncryptedMagicBytes");
+  const auto& uncryptedMagicBytes = findVectorRef(keyProviderOptions, "uncryptedMagicBytes");
   if (uncryptedMagicBytes.size() != 0) {
     options.uncrypted_magic_bytes = uncryptedMagicBytes;
   }
 
-  auto ratchetSalt = findVector(keyProviderOptions, "ratchetSalt");
+  const auto& ratchetSalt = findVectorRef(keyProviderOptions, "ratchetSalt");
   if (ratchetSalt.size() == 0) {
     result->Error("FrameCryptorFactoryCreateKeyProviderFailed",
                   "ratchetSalt is null");
@@ -360,7 +348,7 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider(
 
 void FlutterFrameCryptor::KeyProviderSetSharedKey(const EncodableMap& constraints,
                       std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderSetSharedKeyFailed", "keyProviderId is null");
     return;
@@ -372,7 +360,7 @@ void FlutterFrameCryptor::KeyProviderSetSharedKey(const EncodableMap& constraint
     return;
   }
 
-  auto key = findVector(constraints, "key");
+  const auto& key = findVectorRef(constraints, "key");
   if (key.size() == 0) {
     result->Error("KeyProviderSetSharedKeyFailed", "key is null");
     return;
@@ -393,7 +381,7 @@ void FlutterFrameCryptor::KeyProviderSetSharedKey(const EncodableMap& constraint
 
 void FlutterFrameCryptor::KeyProviderRatchetSharedKey(const EncodableMap& constraints,
                        std::unique_ptr<MethodResultProxy> result) {
- auto keyProviderId = findString(constraints, "keyProviderId");
+ const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderRatchetSharedKeyFailed", "keyProviderId is null");
     return;
@@ -420,7 +408,7 @@ void FlutterFrameCryptor::KeyProviderRatchetSharedKey(const EncodableMap& constr
 
 void FlutterFrameCryptor::KeyProviderExportSharedKey(const EncodableMap& constraints,
                       std::unique_ptr<MethodResultProxy> result) {
-auto keyProviderId = findString(constraints, "keyProviderId");
+const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderExportSharedKeyFailed", "keyProviderId is null");
     return;
@@ -447,7 +435,7 @@ auto keyProviderId = findString(constraints, "keyProviderId");
 
 void FlutterFrameCryptor::KeyProviderExportKey(const EncodableMap& constraints,
                       std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderExportKeyFailed", "keyProviderId is null");
     return;
@@ -459,7 +447,7 @@ void FlutterFrameCryptor::KeyProviderExportKey(const EncodableMap& constraints,
     return;
   }
 
-  auto participant_id = findString(constraints, "participantId");
+  const auto& participant_id = findStringRef(constraints, "participantId");
   if (participant_id == std::string()) {
     result->Error("KeyProviderExportKeyFailed", "participantId is null");
     return;
@@ -480,7 +468,7 @@ void FlutterFrameCryptor::KeyProviderExportKey(const EncodableMap& constraints,
 
 void FlutterFrameCryptor::KeyProviderSetSifTrailer(const EncodableMap& constraints,
                        std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderSetSifTrailerFailed", "keyProviderId is null");
     return;
@@ -492,7 +480,7 @@ void FlutterFrameCryptor::KeyProviderSetSifTrailer(const EncodableMap& constrain
     return;
   }
 
-  auto sifTrailer = findVector(constraints, "sifTrailer");
+  const auto& sifTrailer = findVectorRef(constraints, "sifTrailer");
   if (sifTrailer.size() == 0) {
     result->Error("KeyProviderSetSifTrailerFailed", "sifTrailer is null");
     return;
@@ -507,7 +495,7 @@ void FlutterFrameCryptor::KeyProviderSetSifTrailer(const EncodableMap& constrain
 void FlutterFrameCryptor::KeyProviderSetKey(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderSetKeyFailed", "keyProviderId is null");
     return;
@@ -519,7 +507,7 @@ void FlutterFrameCryptor::KeyProviderSetKey(
     return;
   }
 
-  auto key = findVector(constraints, "key");
+  const auto& key = findVectorRef(constraints, "key");
   if (key.size() == 0) {
     result->Error("KeyProviderSetKeyFailed", "key is null");
     return;
@@ -530,7 +518,7 @@ void FlutterFrameCryptor::KeyProviderSetKey(
     return;
   }
 
-  auto participant_id = findString(constraints, "participantId");
+  const auto& participant_id = findStringRef(constraints, "participantId");
   if (participant_id == std::string()) {
     result->Error("KeyProviderSetKeyFailed", "participantId is null");
     return;
@@ -545,7 +533,7 @@ void FlutterFrameCryptor::KeyProviderSetKey(
 void FlutterFrameCryptor::KeyProviderRatchetKey(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderSetKeysFailed", "keyProviderId is null");
     return;
@@ -557,7 +545,7 @@ void FlutterFrameCryptor::KeyProviderRatchetKey(
     return;
   }
 
-  auto participant_id = findString(constraints, "participantId");
+  const auto& participant_id = findStringRef(constraints, "participantId");
   if (participant_id == std::string()) {
     result->Error("KeyProviderSetKeyFailed", "participantId is null");
     return;
@@ -580,7 +568,7 @@ void FlutterFrameCryptor::KeyProviderRatchetKey(
 void FlutterFrameCryptor::KeyProviderDispose(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  auto keyProviderId = findString(constraints, "keyProviderId");
+  const auto& keyProviderId = findStringRef(constraints, "keyProviderId");
   if (keyProviderId == std::string()) {
     result->Error("KeyProviderDisposeFailed", "keyProviderId is null");
     return;
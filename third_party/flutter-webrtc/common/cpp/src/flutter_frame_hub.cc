@@ -0,0 +1,102 @@
+#include "flutter_frame_hub.h"
+
+#include <algorithm>
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+// Tolerated early arrival when enforcing a sink's frame rate cap, so
+// a 30 fps sink isn't starved by a jittery 30 fps source.
+constexpr auto kFrameJitter = std::chrono::milliseconds(3);
+
+std::mutex hubs_mutex;
+std::map<RTCVideoTrack*, FrameFanoutHub*> hubs;
+
+}  // namespace
+
+scoped_refptr<FrameFanoutHub> FrameFanoutHub::ForTrack(
+    scoped_refptr<RTCVideoTrack> track) {
+  std::lock_guard<std::mutex> lock(hubs_mutex);
+  auto it = hubs.find(track.get());
+  if (it != hubs.end()) {
+    return it->second;
+  }
+  scoped_refptr<FrameFanoutHub> hub = new FrameFanoutHub(track);
+  hubs[track.get()] = hub.get();
+  return hub;
+}
+
+int FrameFanoutHub::AddRef() const {
+  return ref_count_.fetch_add(1) + 1;
+}
+
+int FrameFanoutHub::Release() const {
+  int count;
+  {
+    // Dropping the last reference and leaving the registry happen under
+    // one lock, a concurrent ForTrack() either sees a live hub or none.
+    std::lock_guard<std::mutex> lock(hubs_mutex);
+    count = ref_count_.fetch_sub(1) - 1;
+    if (count == 0) {
+      auto it = hubs.find(track_.get());
+      if (it != hubs.end() && it->second == this) {
+        hubs.erase(it);
+      }
+    }
+  }
+  if (count == 0) {
+    delete this;
+  }
+  return count;
+}
+
+FrameFanoutHub::FrameFanoutHub(scoped_refptr<RTCVideoTrack> track)
+    : track_(track) {
+  track_->AddRenderer(this);
+}
+
+FrameFanoutHub::~FrameFanoutHub() {
+  track_->RemoveRenderer(this);
+}
+
+void FrameFanoutHub::AddSink(FrameSink* sink, const FrameSinkOptions& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(sinks_.begin(), sinks_.end(),
+                         [sink](const SinkEntry& e) { return e.sink == sink; });
+  if (it != sinks_.end()) {
+    it->options = options;
+    return;
+  }
+  sinks_.push_back({sink, options, std::chrono::steady_clock::time_point()});
+}
+
+void FrameFanoutHub::RemoveSink(FrameSink* sink) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sinks_.erase(std::remove_if(sinks_.begin(), sinks_.end(),
+                              [sink](const SinkEntry& e) { return e.sink == sink; }),
+               sinks_.end());
+}
+
+void FrameFanoutHub::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = std::chrono::steady_clock::now();
+
+  HubFrame hub_frame;
+  hub_frame.frame = frame;
+
+  for (SinkEntry& entry : sinks_) {
+    if (entry.options.max_fps > 0) {
+      const auto interval =
+          std::chrono::microseconds(1000000 / entry.options.max_fps);
+      if (now - entry.last_delivery < interval - kFrameJitter) {
+        continue;
+      }
+    }
+
+    entry.last_delivery = now;
+    entry.sink->OnFrame(hub_frame);
+  }
+}
+
+}  // namespace flutter_webrtc_plugin
@@ -351,6 +351,15 @@ void FlutterPeerConnection::RTCPeerConnectionClose(
     RTCPeerConnection* pc,
     const std::string& uuid,
     std::unique_ptr<MethodResultProxy> result) {
+  for (auto it = stats_subscriptions_.begin();
+       it != stats_subscriptions_.end();) {
+    if (it->second->peer_connection_id() == uuid) {
+      it = stats_subscriptions_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
   auto it2 = base_->peerconnections_.find(uuid);
   if (it2 != base_->peerconnections_.end()) {
     it2->second->Close();
@@ -469,22 +478,23 @@ void FlutterPeerConnection::GetRemoteDescription(
 
 scoped_refptr<RTCRtpTransceiverInit>
 FlutterPeerConnection::mapToRtpTransceiverInit(const EncodableMap& params) {
-  EncodableList streamIds = findList(params, "streamIds");
+  const EncodableList& streamIds = findListRef(params, "streamIds");
 
   std::vector<string> stream_ids;
-  for (auto item : streamIds) {
-    std::string id = GetValue<std::string>(item);
-    stream_ids.push_back(id.c_str());
+  for (const EncodableValue& item : streamIds) {
+    if (const std::string* id = std::get_if<std::string>(&item)) {
+      stream_ids.push_back(id->c_str());
+    }
   }
   RTCRtpTransceiverDirection dir = RTCRtpTransceiverDirection::kInactive;
   EncodableValue direction = findEncodableValue(params, "direction");
   if (!direction.IsNull()) {
     dir = stringToTransceiverDirection(GetValue<std::string>(direction));
   }
-  EncodableList sendEncodings = findList(params, "sendEncodings");
+  const EncodableList& sendEncodings = findListRef(params, "sendEncodings");
   std::vector<scoped_refptr<RTCRtpEncodingParameters>> encodings;
-  for (EncodableValue value : sendEncodings) {
-    encodings.push_back(mapToEncoding(GetValue<EncodableMap>(value)));
+  for (const EncodableValue& value : sendEncodings) {
+    encodings.push_back(mapToEncoding(std::get<EncodableMap>(value)));
   }
   scoped_refptr<RTCRtpTransceiverInit> init =
       RTCRtpTransceiverInit::Create(dir, stream_ids, encodings);
@@ -828,9 +838,100 @@ void FlutterPeerConnection::SetConfiguration(
 void FlutterPeerConnection::CaptureFrame(
     RTCVideoTrack* track,
     std::string path,
+    size_t count,
+    std::chrono::milliseconds timeout,
+    std::unique_ptr<MethodResultProxy> result) {
+  FlutterFrameCapturer::Capture(track, path, count, timeout,
+                                std::move(result));
+}
+
+void FlutterPeerConnection::SubscribeStats(
+    const std::string& peer_connection_id,
+    int subscription_id,
+    const EncodableList& fields,
+    std::chrono::milliseconds interval,
+    std::unique_ptr<MethodResultProxy> result) {
+  RTCPeerConnection* pc = base_->PeerConnectionForId(peer_connection_id);
+  if (pc == nullptr) {
+    result->Error("subscribeStats", "subscribeStats() peerConnection is null");
+    return;
+  }
+  if (stats_subscriptions_.find(subscription_id) !=
+      stats_subscriptions_.end()) {
+    result->Error("subscribeStats", "subscription already exists");
+    return;
+  }
+  stats_subscriptions_[subscription_id] = FlutterStatsSubscription::Start(
+      base_->messenger_,
+      "FlutterWebRTC/statsSubscription" + std::to_string(subscription_id),
+      peer_connection_id, pc, fields, interval);
+  result->Success();
+}
+
+void FlutterPeerConnection::UnsubscribeStats(
+    int subscription_id,
+    std::unique_ptr<MethodResultProxy> result) {
+  stats_subscriptions_.erase(subscription_id);
+  result->Success();
+}
+
+static EncodableMap RecorderStatsMap(const VideoRecorderStats& stats) {
+  EncodableMap map;
+  map[EncodableValue("framesWritten")] =
+      EncodableValue(int64_t(stats.frames_written));
+  map[EncodableValue("framesDropped")] =
+      EncodableValue(int64_t(stats.frames_dropped));
+  map[EncodableValue("framesResized")] =
+      EncodableValue(int64_t(stats.frames_resized));
+  map[EncodableValue("bytesWritten")] =
+      EncodableValue(int64_t(stats.bytes_written));
+  map[EncodableValue("writeFailed")] = EncodableValue(stats.write_failed);
+  return map;
+}
+
+void FlutterPeerConnection::StartRecordToFile(
+    int recorder_id,
+    RTCVideoTrack* track,
+    const std::string& path,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (video_recorders_.find(recorder_id) != video_recorders_.end()) {
+    result->Error("startRecordToFile", "recorder is already recording");
+    return;
+  }
+  std::string error;
+  std::unique_ptr<FlutterVideoRecorder> recorder =
+      FlutterVideoRecorder::Start(track, path, &error);
+  if (!recorder) {
+    result->Error("startRecordToFile", error);
+    return;
+  }
+  video_recorders_[recorder_id] = std::move(recorder);
+  result->Success();
+}
+
+void FlutterPeerConnection::StopRecordToFile(
+    int recorder_id,
     std::unique_ptr<MethodResultProxy> result) {
-  FlutterFrameCapturer capturer(track, path);
-  capturer.CaptureFrame(std::move(result));
+  auto it = video_recorders_.find(recorder_id);
+  if (it == video_recorders_.end()) {
+    result->Error("stopRecordToFile", "recorder not found");
+    return;
+  }
+  it->second->Stop();
+  EncodableMap stats = RecorderStatsMap(it->second->stats());
+  video_recorders_.erase(it);
+  result->Success(EncodableValue(stats));
+}
+
+void FlutterPeerConnection::GetRecorderStats(
+    int recorder_id,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = video_recorders_.find(recorder_id);
+  if (it == video_recorders_.end()) {
+    result->Error("getRecorderStats", "recorder not found");
+    return;
+  }
+  result->Success(EncodableValue(RecorderStatsMap(it->second->stats())));
 }
 
 scoped_refptr<RTCRtpTransceiver> FlutterPeerConnection::getRtpTransceiverById(
@@ -882,11 +983,11 @@ void FlutterPeerConnection::RtpTransceiverSetCodecPreferences(
   }
   std::vector<scoped_refptr<RTCRtpCodecCapability>> codecList;
   for (auto codec : codecs) {
-    auto codecMap = GetValue<EncodableMap>(codec);
-    auto codecMimeType = findString(codecMap, "mimeType");
+    const auto& codecMap = std::get<EncodableMap>(codec);
+    const auto& codecMimeType = findStringRef(codecMap, "mimeType");
     auto codecClockRate = findInt(codecMap, "clockRate");
     auto codecNumChannels = findInt(codecMap, "channels");
-    auto codecSdpFmtpLine = findString(codecMap, "sdpFmtpLine");
+    const auto& codecSdpFmtpLine = findStringRef(codecMap, "sdpFmtpLine");
     auto codecCapability = RTCRtpCodecCapability::Create();
     if (codecSdpFmtpLine != std::string() && codecSdpFmtpLine.length() != 0)
       codecCapability->set_sdp_fmtp_line(codecSdpFmtpLine);
@@ -1326,10 +1427,12 @@ void FlutterPeerConnectionObserver::OnDataChannel(
 
   std::string event_channel =
       "FlutterWebRTC/dataChannelEvent" + id_ + channel_uuid;
+  std::string frame_channel =
+      "FlutterWebRTC/dataChannelFrame" + id_ + channel_uuid;
 
   std::unique_ptr<FlutterRTCDataChannelObserver> observer(
       new FlutterRTCDataChannelObserver(data_channel, base_->messenger_,
-                                        event_channel));
+                                        event_channel, frame_channel));
 
   base_->lock();
   base_->data_channel_observers_[channel_uuid] = std::move(observer);
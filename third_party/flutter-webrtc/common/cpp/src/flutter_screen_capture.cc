@@ -183,11 +183,11 @@ void FlutterScreenCapture::GetDisplayMedia(
   // DesktopType source_type = kScreen;
   double fps = 30.0;
 
-  const EncodableMap video = findMap(constraints, "video");
+  const EncodableMap& video = findMapRef(constraints, "video");
   if (video != EncodableMap()) {
-    const EncodableMap deviceId = findMap(video, "deviceId");
+    const EncodableMap& deviceId = findMapRef(video, "deviceId");
     if (deviceId != EncodableMap()) {
-      source_id = findString(deviceId, "exact");
+      source_id = findStringRef(deviceId, "exact");
       if (source_id.empty()) {
         result->Error("Bad Arguments", "Incorrect video->deviceId->exact");
         return;
@@ -196,7 +196,7 @@ void FlutterScreenCapture::GetDisplayMedia(
         // source_type = DesktopType::kWindow;
       }
     }
-    const EncodableMap mandatory = findMap(video, "mandatory");
+    const EncodableMap& mandatory = findMapRef(video, "mandatory");
     if (mandatory != EncodableMap()) {
       double frameRate = findDouble(mandatory, "frameRate");
       if (frameRate != 0.0) {
@@ -0,0 +1,205 @@
+#include "flutter_stats_subscription.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+// The value of a numeric member, false for the types that aren't.
+bool NumericValue(const RTCStatsMember& member, double* value) {
+  switch (member.GetType()) {
+    case RTCStatsMember::Type::kBool:
+      *value = member.ValueBool() ? 1.0 : 0.0;
+      return true;
+    case RTCStatsMember::Type::kInt32:
+      *value = member.ValueInt32();
+      return true;
+    case RTCStatsMember::Type::kUint32:
+      *value = member.ValueUint32();
+      return true;
+    case RTCStatsMember::Type::kInt64:
+      *value = static_cast<double>(member.ValueInt64());
+      return true;
+    case RTCStatsMember::Type::kUint64:
+      *value = static_cast<double>(member.ValueUint64());
+      return true;
+    case RTCStatsMember::Type::kDouble:
+      *value = member.ValueDouble();
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<FlutterStatsSubscription> FlutterStatsSubscription::Start(
+    BinaryMessenger* messenger,
+    const std::string& channel_name,
+    const std::string& peer_connection_id,
+    scoped_refptr<RTCPeerConnection> pc,
+    const EncodableList& fields,
+    std::chrono::milliseconds interval) {
+  // Uses new instead of make_unique due to private constructor.
+  std::unique_ptr<FlutterStatsSubscription> subscription(
+      new FlutterStatsSubscription(peer_connection_id, pc, interval));
+  subscription->event_channel_ =
+      EventChannelProxy::Create(messenger, channel_name);
+  subscription->poller_->event_channel = subscription->event_channel_.get();
+  for (const EncodableValue& field : fields) {
+    const std::string* name = std::get_if<std::string>(&field);
+    size_t dot = name != nullptr ? name->find('.') : std::string::npos;
+    if (dot == std::string::npos) {
+      continue;
+    }
+    subscription->poller_->fields[name->substr(0, dot)].push_back(
+        name->substr(dot + 1));
+  }
+  subscription->timer_ =
+      std::thread(&FlutterStatsSubscription::Run, subscription.get());
+  return subscription;
+}
+
+FlutterStatsSubscription::FlutterStatsSubscription(
+    const std::string& peer_connection_id,
+    scoped_refptr<RTCPeerConnection> pc,
+    std::chrono::milliseconds interval)
+    : peer_connection_id_(peer_connection_id),
+      pc_(pc),
+      interval_(interval),
+      poller_(std::make_shared<Poller>()) {}
+
+FlutterStatsSubscription::~FlutterStatsSubscription() {
+  Stop();
+}
+
+void FlutterStatsSubscription::Stop() {
+  if (!timer_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stop_requested_.notify_one();
+  timer_.join();
+  // Waits for a callback that's sending, later ones return early.
+  std::lock_guard<std::mutex> lock(poller_->mutex);
+  poller_->stopped = true;
+  poller_->event_channel = nullptr;
+}
+
+void FlutterStatsSubscription::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_requested_.wait_for(lock, interval_,
+                                   [this] { return stopping_; })) {
+    {
+      // A slow collection isn't stacked up behind, the tick is skipped.
+      std::lock_guard<std::mutex> poller_lock(poller_->mutex);
+      if (poller_->in_flight) {
+        continue;
+      }
+      poller_->in_flight = true;
+    }
+    std::weak_ptr<Poller> weak_poller = poller_;
+    pc_->GetStats(
+        [weak_poller](const vector<scoped_refptr<MediaRTCStats>> reports) {
+          if (auto poller = weak_poller.lock()) {
+            poller->OnReports(reports);
+          }
+        },
+        [weak_poller](const char* error) {
+          if (auto poller = weak_poller.lock()) {
+            std::lock_guard<std::mutex> poller_lock(poller->mutex);
+            poller->in_flight = false;
+          }
+        });
+  }
+}
+
+void FlutterStatsSubscription::Poller::OnReports(
+    const vector<scoped_refptr<MediaRTCStats>>& stats_reports) {
+  std::lock_guard<std::mutex> lock(mutex);
+  in_flight = false;
+  if (stopped) {
+    return;
+  }
+
+  const int32_t first = static_cast<int32_t>(values.size());
+  EncodableList new_columns;
+  std::vector<int32_t> changed_indices;
+  std::vector<double> changed_values;
+  int64_t timestamp_us = 0;
+  for (size_t i = 0; i < stats_reports.size(); i++) {
+    const scoped_refptr<MediaRTCStats>& report = stats_reports[i];
+    const vector<scoped_refptr<RTCStatsMember>> members = report->Members();
+    std::string id = report->id().std_string();
+    auto it = reports.find(id);
+    if (it == reports.end() || it->second.member_count != members.size()) {
+      ReportColumns resolved;
+      resolved.member_count = members.size();
+      const std::string type = report->type().std_string();
+      auto selected = fields.find(type);
+      for (size_t pos = 0; selected != fields.end() && pos < members.size();
+           pos++) {
+        const std::string name = members[pos]->GetName().std_string();
+        const std::vector<std::string>& names = selected->second;
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+          continue;
+        }
+        auto column = column_ids.find(id + '\n' + name);
+        if (column == column_ids.end()) {
+          const int32_t index = static_cast<int32_t>(values.size());
+          column = column_ids.emplace(id + '\n' + name, index).first;
+          values.push_back(std::numeric_limits<double>::quiet_NaN());
+          new_columns.push_back(EncodableValue(EncodableList{
+              EncodableValue(id), EncodableValue(type), EncodableValue(name)}));
+        }
+        resolved.columns.emplace_back(pos, column->second);
+      }
+      it = reports.insert_or_assign(std::move(id), std::move(resolved)).first;
+    }
+
+    if (it->second.columns.empty()) {
+      continue;
+    }
+    timestamp_us = std::max(timestamp_us, report->timestamp_us());
+    for (const auto& column : it->second.columns) {
+      const RTCStatsMember& member = *members[column.first];
+      double value;
+      if (!member.IsDefined() || !NumericValue(member, &value)) {
+        continue;
+      }
+      double& last = values[column.second];
+      if (value != last || std::isnan(last)) {
+        last = value;
+        changed_indices.push_back(column.second);
+        changed_values.push_back(value);
+      }
+    }
+  }
+
+  if (!new_columns.empty()) {
+    EncodableMap schema;
+    schema[EncodableValue("event")] = EncodableValue("statsSchema");
+    schema[EncodableValue("first")] = EncodableValue(first);
+    schema[EncodableValue("columns")] = EncodableValue(std::move(new_columns));
+    event_channel->Success(EncodableValue(std::move(schema)));
+  }
+  // Sent even when empty, the timestamp alone moves the rates of stalled
+  // counters to zero.
+  if (timestamp_us > 0) {
+    EncodableMap delta;
+    delta[EncodableValue("event")] = EncodableValue("statsDelta");
+    delta[EncodableValue("timestampUs")] = EncodableValue(timestamp_us);
+    delta[EncodableValue("indices")] =
+        EncodableValue(std::move(changed_indices));
+    delta[EncodableValue("values")] = EncodableValue(std::move(changed_values));
+    event_channel->Success(EncodableValue(std::move(delta)));
+  }
+}
+
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,216 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "flutter_video_recorder.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "image_kernels.h"
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+constexpr size_t kSlotAlignment = 4096;
+constexpr char kY4mFrameHeader[] = "FRAME\n";
+constexpr size_t kY4mFrameHeaderSize = sizeof(kY4mFrameHeader) - 1;
+
+bool IsY4mPath(const std::string& path) {
+  if (path.size() < 4) {
+    return false;
+  }
+  std::string extension = path.substr(path.size() - 4);
+  for (char& c : extension) {
+    c = char(tolower(static_cast<unsigned char>(c)));
+  }
+  return extension == ".y4m";
+}
+
+}  // namespace
+
+std::unique_ptr<FlutterVideoRecorder> FlutterVideoRecorder::Start(
+    scoped_refptr<RTCVideoTrack> track,
+    const std::string& path,
+    std::string* error) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    *error = "Cannot create " + path;
+    return nullptr;
+  }
+  const std::string index_path = path + ".idx";
+  FILE* index = fopen(index_path.c_str(), "w");
+  if (!index) {
+    fclose(file);
+    *error = "Cannot create " + index_path;
+    return nullptr;
+  }
+  // Slots are written whole, stdio buffering would only add a copy.
+  setvbuf(file, nullptr, _IONBF, 0);
+
+  // Uses new instead of make_unique due to private constructor.
+  std::unique_ptr<FlutterVideoRecorder> recorder(
+      new FlutterVideoRecorder(IsY4mPath(path), file, index));
+  recorder->writer_ = std::thread(&FlutterVideoRecorder::Run, recorder.get());
+  recorder->hub_ = FrameFanoutHub::ForTrack(track);
+  recorder->hub_->AddSink(recorder.get(), FrameSinkOptions());
+  return recorder;
+}
+
+FlutterVideoRecorder::FlutterVideoRecorder(bool y4m, FILE* file, FILE* index)
+    : y4m_(y4m), file_(file), index_(index) {
+  free_.reserve(kSlots);
+  for (size_t i = 0; i < kSlots; i++) {
+    free_.push_back(kSlots - 1 - i);
+  }
+}
+
+FlutterVideoRecorder::~FlutterVideoRecorder() {
+  Stop();
+}
+
+void FlutterVideoRecorder::Stop() {
+  if (!writer_.joinable()) {
+    return;
+  }
+  // OnFrame isn't called anymore once this returns.
+  hub_->RemoveSink(this);
+  hub_ = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_changed_.notify_one();
+  writer_.join();
+  fclose(file_);
+  fclose(index_);
+}
+
+VideoRecorderStats FlutterVideoRecorder::stats() const {
+  VideoRecorderStats stats;
+  stats.frames_written = frames_written_.load();
+  stats.frames_dropped = frames_dropped_.load();
+  stats.frames_resized = frames_resized_.load();
+  stats.bytes_written = bytes_written_.load();
+  stats.write_failed = write_failed_.load();
+  return stats;
+}
+
+void FlutterVideoRecorder::OnFrame(const HubFrame& hub_frame) {
+  const scoped_refptr<RTCVideoFrame>& frame = hub_frame.frame;
+  const auto now = std::chrono::steady_clock::now();
+  const int width = frame->width();
+  const int height = frame->height();
+  const int chroma_width = (width + 1) / 2;
+  const int chroma_height = (height + 1) / 2;
+  if (frame_size_ == 0) {
+    width_ = width;
+    height_ = height;
+    frame_size_ = (y4m_ ? kY4mFrameHeaderSize : 0) + size_t(width) * height +
+                  2 * size_t(chroma_width) * chroma_height;
+    first_arrival_ = now;
+  } else if (width != width_ || height != height_) {
+    frames_resized_++;
+    return;
+  }
+
+  size_t index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      frames_dropped_++;
+      return;
+    }
+    index = free_.back();
+    free_.pop_back();
+  }
+
+  // The slot is ours until it's queued.
+  Slot& slot = slots_[index];
+  if (slot.data == nullptr) {
+    slot.storage.resize(frame_size_ + kSlotAlignment);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(slot.storage.data());
+    slot.data = slot.storage.data() +
+                (kSlotAlignment - address % kSlotAlignment) % kSlotAlignment;
+  }
+  uint8_t* dst = slot.data;
+  if (y4m_) {
+    memcpy(dst, kY4mFrameHeader, kY4mFrameHeaderSize);
+    dst += kY4mFrameHeaderSize;
+    uint8_t* dst_u = dst + size_t(width) * height;
+    uint8_t* dst_v = dst_u + size_t(chroma_width) * chroma_height;
+    CopyPlane(frame->DataY(), frame->StrideY(), dst, width, width, height);
+    CopyPlane(frame->DataU(), frame->StrideU(), dst_u, chroma_width,
+              chroma_width, chroma_height);
+    CopyPlane(frame->DataV(), frame->StrideV(), dst_v, chroma_width,
+              chroma_width, chroma_height);
+  } else {
+    I420ToNV12(frame->DataY(), frame->StrideY(), frame->DataU(),
+               frame->StrideU(), frame->DataV(), frame->StrideV(), dst, width,
+               dst + size_t(width) * height, chroma_width * 2, width, height);
+  }
+  slot.size = frame_size_;
+  slot.arrival_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - first_arrival_)
+                        .count();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(index);
+  }
+  ready_changed_.notify_one();
+}
+
+void FlutterVideoRecorder::Run() {
+  for (;;) {
+    size_t index;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_changed_.wait(lock,
+                          [this] { return stopping_ || !ready_.empty(); });
+      // Queued frames are written out before stopping.
+      if (ready_.empty()) {
+        return;
+      }
+      index = ready_.front();
+      ready_.pop_front();
+    }
+
+    // After a failed write the rest is discarded, the file is unusable.
+    if (!write_failed_ && !WriteSlot(slots_[index])) {
+      write_failed_ = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(index);
+  }
+}
+
+bool FlutterVideoRecorder::WriteSlot(const Slot& slot) {
+  if (y4m_ && offset_ == 0) {
+    // The frame rate is nominal, real arrival times are in the index.
+    char header[96];
+    const int length =
+        snprintf(header, sizeof(header),
+                 "YUV4MPEG2 W%d H%d F30:1 Ip A1:1 C420jpeg\n", width_, height_);
+    if (fwrite(header, 1, length, file_) != size_t(length)) {
+      return false;
+    }
+    offset_ += length;
+  }
+
+  if (fwrite(slot.data, 1, slot.size, file_) != slot.size) {
+    return false;
+  }
+  const uint64_t pixels = offset_ + (y4m_ ? kY4mFrameHeaderSize : 0);
+  fprintf(index_, "%" PRIu64 " %d %d %" PRId64 "\n", pixels, width_, height_,
+          slot.arrival_us);
+  offset_ += slot.size;
+  bytes_written_ += slot.size;
+  frames_written_++;
+  return true;
+}
+
+}  // namespace flutter_webrtc_plugin
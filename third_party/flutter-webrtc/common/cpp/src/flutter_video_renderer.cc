@@ -1,9 +1,21 @@
 #include "flutter_video_renderer.h"
 
-#include "driver_interface_video_proc_thread.h"
+#include "driver_interface_video_output.h"
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <chrono>
 
 namespace flutter_webrtc_plugin {
 
+namespace {
+
+// Preview widths conversions are rounded up to, so resizing a window
+// doesn't resize the pooled buffers on every frame.
+constexpr int kPreviewWidths[] = {160, 240, 320, 480, 640, 960, 1280, 1920, 2560};
+
+}  // namespace
+
 FlutterVideoRenderer::~FlutterVideoRenderer() {}
 
 void FlutterVideoRenderer::initialize(
@@ -22,47 +34,41 @@ void FlutterVideoRenderer::initialize(
 const FlutterDesktopPixelBuffer* FlutterVideoRenderer::CopyPixelBuffer(
     size_t width,
     size_t height) const {
-  mutex_.lock();
-  if (pixel_buffer_.get() && frame_.get()) {
-    if (pixel_buffer_->width != frame_->width() ||
-        pixel_buffer_->height != frame_->height()) {
-      size_t buffer_size =
-          (size_t(frame_->width()) * size_t(frame_->height())) * (32 >> 3);
-      rgb_buffer_.reset(new uint8_t[buffer_size]);
-      pixel_buffer_->width = frame_->width();
-      pixel_buffer_->height = frame_->height();
-    }
-
-    frame_->ConvertToARGB(RTCVideoFrame::Type::kABGR, rgb_buffer_.get(), 0,
-                          static_cast<int>(pixel_buffer_->width),
-                          static_cast<int>(pixel_buffer_->height));
-    
-    // Send Video buffer to driver_interface processing thread
-    if (first_frame_rendered) {
-      driver_interface::VideoProcessingTask task;
-      task.buffer = rgb_buffer_.get();
-      task.width = pixel_buffer_->width;
-      task.height = pixel_buffer_->height;
-      driver_interface::VideoProcessingThread::AddTask(task);
-    }
+  const auto start = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Picked up by the next OnFrame, frames are converted to the displayed size.
+  requested_size_ = {width, height};
+  if (!pixel_buffer_.get() || !ready_.pixels) {
+    return nullptr;
+  }
 
-    pixel_buffer_->buffer = rgb_buffer_.get();
-    mutex_.unlock();
-    return pixel_buffer_.get();
+  // Publishing only swaps leases, the conversion already happened in OnFrame.
+  if (published_.generation != ready_.generation) {
+    published_ = ready_;
+    pixel_buffer_->width = published_.width;
+    pixel_buffer_->height = published_.height;
+    pixel_buffer_->buffer = published_.pixels->data();
+  } else {
+    stats_.repeat_pulls++;
   }
-  mutex_.unlock();
-  return nullptr;
+
+  const uint64_t elapsed_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  stats_.pulls++;
+  stats_.pull_time_us += elapsed_us;
+  stats_.max_pull_time_us = std::max(stats_.max_pull_time_us, elapsed_us);
+  return pixel_buffer_.get();
 }
 
-void FlutterVideoRenderer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
+void FlutterVideoRenderer::OnFrame(const HubFrame& hub_frame) {
+  const scoped_refptr<RTCVideoFrame>& frame = hub_frame.frame;
   if (!first_frame_rendered) {
     EncodableMap params;
     params[EncodableValue("event")] = "didFirstFrameRendered";
     params[EncodableValue("id")] = EncodableValue(texture_id_);
     event_channel_->Success(EncodableValue(params));
-    pixel_buffer_.reset(new FlutterDesktopPixelBuffer());
-    pixel_buffer_->width = 0;
-    pixel_buffer_->height = 0;
     first_frame_rendered = true;
   }
   if (rotation_ != frame->rotation()) {
@@ -71,7 +77,8 @@ void FlutterVideoRenderer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
     params[EncodableValue("id")] = EncodableValue(texture_id_);
     params[EncodableValue("rotation")] =
         EncodableValue((int32_t)frame->rotation());
-    event_channel_->Success(EncodableValue(params));
+    event_channel_->Coalesce("didTextureChangeRotation",
+                             EncodableValue(params));
     rotation_ = frame->rotation();
   }
   if (last_frame_size_.width != frame->width() ||
@@ -81,26 +88,121 @@ void FlutterVideoRenderer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
     params[EncodableValue("id")] = EncodableValue(texture_id_);
     params[EncodableValue("width")] = EncodableValue((int32_t)frame->width());
     params[EncodableValue("height")] = EncodableValue((int32_t)frame->height());
-    event_channel_->Success(EncodableValue(params));
+    event_channel_->Coalesce("didTextureChangeVideoSize",
+                             EncodableValue(params));
 
     last_frame_size_ = {(size_t)frame->width(), (size_t)frame->height()};
   }
-  mutex_.lock();
-  frame_ = frame;
-  mutex_.unlock();
+  int width, height;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PreviewSize(frame->width(), frame->height(), &width, &height);
+  }
+
+  // Scaled while converting, the preview only pays for the pixels it shows.
+  const auto start = std::chrono::steady_clock::now();
+  FrameBufferLease pixels =
+      FrameBufferPool::Acquire(size_t(width) * size_t(height) * (32 >> 3));
+  I420ScaleToABGR(frame->DataY(), frame->StrideY(), frame->DataU(),
+                  frame->StrideU(), frame->DataV(), frame->StrideV(),
+                  frame->width(), frame->height(), pixels->data(), width * 4,
+                  width, height, false, ScaleFilter::kAuto);
+  const uint64_t elapsed_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pixel_buffer_.get()) {
+      pixel_buffer_.reset(new FlutterDesktopPixelBuffer());
+      pixel_buffer_->width = 0;
+      pixel_buffer_->height = 0;
+    }
+    ready_.pixels = std::move(pixels);
+    ready_.width = static_cast<size_t>(width);
+    ready_.height = static_cast<size_t>(height);
+    ready_.generation = ++generation_;
+    stats_.frames++;
+    stats_.convert_time_us += elapsed_us;
+    stats_.width = static_cast<uint64_t>(width);
+    stats_.height = static_cast<uint64_t>(height);
+  }
   registrar_->MarkTextureFrameAvailable(texture_id_);
 }
 
 void FlutterVideoRenderer::SetVideoTrack(scoped_refptr<RTCVideoTrack> track) {
   if (track_ != track) {
+    if (hub_) {
+      hub_->RemoveSink(this);
+      hub_ = nullptr;
+    }
     if (track_)
-      track_->RemoveRenderer(this);
+      driver_interface::VideoOutput::ReleaseRenderedTrack(track_);
     track_ = track;
     last_frame_size_ = {0, 0};
     first_frame_rendered = false;
-    if (track_)
-      track_->AddRenderer(this);
+    if (track_) {
+      hub_ = FrameFanoutHub::ForTrack(track_);
+      // Frames are converted once, off the raster thread, in OnFrame.
+      FrameSinkOptions options;
+      options.max_fps = policy_.max_fps;
+      hub_->AddSink(this, options);
+      // The virtual camera follows the most recently rendered track.
+      driver_interface::VideoOutput::SetRenderedTrack(track_);
+    }
+  }
+}
+
+VideoRendererStats FlutterVideoRenderer::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void FlutterVideoRenderer::SetPreviewPolicy(
+    const VideoRendererPreviewPolicy& policy) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+  }
+  if (hub_) {
+    FrameSinkOptions options;
+    options.max_fps = policy.max_fps;
+    hub_->AddSink(this, options);
+  }
+}
+
+void FlutterVideoRenderer::PreviewSize(size_t frame_width,
+                                       size_t frame_height,
+                                       int* width,
+                                       int* height) const {
+  double scale = 1.0;
+  if (requested_size_.width > 0 && requested_size_.height > 0) {
+    // Fit the on-screen size, rounded up to the next preview width.
+    const double fit = std::min(double(requested_size_.width) / frame_width,
+                                double(requested_size_.height) / frame_height);
+    const double fit_width = fit * frame_width;
+    for (int bucket : kPreviewWidths) {
+      if (bucket >= fit_width) {
+        scale = double(bucket) / frame_width;
+        break;
+      }
+    }
   }
+  if (policy_.max_width > 0) {
+    scale = std::min(scale, double(policy_.max_width) / frame_width);
+  }
+  if (policy_.max_height > 0) {
+    scale = std::min(scale, double(policy_.max_height) / frame_height);
+  }
+
+  if (scale >= 1.0) {
+    *width = static_cast<int>(frame_width);
+    *height = static_cast<int>(frame_height);
+    return;
+  }
+  *width = std::max(2, static_cast<int>(frame_width * scale + 0.5) & ~1);
+  *height = std::max(2, static_cast<int>(frame_height * scale + 0.5) & ~1);
 }
 
 bool FlutterVideoRenderer::CheckMediaStream(std::string mediaId) {
@@ -192,4 +294,49 @@ void FlutterVideoRendererManager::VideoRendererDispose(
                 "VideoRendererDispose() texture not found!");
 }
 
+void FlutterVideoRendererManager::VideoRendererGetStats(
+    int64_t texture_id,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = renderers_.find(texture_id);
+  if (it == renderers_.end()) {
+    result->Error("VideoRendererGetStatsFailed",
+                  "VideoRendererGetStats() texture not found!");
+    return;
+  }
+
+  const VideoRendererStats stats = it->second->GetStats();
+  EncodableMap params;
+  params[EncodableValue("frames")] =
+      EncodableValue(static_cast<int64_t>(stats.frames));
+  params[EncodableValue("pulls")] =
+      EncodableValue(static_cast<int64_t>(stats.pulls));
+  params[EncodableValue("repeatPulls")] =
+      EncodableValue(static_cast<int64_t>(stats.repeat_pulls));
+  params[EncodableValue("pullTimeUs")] =
+      EncodableValue(static_cast<int64_t>(stats.pull_time_us));
+  params[EncodableValue("maxPullTimeUs")] =
+      EncodableValue(static_cast<int64_t>(stats.max_pull_time_us));
+  params[EncodableValue("convertTimeUs")] =
+      EncodableValue(static_cast<int64_t>(stats.convert_time_us));
+  params[EncodableValue("width")] =
+      EncodableValue(static_cast<int64_t>(stats.width));
+  params[EncodableValue("height")] =
+      EncodableValue(static_cast<int64_t>(stats.height));
+  result->Success(EncodableValue(params));
+}
+
+void FlutterVideoRendererManager::VideoRendererSetPreviewPolicy(
+    int64_t texture_id,
+    const VideoRendererPreviewPolicy& policy,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = renderers_.find(texture_id);
+  if (it == renderers_.end()) {
+    result->Error("VideoRendererSetPreviewPolicyFailed",
+                  "VideoRendererSetPreviewPolicy() texture not found!");
+    return;
+  }
+  it->second->SetPreviewPolicy(policy);
+  result->Success();
+}
+
 }  // namespace flutter_webrtc_plugin
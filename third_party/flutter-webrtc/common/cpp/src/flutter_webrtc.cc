@@ -23,1192 +23,1303 @@ FlutterWebRTC::~FlutterWebRTC() {}
 void FlutterWebRTC::HandleMethodCall(
     const MethodCallProxy& method_call,
     std::unique_ptr<MethodResultProxy> result) {
-  if (method_call.method_name().compare("initialize") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap options = findMap(params, "options");
-    result->Success();
-  } else if (method_call.method_name().compare("createPeerConnection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap configuration = findMap(params, "configuration");
-    const EncodableMap constraints = findMap(params, "constraints");
-    CreateRTCPeerConnection(configuration, constraints, std::move(result));
-  } else if (method_call.method_name().compare("getUserMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-    GetUserMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDisplayMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-
-    GetDisplayMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    GetDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("updateDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    UpdateDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSourceThumbnail") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    std::string sourceId = findString(params, "sourceId");
-    if (sourceId.empty()) {
-      result->Error("Bad Arguments", "Incorrect sourceId");
-      return;
-    }
-    const EncodableMap thumbnailSize = findMap(params, "thumbnailSize");
-    if (!thumbnailSize.empty()) {
-      int width = 0;
-      int height = 0;
-      GetDesktopSourceThumbnail(sourceId, width, height, std::move(result));
-    } else {
-      result->Error("Bad Arguments", "Bad arguments received");
-    }
-  } else if (method_call.method_name().compare("getSources") == 0) {
-    GetSources(std::move(result));
-  } else if (method_call.method_name().compare("selectAudioInput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioInput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("selectAudioOutput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioOutput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamGetTracks") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    MediaStreamGetTracks(streamId, std::move(result));
-  } else if (method_call.method_name().compare("createOffer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createOfferFailed",
-                    "createOffer() peerConnection is null");
-      return;
-    }
-    CreateOffer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("createAnswer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createAnswerFailed",
-                    "createAnswer() peerConnection is null");
-      return;
-    }
-    CreateAnswer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("addStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("addStreamFailed", "addStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addStreamFailed", "addStream() peerConnection is null");
-      return;
-    }
-    pc->AddStream(stream);
-    result->Success();
-  } else if (method_call.method_name().compare("removeStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("removeStreamFailed", "removeStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeStreamFailed",
-                    "removeStream() peerConnection is null");
-      return;
-    }
-    pc->RemoveStream(stream);
-    result->Success();
-  } else if (method_call.method_name().compare("setLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setLocalDescriptionFailed",
-                    "setLocalDescription() peerConnection is null");
-      return;
-    }
-
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
-
-    if (description.get() != nullptr) {
-      SetLocalDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("setRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setRemoteDescriptionFailed",
-                    "setRemoteDescription() peerConnection is null");
-      return;
-    }
-
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
-
-    if (description.get() != nullptr) {
-      SetRemoteDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("addCandidate") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "candidate");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addCandidateFailed",
-                    "addCandidate() peerConnection is null");
-      return;
-    }
-
-    SdpParseError error;
-    std::string candidate = findString(constraints, "candidate");
-    if (candidate.empty()) {
-      // received the end-of-candidates
-      result->Success();
-      return;
-    }
-    int sdpMLineIndex = findInt(constraints, "sdpMLineIndex");
-    scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
-        candidate.c_str(), findString(constraints, "sdpMid").c_str(),
-        sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
-
-    if (rtc_candidate.get() != nullptr) {
-      AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
-    } else {
-      result->Error("addCandidateFailed", "Invalid candidate");
-    }
-  } else if (method_call.method_name().compare("getStats") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string track_id = findString(params, "trackId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getStatsFailed", "getStats() peerConnection is null");
-      return;
-    }
-    GetStats(track_id, pc, std::move(result));
-  } else if (method_call.method_name().compare("createDataChannel") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createDataChannelFailed",
-                    "createDataChannel() peerConnection is null");
-      return;
-    }
-
-    const std::string label = findString(params, "label");
-    const EncodableMap dataChannelDict = findMap(params, "dataChannelDict");
-
-    CreateDataChannel(peerConnectionId, label, dataChannelDict, pc,
-                      std::move(result));
-  } else if (method_call.method_name().compare("dataChannelSend") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() peerConnection is null");
-      return;
-    }
-
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    const std::string type = findString(params, "type");
-    const EncodableValue data = findEncodableValue(params, "data");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() data_channel is null");
-      return;
-    }
-    DataChannelSend(data_channel, type, data, std::move(result));
-  } else if (method_call.method_name().compare("dataChannelClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() peerConnection is null");
-      return;
-    }
-
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() data_channel is null");
-      return;
-    }
-    DataChannelClose(data_channel, dataChannelId, std::move(result));
-  } else if (method_call.method_name().compare("streamDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    MediaStreamDispose(stream_id, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamTrackSetEnable") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    const EncodableValue enable = findEncodableValue(params, "enabled");
-    RTCMediaTrack* track = MediaTrackForId(track_id);
-    if (track != nullptr) {
-      track->set_enabled(GetValue<bool>(enable));
-    }
-    result->Success();
-  } else if (method_call.method_name().compare("trackDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackDispose(track_id, std::move(result));
-  } else if (method_call.method_name().compare("restartIce") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("restartIceFailed", "restartIce() peerConnection is null");
-      return;
-    }
-    pc->RestartIce();
-    result->Success();
-  } else if (method_call.method_name().compare("peerConnectionClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("peerConnectionCloseFailed",
-                    "peerConnectionClose() peerConnection is null");
-      return;
-    }
-    RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("peerConnectionDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Success();
-      return;
-    }
-    RTCPeerConnectionDispose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("createVideoRenderer") == 0) {
-    CreateVideoRendererTexture(std::move(result));
-  } else if (method_call.method_name().compare("videoRendererDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    int64_t texture_id = findLongInt(params, "textureId");
-    VideoRendererDispose(texture_id, std::move(result));
-  } else if (method_call.method_name().compare("videoRendererSetSrcObject") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    int64_t texture_id = findLongInt(params, "textureId");
-    const std::string owner_tag = findString(params, "ownerTag");
-    const std::string track_id = findString(params, "trackId");
-
-    VideoRendererSetSrcObject(texture_id, stream_id, owner_tag, track_id);
-    result->Success();
-  } else if (method_call.method_name().compare(
-                 "mediaStreamTrackSwitchCamera") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackSwitchCamera(track_id, std::move(result));
-  } else if (method_call.method_name().compare("setVolume") == 0) {
-  } else if (method_call.method_name().compare("getLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetLocalDescription",
-                    "GetLocalDescription() peerConnection is null");
-      return;
-    }
-
-    GetLocalDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("getRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetRemoteDescription",
-                    "GetRemoteDescription() peerConnection is null");
-      return;
-    }
-
-    GetRemoteDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamAddTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() stream is null");
-      return;
-    }
-
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() track is null");
-      return;
-    }
-
-    MediaStreamAddTrack(stream, track, std::move(result));
-    std::string kind = track->kind().std_string();
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckMediaStream(streamId) && 0 == kind.compare("video")) {
-        renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
-      }
-    }
-  } else if (method_call.method_name().compare("mediaStreamRemoveTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() stream is null");
-      return;
-    }
-
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() track is null");
-      return;
-    }
-
-    MediaStreamRemoveTrack(stream, track, std::move(result));
-
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckVideoTrack(streamId)) {
-        renderer->SetVideoTrack(nullptr);
-      }
-    }
-  } else if (method_call.method_name().compare("addTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string trackId = findString(params, "trackId");
-    const EncodableList streamIds = findList(params, "streamIds");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("AddTrack", "AddTrack() peerConnection is null");
-      return;
-    }
-
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("AddTrack", "AddTrack() track is null");
-      return;
-    }
-    std::vector<std::string> ids;
-    for (EncodableValue value : streamIds) {
-      ids.push_back(GetValue<std::string>(value));
-    }
-
-    AddTrack(pc, track, ids, std::move(result));
-
-  } else if (method_call.method_name().compare("removeTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string senderId = findString(params, "senderId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeTrack", "removeTrack() peerConnection is null");
-      return;
-    }
-
-    RemoveTrack(pc, senderId, std::move(result));
-
-  } else if (method_call.method_name().compare("addTransceiver") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap transceiverInit = findMap(params, "transceiverInit");
-    const std::string mediaType = findString(params, "mediaType");
-    const std::string trackId = findString(params, "trackId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addTransceiver",
-                    "addTransceiver() peerConnection is null");
-      return;
-    }
-    AddTransceiver(pc, trackId, mediaType, transceiverInit, std::move(result));
-  } else if (method_call.method_name().compare("getTransceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getTransceivers",
-                    "getTransceivers() peerConnection is null");
-      return;
-    }
-
-    GetTransceivers(pc, std::move(result));
-  } else if (method_call.method_name().compare("getReceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getReceivers", "getReceivers() peerConnection is null");
-      return;
-    }
-
-    GetReceivers(pc, std::move(result));
-
-  } else if (method_call.method_name().compare("getSenders") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSenders", "getSenders() peerConnection is null");
-      return;
-    }
-
-    GetSenders(pc, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() peerConnection is null");
-      return;
-    }
-
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetStreams") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() peerConnection is null");
-      return;
-    }
-
-    const EncodableList encodableStreamIds = findList(params, "streamIds");
-    if (encodableStreamIds.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() streamId is null or empty");
-      return;
-    }
-    std::vector<std::string> streamIds{};
-    for (EncodableValue value : encodableStreamIds) {
-      streamIds.push_back(GetValue<std::string>(value));
-    }
-
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetStream(pc, streamIds, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderReplaceTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() peerConnection is null");
-      return;
-    }
-
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderReplaceTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetParameters") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() peerConnection is null");
-      return;
-    }
-
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() rtpSenderId is null or empty");
-      return;
-    }
-
-    const EncodableMap parameters = findMap(params, "parameters");
-    if (0 == parameters.size()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() parameters is null or empty");
-      return;
-    }
-
-    RtpSenderSetParameters(pc, rtpSenderId, parameters, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverStop") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() peerConnection is null");
-      return;
-    }
-
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() transceiverId is null or empty");
-      return;
-    }
-
-    RtpTransceiverStop(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare(
-                 "rtpTransceiverGetCurrentDirection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error(
-          "rtpTransceiverGetCurrentDirection",
-          "rtpTransceiverGetCurrentDirection() peerConnection is null");
-      return;
-    }
-
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverGetCurrentDirection",
-                    "rtpTransceiverGetCurrentDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
-
-    RtpTransceiverGetCurrentDirection(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverSetDirection") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() peerConnection is null");
-      return;
-    }
-
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
-
-    const std::string direction = findString(params, "direction");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() direction is null or empty");
-      return;
-    }
-
-    RtpTransceiverSetDirection(pc, transceiverId, direction, std::move(result));
-  } else if (method_call.method_name().compare("setConfiguration") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setConfiguration",
-                    "setConfiguration() peerConnection is null");
-      return;
-    }
-
-    const EncodableMap configuration = findMap(params, "configuration");
-    if (configuration.empty()) {
-      result->Error("setConfiguration",
-                    "setConfiguration() configuration is null or empty");
-      return;
-    }
-    SetConfiguration(pc, configuration, std::move(result));
-  } else if (method_call.method_name().compare("captureFrame") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string path = findString(params, "path");
-    if (path.empty()) {
-      result->Error("captureFrame", "captureFrame() path is null or empty");
-      return;
-    }
-
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-    if (nullptr == track) {
-      result->Error("captureFrame", "captureFrame() track is null");
-      return;
-    }
-    std::string kind = track->kind().std_string();
-    if (0 != kind.compare("video")) {
-      result->Error("captureFrame", "captureFrame() track not is video track");
-      return;
-    }
-    CaptureFrame(reinterpret_cast<RTCVideoTrack*>(track), path,
-                 std::move(result));
-
-  } else if (method_call.method_name().compare("createLocalMediaStream") == 0) {
-    CreateLocalMediaStream(std::move(result));
-  } else if (method_call.method_name().compare("canInsertDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("canInsertDtmf", "canInsertDtmf() peerConnection is null");
-      return;
-    }
-
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
-
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
-    auto dtmfSender = rtpSender->dtmf_sender();
-    bool canInsertDtmf = dtmfSender->CanInsertDtmf();
-
-    result->Success(EncodableValue(canInsertDtmf));
-  } else if (method_call.method_name().compare("sendDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    const std::string tone = findString(params, "tone");
-    int duration = findInt(params, "duration");
-    int gap = findInt(params, "gap");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() peerConnection is null");
-      return;
-    }
-
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
-
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
-
-    auto dtmfSender = rtpSender->dtmf_sender();
-    dtmfSender->InsertDtmf(tone, duration, gap);
-
-    result->Success();
-  } else if (method_call.method_name().compare("getRtpSenderCapabilities") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpSenderCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("getRtpReceiverCapabilities") ==
-             0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpReceiverCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("setCodecPreferences") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() peerConnection is null");
-      return;
-    }
-
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() transceiverId is null or empty");
-      return;
-    }
-
-    const EncodableList codecs = findList(params, "codecs");
-    if (codecs.empty()) {
-      result->Error("Bad Arguments", "Codecs is required");
-      return;
-    }
-    RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
+  using Handler = void (*)(FlutterWebRTC* self, const EncodableMap& params,
+                           std::unique_ptr<MethodResultProxy> result);
+  struct Method {
+    // Reported when the call has no arguments, nullptr if they are optional.
+    const char* missing_arguments;
+    Handler handler;
+  };
+
+  // Hashed once, handlers read their arguments in place through the find*Ref
+  // accessors instead of copying them out of the call.
+  static const std::unordered_map<std::string, Method> methods = {
+      {"initialize",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          result->Success();
+        }}},
+      {"createPeerConnection",
+       {"Null arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const EncodableMap& configuration =
+              findMapRef(params, "configuration");
+          const EncodableMap& constraints = findMapRef(params, "constraints");
+          self->CreateRTCPeerConnection(configuration, constraints,
+                                        std::move(result));
+        }}},
+      {"getUserMedia",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const EncodableMap& constraints = findMapRef(params, "constraints");
+          self->GetUserMedia(constraints, std::move(result));
+        }}},
+      {"getDisplayMedia",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const EncodableMap& constraints = findMapRef(params, "constraints");
+
+          self->GetDisplayMedia(constraints, std::move(result));
+        }}},
+      {"getDesktopSources",
+       {"Bad arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          // types: ["screen", "window"]
+
+          const EncodableList& types = findListRef(params, "types");
+          if (types.empty()) {
+            result->Error("Bad Arguments", "Types is required");
+            return;
+          }
+          self->GetDesktopSources(types, std::move(result));
+        }}},
+      {"updateDesktopSources",
+       {"Bad arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          // types: ["screen", "window"]
+
+          const EncodableList& types = findListRef(params, "types");
+          if (types.empty()) {
+            result->Error("Bad Arguments", "Types is required");
+            return;
+          }
+          self->UpdateDesktopSources(types, std::move(result));
+        }}},
+      {"getDesktopSourceThumbnail",
+       {"Bad arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& sourceId = findStringRef(params, "sourceId");
+          if (sourceId.empty()) {
+            result->Error("Bad Arguments", "Incorrect sourceId");
+            return;
+          }
+          const EncodableMap& thumbnailSize =
+              findMapRef(params, "thumbnailSize");
+          if (!thumbnailSize.empty()) {
+            int width = 0;
+            int height = 0;
+            self->GetDesktopSourceThumbnail(sourceId, width, height,
+                                            std::move(result));
+          } else {
+            result->Error("Bad Arguments", "Bad arguments received");
+          }
+        }}},
+      {"getSources",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->GetSources(std::move(result));
+        }}},
+      {"selectAudioInput",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& deviceId = findStringRef(params, "deviceId");
+          self->SelectAudioInput(deviceId, std::move(result));
+        }}},
+      {"selectAudioOutput",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& deviceId = findStringRef(params, "deviceId");
+          self->SelectAudioOutput(deviceId, std::move(result));
+        }}},
+      {"mediaStreamGetTracks",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& streamId = findStringRef(params, "streamId");
+          self->MediaStreamGetTracks(streamId, std::move(result));
+        }}},
+      {"createOffer",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& constraints = findMapRef(params, "constraints");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("createOfferFailed",
+                          "createOffer() peerConnection is null");
+            return;
+          }
+          self->CreateOffer(constraints, pc, std::move(result));
+        }}},
+      {"createAnswer",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& constraints = findMapRef(params, "constraints");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("createAnswerFailed",
+                          "createAnswer() peerConnection is null");
+            return;
+          }
+          self->CreateAnswer(constraints, pc, std::move(result));
+        }}},
+      {"addStream",
+       {"Null arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& streamId = findStringRef(params, "streamId");
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          scoped_refptr<RTCMediaStream> stream =
+              self->MediaStreamForId(streamId);
+          if (!stream) {
+            result->Error("addStreamFailed", "addStream() stream not found!");
+            return;
+          }
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("addStreamFailed",
+                          "addStream() peerConnection is null");
+            return;
+          }
+          pc->AddStream(stream);
+          result->Success();
+        }}},
+      {"removeStream",
+       {"Null arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& streamId = findStringRef(params, "streamId");
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          scoped_refptr<RTCMediaStream> stream =
+              self->MediaStreamForId(streamId);
+          if (!stream) {
+            result->Error("removeStreamFailed",
+                          "removeStream() stream not found!");
+            return;
+          }
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("removeStreamFailed",
+                          "removeStream() peerConnection is null");
+            return;
+          }
+          pc->RemoveStream(stream);
+          result->Success();
+        }}},
+      {"setLocalDescription",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& constraints = findMapRef(params, "description");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("setLocalDescriptionFailed",
+                          "setLocalDescription() peerConnection is null");
+            return;
+          }
+
+          SdpParseError error;
+          scoped_refptr<RTCSessionDescription> description =
+              RTCSessionDescription::Create(
+                  findStringRef(constraints, "type").c_str(),
+                  findStringRef(constraints, "sdp").c_str(), &error);
+
+          if (description.get() != nullptr) {
+            self->SetLocalDescription(description.get(), pc, std::move(result));
+          } else {
+            result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
+          }
+        }}},
+      {"setRemoteDescription",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& constraints = findMapRef(params, "description");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("setRemoteDescriptionFailed",
+                          "setRemoteDescription() peerConnection is null");
+            return;
+          }
+
+          SdpParseError error;
+          scoped_refptr<RTCSessionDescription> description =
+              RTCSessionDescription::Create(
+                  findStringRef(constraints, "type").c_str(),
+                  findStringRef(constraints, "sdp").c_str(), &error);
+
+          if (description.get() != nullptr) {
+            self->SetRemoteDescription(description.get(), pc,
+                                       std::move(result));
+          } else {
+            result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
+          }
+        }}},
+      {"addCandidate",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& constraints = findMapRef(params, "candidate");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("addCandidateFailed",
+                          "addCandidate() peerConnection is null");
+            return;
+          }
+
+          SdpParseError error;
+          const std::string& candidate =
+              findStringRef(constraints, "candidate");
+          if (candidate.empty()) {
+            // received the end-of-candidates
+            result->Success();
+            return;
+          }
+          int sdpMLineIndex = findInt(constraints, "sdpMLineIndex");
+          scoped_refptr<RTCIceCandidate> rtc_candidate =
+              RTCIceCandidate::Create(
+                  candidate.c_str(),
+                  findStringRef(constraints, "sdpMid").c_str(),
+                  sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
+
+          if (rtc_candidate.get() != nullptr) {
+            self->AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
+          } else {
+            result->Error("addCandidateFailed", "Invalid candidate");
+          }
+        }}},
+      {"getStats",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const std::string& track_id = findStringRef(params, "trackId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getStatsFailed",
+                          "getStats() peerConnection is null");
+            return;
+          }
+          self->GetStats(track_id, pc, std::move(result));
+        }}},
+      {"createDataChannel",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("createDataChannelFailed",
+                          "createDataChannel() peerConnection is null");
+            return;
+          }
+
+          const std::string& label = findStringRef(params, "label");
+          const EncodableMap& dataChannelDict =
+              findMapRef(params, "dataChannelDict");
+
+          self->CreateDataChannel(peerConnectionId, label, dataChannelDict, pc,
+                            std::move(result));
+        }}},
+      {"dataChannelSend",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("dataChannelSendFailed",
+                          "dataChannelSend() peerConnection is null");
+            return;
+          }
+
+          const std::string& dataChannelId =
+              findStringRef(params, "dataChannelId");
+          const std::string& type = findStringRef(params, "type");
+          const EncodableValue* data = findValuePtr(params, "data");
+          RTCDataChannel* data_channel = self->DataChannelForId(dataChannelId);
+          if (data_channel == nullptr) {
+            result->Error("dataChannelSendFailed",
+                          "dataChannelSend() data_channel is null");
+            return;
+          }
+          if (data == nullptr) {
+            result->Error("dataChannelSendFailed",
+                          "dataChannelSend() data is null");
+            return;
+          }
+          self->DataChannelSend(data_channel, type, *data, std::move(result));
+        }}},
+      {"dataChannelClose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("dataChannelCloseFailed",
+                          "dataChannelClose() peerConnection is null");
+            return;
+          }
+
+          const std::string& dataChannelId =
+              findStringRef(params, "dataChannelId");
+          RTCDataChannel* data_channel = self->DataChannelForId(dataChannelId);
+          if (data_channel == nullptr) {
+            result->Error("dataChannelCloseFailed",
+                          "dataChannelClose() data_channel is null");
+            return;
+          }
+          self->DataChannelClose(data_channel, dataChannelId,
+                                 std::move(result));
+        }}},
+      {"streamDispose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& stream_id = findStringRef(params, "streamId");
+          self->MediaStreamDispose(stream_id, std::move(result));
+        }}},
+      {"mediaStreamTrackSetEnable",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& track_id = findStringRef(params, "trackId");
+          const bool* enable = findPtr<bool>(params, "enabled");
+          if (enable == nullptr) {
+            result->Error("Bad Arguments", "enabled must be a bool");
+            return;
+          }
+          RTCMediaTrack* track = self->MediaTrackForId(track_id);
+          if (track != nullptr) {
+            track->set_enabled(*enable);
+          }
+          result->Success();
+        }}},
+      {"trackDispose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& track_id = findStringRef(params, "trackId");
+          self->MediaStreamTrackDispose(track_id, std::move(result));
+        }}},
+      {"restartIce",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("restartIceFailed",
+                          "restartIce() peerConnection is null");
+            return;
+          }
+          pc->RestartIce();
+          result->Success();
+        }}},
+      {"peerConnectionClose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("peerConnectionCloseFailed",
+                          "peerConnectionClose() peerConnection is null");
+            return;
+          }
+          self->RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
+        }}},
+      {"peerConnectionDispose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Success();
+            return;
+          }
+          self->RTCPeerConnectionDispose(pc, peerConnectionId,
+                                         std::move(result));
+        }}},
+      {"createVideoRenderer",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->CreateVideoRendererTexture(std::move(result));
+        }}},
+      {"videoRendererDispose",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          int64_t texture_id = findLongInt(params, "textureId");
+          self->VideoRendererDispose(texture_id, std::move(result));
+        }}},
+      {"videoRendererGetStats",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          int64_t texture_id = findLongInt(params, "textureId");
+          self->VideoRendererGetStats(texture_id, std::move(result));
+        }}},
+      {"videoRendererSetPreviewPolicy",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          int64_t texture_id = findLongInt(params, "textureId");
+          VideoRendererPreviewPolicy policy;
+          policy.max_width = std::max(findInt(params, "maxWidth"), 0);
+          policy.max_height = std::max(findInt(params, "maxHeight"), 0);
+          policy.max_fps = std::max(findInt(params, "maxFps"), 0);
+          self->VideoRendererSetPreviewPolicy(texture_id, policy,
+                                              std::move(result));
+        }}},
+      {"videoRendererSetSrcObject",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& stream_id = findStringRef(params, "streamId");
+          int64_t texture_id = findLongInt(params, "textureId");
+          const std::string& owner_tag = findStringRef(params, "ownerTag");
+          const std::string& track_id = findStringRef(params, "trackId");
+
+          self->VideoRendererSetSrcObject(texture_id, stream_id, owner_tag,
+                                          track_id);
+          result->Success();
+        }}},
+      {"mediaStreamTrackSwitchCamera",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& track_id = findStringRef(params, "trackId");
+          self->MediaStreamTrackSwitchCamera(track_id, std::move(result));
+        }}},
+      {"setVolume",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          // Volume is not adjustable here, still complete the call.
+          result->Success();
+        }}},
+      {"getLocalDescription",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("GetLocalDescription",
+                          "GetLocalDescription() peerConnection is null");
+            return;
+          }
+
+          self->GetLocalDescription(pc, std::move(result));
+        }}},
+      {"getRemoteDescription",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("GetRemoteDescription",
+                          "GetRemoteDescription() peerConnection is null");
+            return;
+          }
+
+          self->GetRemoteDescription(pc, std::move(result));
+        }}},
+      {"mediaStreamAddTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& streamId = findStringRef(params, "streamId");
+          const std::string& trackId = findStringRef(params, "trackId");
+
+          scoped_refptr<RTCMediaStream> stream =
+              self->MediaStreamForId(streamId);
+          if (stream == nullptr) {
+            result->Error("MediaStreamAddTrack",
+                          "MediaStreamAddTrack() stream is null");
+            return;
+          }
+
+          scoped_refptr<RTCMediaTrack> track = self->MediaTracksForId(trackId);
+          if (track == nullptr) {
+            result->Error("MediaStreamAddTrack",
+                          "MediaStreamAddTrack() track is null");
+            return;
+          }
+
+          self->MediaStreamAddTrack(stream, track, std::move(result));
+          std::string kind = track->kind().std_string();
+          for (int i = 0; i < self->renders_.size(); i++) {
+            FlutterVideoRenderer* renderer = self->renders_.at(i).get();
+            if (renderer->CheckMediaStream(
+                streamId) && 0 == kind.compare("video")) {
+              renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
+            }
+          }
+        }}},
+      {"mediaStreamRemoveTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& streamId = findStringRef(params, "streamId");
+          const std::string& trackId = findStringRef(params, "trackId");
+
+          scoped_refptr<RTCMediaStream> stream =
+              self->MediaStreamForId(streamId);
+          if (stream == nullptr) {
+            result->Error("MediaStreamRemoveTrack",
+                          "MediaStreamRemoveTrack() stream is null");
+            return;
+          }
+
+          scoped_refptr<RTCMediaTrack> track = self->MediaTracksForId(trackId);
+          if (track == nullptr) {
+            result->Error("MediaStreamRemoveTrack",
+                          "MediaStreamRemoveTrack() track is null");
+            return;
+          }
+
+          self->MediaStreamRemoveTrack(stream, track, std::move(result));
+
+          for (int i = 0; i < self->renders_.size(); i++) {
+            FlutterVideoRenderer* renderer = self->renders_.at(i).get();
+            if (renderer->CheckVideoTrack(streamId)) {
+              renderer->SetVideoTrack(nullptr);
+            }
+          }
+        }}},
+      {"addTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const std::string& trackId = findStringRef(params, "trackId");
+          const EncodableList& streamIds = findListRef(params, "streamIds");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("AddTrack", "AddTrack() peerConnection is null");
+            return;
+          }
+
+          scoped_refptr<RTCMediaTrack> track = self->MediaTracksForId(trackId);
+          if (track == nullptr) {
+            result->Error("AddTrack", "AddTrack() track is null");
+            return;
+          }
+          std::vector<std::string> ids;
+          for (EncodableValue value : streamIds) {
+            ids.push_back(GetValue<std::string>(value));
+          }
+
+          self->AddTrack(pc, track, ids, std::move(result));
+        }}},
+      {"removeTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const std::string& senderId = findStringRef(params, "senderId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("removeTrack",
+                          "removeTrack() peerConnection is null");
+            return;
+          }
+
+          self->RemoveTrack(pc, senderId, std::move(result));
+        }}},
+      {"addTransceiver",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const EncodableMap& transceiverInit =
+              findMapRef(params, "transceiverInit");
+          const std::string& mediaType = findStringRef(params, "mediaType");
+          const std::string& trackId = findStringRef(params, "trackId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("addTransceiver",
+                          "addTransceiver() peerConnection is null");
+            return;
+          }
+          self->AddTransceiver(pc, trackId, mediaType, transceiverInit,
+                               std::move(result));
+        }}},
+      {"getTransceivers",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getTransceivers",
+                          "getTransceivers() peerConnection is null");
+            return;
+          }
+
+          self->GetTransceivers(pc, std::move(result));
+        }}},
+      {"getReceivers",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getReceivers",
+                          "getReceivers() peerConnection is null");
+            return;
+          }
+
+          self->GetReceivers(pc, std::move(result));
+        }}},
+      {"getSenders",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getSenders", "getSenders() peerConnection is null");
+            return;
+          }
+
+          self->GetSenders(pc, std::move(result));
+        }}},
+      {"rtpSenderSetTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpSenderSetTrack",
+                          "rtpSenderSetTrack() peerConnection is null");
+            return;
+          }
+
+          const std::string& trackId = findStringRef(params, "trackId");
+          RTCMediaTrack* track = self->MediaTrackForId(trackId);
+
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+          if (rtpSenderId.empty()) {
+            result->Error("rtpSenderSetTrack",
+                          "rtpSenderSetTrack() rtpSenderId is null or empty");
+            return;
+          }
+          self->RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
+        }}},
+      {"rtpSenderSetStreams",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpSenderSetStream",
+                          "rtpSenderSetStream() peerConnection is null");
+            return;
+          }
+
+          const EncodableList& encodableStreamIds =
+              findListRef(params, "streamIds");
+          if (encodableStreamIds.empty()) {
+            result->Error("rtpSenderSetStream",
+                          "rtpSenderSetStream() streamId is null or empty");
+            return;
+          }
+          std::vector<std::string> streamIds{};
+          for (EncodableValue value : encodableStreamIds) {
+            streamIds.push_back(GetValue<std::string>(value));
+          }
+
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+          if (rtpSenderId.empty()) {
+            result->Error("rtpSenderSetStream",
+                          "rtpSenderSetStream() rtpSenderId is null or empty");
+            return;
+          }
+          self->RtpSenderSetStream(pc, streamIds, rtpSenderId,
+                                   std::move(result));
+        }}},
+      {"rtpSenderReplaceTrack",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpSenderReplaceTrack",
+                          "rtpSenderReplaceTrack() peerConnection is null");
+            return;
+          }
+
+          const std::string& trackId = findStringRef(params, "trackId");
+          RTCMediaTrack* track = self->MediaTrackForId(trackId);
+
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+          if (rtpSenderId.empty()) {
+            result->Error("rtpSenderReplaceTrack",
+                          "rtpSenderReplaceTrack() rtpSenderId is null or "
+                          "empty");
+            return;
+          }
+          self->RtpSenderReplaceTrack(pc, track, rtpSenderId,
                                       std::move(result));
-  } else if (method_call.method_name().compare("getSignalingState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSignalingState",
-                    "getSignalingState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        signalingStateString(pc->signaling_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceGatheringState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceGatheringState",
-                    "getIceGatheringState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceGatheringStateString(pc->ice_gathering_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceConnectionState",
-                    "getIceConnectionState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceConnectionStateString(pc->ice_connection_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getConnectionState",
-                    "getConnectionState() peerConnection is null");
-      return;
+        }}},
+      {"rtpSenderSetParameters",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpSenderSetParameters",
+                          "rtpSenderSetParameters() peerConnection is null");
+            return;
+          }
+
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+          if (rtpSenderId.empty()) {
+            result->Error("rtpSenderSetParameters",
+                          "rtpSenderSetParameters() rtpSenderId is null or "
+                          "empty");
+            return;
+          }
+
+          const EncodableMap& parameters = findMapRef(params, "parameters");
+          if (0 == parameters.size()) {
+            result->Error("rtpSenderSetParameters",
+                          "rtpSenderSetParameters() parameters is null or "
+                          "empty");
+            return;
+          }
+
+          self->RtpSenderSetParameters(pc, rtpSenderId, parameters,
+                                       std::move(result));
+        }}},
+      {"rtpTransceiverStop",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpTransceiverStop",
+                          "rtpTransceiverStop() peerConnection is null");
+            return;
+          }
+
+          const std::string& transceiverId =
+              findStringRef(params, "transceiverId");
+          if (transceiverId.empty()) {
+            result->Error("rtpTransceiverStop",
+                          "rtpTransceiverStop() transceiverId is null or "
+                          "empty");
+            return;
+          }
+
+          self->RtpTransceiverStop(pc, transceiverId, std::move(result));
+        }}},
+      {"rtpTransceiverGetCurrentDirection",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error(
+                "rtpTransceiverGetCurrentDirection",
+                "rtpTransceiverGetCurrentDirection() peerConnection is null");
+            return;
+          }
+
+          const std::string& transceiverId =
+              findStringRef(params, "transceiverId");
+          if (transceiverId.empty()) {
+            result->Error("rtpTransceiverGetCurrentDirection",
+                          "rtpTransceiverGetCurrentDirection() "
+                          "transceiverId is null or empty");
+            return;
+          }
+
+          self->RtpTransceiverGetCurrentDirection(pc, transceiverId,
+                                                  std::move(result));
+        }}},
+      {"rtpTransceiverSetDirection",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("rtpTransceiverSetDirection",
+                          "rtpTransceiverSetDirection() peerConnection is "
+                          "null");
+            return;
+          }
+
+          const std::string& transceiverId =
+              findStringRef(params, "transceiverId");
+          if (transceiverId.empty()) {
+            result->Error("rtpTransceiverSetDirection",
+                          "rtpTransceiverSetDirection() transceiverId is "
+                          "null or empty");
+            return;
+          }
+
+          const std::string& direction = findStringRef(params, "direction");
+          if (transceiverId.empty()) {
+            result->Error("rtpTransceiverSetDirection",
+                          "rtpTransceiverSetDirection() direction is null or "
+                          "empty");
+            return;
+          }
+
+          self->RtpTransceiverSetDirection(pc, transceiverId, direction,
+                                           std::move(result));
+        }}},
+      {"setConfiguration",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("setConfiguration",
+                          "setConfiguration() peerConnection is null");
+            return;
+          }
+
+          const EncodableMap& configuration =
+              findMapRef(params, "configuration");
+          if (configuration.empty()) {
+            result->Error("setConfiguration",
+                          "setConfiguration() configuration is null or empty");
+            return;
+          }
+          self->SetConfiguration(pc, configuration, std::move(result));
+        }}},
+      {"captureFrame",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& path = findStringRef(params, "path");
+          if (path.empty()) {
+            result->Error("captureFrame",
+                          "captureFrame() path is null or empty");
+            return;
+          }
+
+          const std::string& trackId = findStringRef(params, "trackId");
+          RTCMediaTrack* track = self->MediaTrackForId(trackId);
+          if (nullptr == track) {
+            result->Error("captureFrame", "captureFrame() track is null");
+            return;
+          }
+          std::string kind = track->kind().std_string();
+          if (0 != kind.compare("video")) {
+            result->Error("captureFrame",
+                          "captureFrame() track not is video track");
+            return;
+          }
+          const int* count = findPtr<int>(params, "count");
+          const int* timeout_ms = findPtr<int>(params, "timeoutMs");
+          if (count != nullptr && *count < 1) {
+            result->Error("captureFrame", "captureFrame() count must be > 0");
+            return;
+          }
+          self->CaptureFrame(
+              reinterpret_cast<RTCVideoTrack*>(track), path,
+              count != nullptr ? *count : 1,
+              std::chrono::milliseconds(timeout_ms != nullptr ? *timeout_ms
+                                                              : 5000),
+              std::move(result));
+        }}},
+      {"subscribeStats",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const int* subscriptionId = findPtr<int>(params, "subscriptionId");
+          const int* intervalMs = findPtr<int>(params, "intervalMs");
+          if (subscriptionId == nullptr ||
+              (intervalMs != nullptr && *intervalMs < 1)) {
+            result->Error("subscribeStats",
+                          "subscribeStats() subscriptionId or intervalMs is "
+                          "invalid");
+            return;
+          }
+          self->SubscribeStats(
+              findStringRef(params, "peerConnectionId"), *subscriptionId,
+              findListRef(params, "fields"),
+              std::chrono::milliseconds(intervalMs != nullptr ? *intervalMs
+                                                              : 1000),
+              std::move(result));
+        }}},
+      {"unsubscribeStats",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->UnsubscribeStats(findInt(params, "subscriptionId"),
+                                 std::move(result));
+        }}},
+      {"startRecordToFile",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& path = findStringRef(params, "path");
+          const int* recorderId = findPtr<int>(params, "recorderId");
+          if (path.empty() || recorderId == nullptr) {
+            result->Error("startRecordToFile",
+                          "startRecordToFile() path or recorderId is missing");
+            return;
+          }
+          const std::string& trackId = findStringRef(params, "videoTrackId");
+          RTCMediaTrack* track = self->MediaTrackForId(trackId);
+          if (nullptr == track || track->kind().std_string() != "video") {
+            // Only video is recorded, as raw frames.
+            result->Error("startRecordToFile",
+                          "startRecordToFile() needs a video track");
+            return;
+          }
+          self->StartRecordToFile(*recorderId,
+                                  reinterpret_cast<RTCVideoTrack*>(track),
+                                  path, std::move(result));
+        }}},
+      {"stopRecordToFile",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->StopRecordToFile(findInt(params, "recorderId"),
+                                 std::move(result));
+        }}},
+      {"getRecorderStats",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->GetRecorderStats(findInt(params, "recorderId"),
+                                 std::move(result));
+        }}},
+      {"createLocalMediaStream",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          self->CreateLocalMediaStream(std::move(result));
+        }}},
+      {"canInsertDtmf",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("canInsertDtmf",
+                          "canInsertDtmf() peerConnection is null");
+            return;
+          }
+
+          auto rtpSender = self->GetRtpSenderById(pc, rtpSenderId);
+
+          if (rtpSender == nullptr) {
+            result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+            return;
+          }
+          auto dtmfSender = rtpSender->dtmf_sender();
+          bool canInsertDtmf = dtmfSender->CanInsertDtmf();
+
+          result->Success(EncodableValue(canInsertDtmf));
+        }}},
+      {"sendDtmf",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          const std::string& rtpSenderId = findStringRef(params, "rtpSenderId");
+          const std::string& tone = findStringRef(params, "tone");
+          int duration = findInt(params, "duration");
+          int gap = findInt(params, "gap");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("sendDtmf", "sendDtmf() peerConnection is null");
+            return;
+          }
+
+          auto rtpSender = self->GetRtpSenderById(pc, rtpSenderId);
+
+          if (rtpSender == nullptr) {
+            result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+            return;
+          }
+
+          auto dtmfSender = rtpSender->dtmf_sender();
+          dtmfSender->InsertDtmf(tone, duration, gap);
+
+          result->Success();
+        }}},
+      {"getRtpSenderCapabilities",
+       {"Null arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          RTCMediaType mediaType = RTCMediaType::AUDIO;
+          const std::string& kind = findStringRef(params, "kind");
+          if (0 == kind.compare("video")) {
+            mediaType = RTCMediaType::VIDEO;
+          } else if (0 == kind.compare("audio")) {
+            mediaType = RTCMediaType::AUDIO;
+          } else {
+            result->Error("getRtpSenderCapabilities",
+                          "getRtpSenderCapabilities() kind is null or empty");
+            return;
+          }
+          auto capabilities =
+              self->factory_->GetRtpSenderCapabilities(mediaType);
+          EncodableMap map;
+          EncodableList codecsList;
+          for (auto codec : capabilities->codecs().std_vector()) {
+            EncodableMap codecMap;
+            codecMap[EncodableValue("mimeType")] =
+                EncodableValue(codec->mime_type().std_string());
+            codecMap[EncodableValue("clockRate")] =
+                EncodableValue(codec->clock_rate());
+            codecMap[EncodableValue("channels")] =
+                EncodableValue(codec->channels());
+            codecMap[EncodableValue("sdpFmtpLine")] =
+                EncodableValue(codec->sdp_fmtp_line().std_string());
+            codecsList.push_back(EncodableValue(codecMap));
+          }
+          map[EncodableValue("codecs")] = EncodableValue(codecsList);
+          map[EncodableValue("headerExtensions")] =
+              EncodableValue(EncodableList());
+          map[EncodableValue("fecMechanisms")] =
+              EncodableValue(EncodableList());
+
+          result->Success(EncodableValue(map));
+        }}},
+      {"getRtpReceiverCapabilities",
+       {nullptr,
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          RTCMediaType mediaType = RTCMediaType::AUDIO;
+          const std::string& kind = findStringRef(params, "kind");
+          if (0 == kind.compare("video")) {
+            mediaType = RTCMediaType::VIDEO;
+          } else if (0 == kind.compare("audio")) {
+            mediaType = RTCMediaType::AUDIO;
+          } else {
+            result->Error("getRtpSenderCapabilities",
+                          "getRtpSenderCapabilities() kind is null or empty");
+            return;
+          }
+          auto capabilities =
+              self->factory_->GetRtpReceiverCapabilities(mediaType);
+          EncodableMap map;
+          EncodableList codecsList;
+          for (auto codec : capabilities->codecs().std_vector()) {
+            EncodableMap codecMap;
+            codecMap[EncodableValue("mimeType")] =
+                EncodableValue(codec->mime_type().std_string());
+            codecMap[EncodableValue("clockRate")] =
+                EncodableValue(codec->clock_rate());
+            codecMap[EncodableValue("channels")] =
+                EncodableValue(codec->channels());
+            codecMap[EncodableValue("sdpFmtpLine")] =
+                EncodableValue(codec->sdp_fmtp_line().std_string());
+            codecsList.push_back(EncodableValue(codecMap));
+          }
+          map[EncodableValue("codecs")] = EncodableValue(codecsList);
+          map[EncodableValue("headerExtensions")] =
+              EncodableValue(EncodableList());
+          map[EncodableValue("fecMechanisms")] =
+              EncodableValue(EncodableList());
+
+          result->Success(EncodableValue(map));
+        }}},
+      {"setCodecPreferences",
+       {"Null arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("setCodecPreferences",
+                          "setCodecPreferences() peerConnection is null");
+            return;
+          }
+
+          const std::string& transceiverId =
+              findStringRef(params, "transceiverId");
+          if (transceiverId.empty()) {
+            result->Error("setCodecPreferences",
+                          "setCodecPreferences() transceiverId is null or "
+                          "empty");
+            return;
+          }
+
+          const EncodableList& codecs = findListRef(params, "codecs");
+          if (codecs.empty()) {
+            result->Error("Bad Arguments", "Codecs is required");
+            return;
+          }
+          self->RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
+                                            std::move(result));
+        }}},
+      {"getSignalingState",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getSignalingState",
+                          "getSignalingState() peerConnection is null");
+            return;
+          }
+          EncodableMap state;
+          state[EncodableValue("state")] =
+              signalingStateString(pc->signaling_state());
+          result->Success(EncodableValue(state));
+        }}},
+      {"getIceGatheringState",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getIceGatheringState",
+                          "getIceGatheringState() peerConnection is null");
+            return;
+          }
+          EncodableMap state;
+          state[EncodableValue("state")] =
+              iceGatheringStateString(pc->ice_gathering_state());
+          result->Success(EncodableValue(state));
+        }}},
+      {"getIceConnectionState",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getIceConnectionState",
+                          "getIceConnectionState() peerConnection is null");
+            return;
+          }
+          EncodableMap state;
+          state[EncodableValue("state")] =
+              iceConnectionStateString(pc->ice_connection_state());
+          result->Success(EncodableValue(state));
+        }}},
+      {"getConnectionState",
+       {"Null constraints arguments received",
+        [](FlutterWebRTC* self, const EncodableMap& params,
+           std::unique_ptr<MethodResultProxy> result) {
+          const std::string& peerConnectionId =
+              findStringRef(params, "peerConnectionId");
+
+          RTCPeerConnection* pc = self->PeerConnectionForId(peerConnectionId);
+          if (pc == nullptr) {
+            result->Error("getConnectionState",
+                          "getConnectionState() peerConnection is null");
+            return;
+          }
+          EncodableMap state;
+          state[EncodableValue("state")] =
+              peerConnectionStateString(pc->peer_connection_state());
+          result->Success(EncodableValue(state));
+        }}},
+  };
+
+  auto it = methods.find(method_call.method_name());
+  if (it != methods.end()) {
+    static const EncodableMap no_arguments;
+    const EncodableValue* arguments = method_call.arguments();
+    const EncodableMap* params =
+        arguments ? std::get_if<EncodableMap>(arguments) : nullptr;
+    if (params == nullptr) {
+      if (it->second.missing_arguments != nullptr) {
+        result->Error("Bad Arguments", it->second.missing_arguments);
+        return;
+      }
+      params = &no_arguments;
     }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        peerConnectionStateString(pc->peer_connection_state());
-    result->Success(EncodableValue(state));
-
-  } else if (HandleDriverInterfaceMethodCall(method_call, result)) {
-    // Do nothing
-
-  } else if (HandleFrameCryptorMethodCall(method_call, std::move(result))) {
-    // Do nothing
+    it->second.handler(this, *params, std::move(result));
+  } else if (HandleDriverInterfaceMethodCall(method_call, result, this)) {
+    return;
+  } else if (HandleFrameCryptorMethodCall(method_call, result)) {
+    return;
   } else {
     result->NotImplemented();
   }
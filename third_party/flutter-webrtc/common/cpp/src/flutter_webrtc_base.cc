@@ -1,6 +1,7 @@
 #include "flutter_webrtc_base.h"
 
 #include "flutter_data_channel.h"
+#include "flutter_event_bus.h"
 #include "flutter_peerconnection.h"
 
 namespace flutter_webrtc_plugin {
@@ -10,6 +11,8 @@ const char* kEventChannelName = "FlutterWebRTC.Event";
 FlutterWebRTCBase::FlutterWebRTCBase(BinaryMessenger* messenger,
                                      TextureRegistrar* textures)
     : messenger_(messenger), textures_(textures) {
+  // Constructed on the platform thread, events are delivered there.
+  EventBus::Start();
   LibWebRTC::Initialize();
   factory_ = LibWebRTC::CreateRTCPeerConnectionFactory();
   audio_device_ = factory_->GetAudioDevice();
@@ -0,0 +1,20 @@
+import 'package:flutter/services.dart';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:integration_test/integration_test.dart';
+
+// Runs against the native plugin, e.g.
+// flutter test integration_test/method_channel_test.dart -d linux
+void main() {
+  IntegrationTestWidgetsFlutterBinding.ensureInitialized();
+  const channel = MethodChannel('FlutterWebRTC.Method');
+
+  // A method no handler table knows falls through to NotImplemented,
+  // which must still own the result after the frame cryptor lookup.
+  test('unknown methods are not implemented', () async {
+    await expectLater(channel.invokeMethod('noSuchMethod', <String, dynamic>{}),
+        throwsA(isA<MissingPluginException>()));
+    await expectLater(channel.invokeMethod('DriverInterface::Release'),
+        throwsA(isA<MissingPluginException>()));
+  });
+}
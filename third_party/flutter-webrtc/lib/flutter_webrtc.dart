@@ -16,6 +16,7 @@ export 'src/native/factory_impl.dart'
 export 'src/native/ios/audio_configuration.dart';
 export 'src/native/rtc_video_renderer_impl.dart'
     if (dart.library.html) 'src/web/rtc_video_renderer_impl.dart';
+export 'src/native/stats_subscription.dart';
 export 'src/native/rtc_video_view_impl.dart'
     if (dart.library.html) 'src/web/rtc_video_view_impl.dart';
 export 'src/native/utils.dart' if (dart.library.html) 'src/web/utils.dart';
@@ -13,6 +13,169 @@ class DriverInterfaceDevice {
   String toString() => "$deviceName: $devicePath";
 }
 
+class FramePoolStats {
+  FramePoolStats({
+    required this.hits,
+    required this.misses,
+    required this.buffers,
+    required this.inUse,
+  });
+
+  /// Buffers served from the pool without allocating.
+  final int hits;
+
+  /// Buffers that had to be allocated.
+  final int misses;
+
+  /// Buffers currently owned by the pool.
+  final int buffers;
+
+  /// Pooled buffers currently in use.
+  final int inUse;
+
+  @override
+  String toString() =>
+      "hits: $hits, misses: $misses, buffers: $buffers, inUse: $inUse";
+}
+
+/// How frames are queued when the virtual camera driver falls behind.
+enum DeliveryPolicy {
+  /// Keep only the newest frame.
+  latest,
+
+  /// Keep up to `capacity` frames, dropping the oldest when full.
+  ring,
+
+  /// Keep up to `capacity` frames, blocking the renderer when full.
+  block,
+}
+
+class VideoProcessingStats {
+  VideoProcessingStats({
+    this.output = 0,
+    required this.enqueued,
+    required this.dropped,
+    required this.delivered,
+    this.sent = 0,
+    this.skipped = 0,
+    this.sentPerSecond = 0,
+    this.skippedPerSecond = 0,
+  });
+
+  /// Handle of the output the counters belong to.
+  final int output;
+
+  /// Frames queued for the driver.
+  final int enqueued;
+
+  /// Frames replaced by a newer frame before being delivered.
+  final int dropped;
+
+  /// Frames delivered to the driver.
+  final int delivered;
+
+  /// Delivered frames written to the virtual camera.
+  final int sent;
+
+  /// Delivered frames skipped without converting them, because no app was
+  /// reading the virtual camera.
+  final int skipped;
+
+  /// Frames written to the virtual camera over the last second.
+  final int sentPerSecond;
+
+  /// Frames skipped over the last second, all of them while the camera is idle.
+  final int skippedPerSecond;
+
+  @override
+  String toString() =>
+      "output: $output, enqueued: $enqueued, dropped: $dropped, delivered: $delivered, "
+      "sent: $sentPerSecond/s, skipped: $skippedPerSecond/s";
+}
+
+class VideoOutputError {
+  VideoOutputError({required this.output, required this.message});
+
+  /// Handle of the output that failed.
+  final int output;
+
+  /// The error, empty once the output delivers frames again.
+  final String message;
+
+  @override
+  String toString() => "output $output: $message";
+}
+
+/// A virtual camera output, fed by its own worker thread.
+///
+/// [DriverInterface.defaultOutput] always exists and shows the most recently
+/// rendered video track. Outputs from [DriverInterface.createOutput] only
+/// show the track set with [setVideoTrack].
+class VideoOutput {
+  const VideoOutput._(this.handle);
+
+  final int handle;
+
+  static const MethodChannel _methodChannel =
+      MethodChannel('FlutterWebRTC.Method');
+
+  Future<void> _invoke(String method, [Map<String, dynamic>? args]) async {
+    try {
+      await _methodChannel.invokeMethod(method, {...?args, 'output': handle});
+    } on PlatformException catch (error) {
+      throw '${error.code} Error: ${error.message}';
+    }
+  }
+
+  /// Sets the device this output sends to.
+  ///
+  /// Throws: Exception on failure.
+  Future<void> setDevice(DriverInterfaceDevice device) => _invoke(
+      'DriverInterface::SetDevice', {'devicePath': device.devicePath});
+
+  /// Stops sending to the device.
+  Future<void> destroyDevice() => _invoke('DriverInterface::DestroyDevice');
+
+  /// Sets the video track shown by this output, null to detach.
+  ///
+  /// Throws: Exception on failure.
+  Future<void> setVideoTrack(String? trackId) =>
+      _invoke('DriverInterface::SetVideoTrack', {'trackId': trackId ?? ''});
+
+  /// Starts sending video frames to the driver.
+  Future<void> startVideoProcessing() =>
+      _invoke('DriverInterface::StartVideoProcessing');
+
+  /// Stops sending video frames to the driver.
+  Future<void> stopVideoProcessing() =>
+      _invoke('DriverInterface::StopVideoProcessing');
+
+  /// Sets how frames are queued when the driver falls behind.
+  ///
+  /// Parameters:
+  /// - [policy]: The delivery policy to use.
+  /// - [capacity]: Maximum pending frames, ignored for [DeliveryPolicy.latest].
+  Future<void> setDeliveryPolicy(DeliveryPolicy policy, {int capacity = 1}) =>
+      _invoke('DriverInterface::SetDeliveryPolicy',
+          {'policy': policy.name, 'capacity': capacity});
+
+  /// Caps the resolution sent to the virtual camera, larger frames are
+  /// scaled down natively keeping their aspect ratio.
+  ///
+  /// Parameters:
+  /// - [width]: Maximum width, 0 for no limit.
+  /// - [height]: Maximum height, 0 for no limit.
+  Future<void> setMaxResolution(int width, int height) =>
+      _invoke('DriverInterface::SetMaxResolution',
+          {'width': width, 'height': height});
+
+  /// Stops the output and releases it, the default output is only reset.
+  Future<void> release() => _invoke('DriverInterface::ReleaseOutput');
+
+  @override
+  String toString() => "VideoOutput($handle)";
+}
+
 class DriverInterface {
   static const MethodChannel _methodChannel =
       MethodChannel('FlutterWebRTC.Method');
@@ -40,25 +203,27 @@ class DriverInterface {
     }
   }
 
-  /// Sets the active video device.
+  /// The default output, it shows the most recently rendered video track.
+  static const VideoOutput defaultOutput = VideoOutput._(0);
+
+  /// Creates an additional virtual camera output.
+  static Future<VideoOutput> createOutput() async {
+    final int handle =
+        await _methodChannel.invokeMethod('DriverInterface::CreateOutput');
+    return VideoOutput._(handle);
+  }
+
+  /// Sets the device of the default output.
   ///
   /// Parameters:
   /// - [device]: The device to set as the active device.
   ///
   /// Throws: Exception on failure.
-  static Future<void> setDevice(DriverInterfaceDevice device) async {
-    try {
-      await _methodChannel.invokeMethod(
-          'DriverInterface::SetDevice', {'devicePath': device.devicePath});
-    } on PlatformException catch (error) {
-      throw '${error.code} Error: ${error.message}';
-    }
-  }
+  static Future<void> setDevice(DriverInterfaceDevice device) =>
+      defaultOutput.setDevice(device);
 
-  /// Destroys the active video device.
-  static Future<void> destroyDevice() async {
-    await _methodChannel.invokeMethod('DriverInterface::DestroyDevice');
-  }
+  /// Destroys the device of the default output.
+  static Future<void> destroyDevice() => defaultOutput.destroyDevice();
 
   /// Releases active resources.
   /// Including the COM library and active devices.
@@ -66,22 +231,69 @@ class DriverInterface {
     await _methodChannel.invokeMethod('DriverInterface::Release');
   }
 
-  /// Starts sending video frames to the driver.
-  static Future<void> startVideoProcessing() async {
-    await _methodChannel.invokeMethod('DriverInterface::StartVideoProcessing');
-  }
+  /// Starts sending video frames of the default output to the driver.
+  static Future<void> startVideoProcessing() =>
+      defaultOutput.startVideoProcessing();
 
-  /// Stops sending video frames to the driver.
-  static Future<void> stopVideoProcessing() async {
-    await _methodChannel.invokeMethod('DriverInterface::StopVideoProcessing');
+  /// Stops sending video frames of the default output to the driver.
+  static Future<void> stopVideoProcessing() =>
+      defaultOutput.stopVideoProcessing();
+
+  /// Gets the frame buffer pool counters.
+  static Future<FramePoolStats> getFramePoolStats() async {
+    final Map<dynamic, dynamic> response =
+        await _methodChannel.invokeMethod('DriverInterface::GetFramePoolStats');
+
+    return FramePoolStats(
+      hits: response['hits'],
+      misses: response['misses'],
+      buffers: response['buffers'],
+      inUse: response['inUse'],
+    );
   }
 
-  static Stream<String>? _videoProcessingErrorStream;
+  /// Sets how frames of the default output are queued when the driver falls behind.
+  static Future<void> setDeliveryPolicy(DeliveryPolicy policy,
+          {int capacity = 1}) =>
+      defaultOutput.setDeliveryPolicy(policy, capacity: capacity);
 
-  static Stream<String> get errorStream {
-    _videoProcessingErrorStream ??= _eventChannel
-        .receiveBroadcastStream()
-        .map((dynamic result) => result.toString());
-    return _videoProcessingErrorStream!;
+  /// Caps the resolution the default output sends to the virtual camera.
+  static Future<void> setMaxResolution(int width, int height) =>
+      defaultOutput.setMaxResolution(width, height);
+
+  static Stream<dynamic>? _videoProcessingEventStream;
+
+  static Stream<dynamic> get _eventStream {
+    _videoProcessingEventStream ??= _eventChannel.receiveBroadcastStream();
+    return _videoProcessingEventStream!;
   }
+
+  /// Errors of all outputs.
+  static Stream<VideoOutputError> get outputErrorStream => _eventStream
+      .where((dynamic event) =>
+          event is Map && event['event'] == 'videoProcessingError')
+      .map((dynamic event) => VideoOutputError(
+            output: event['output'],
+            message: event['message'],
+          ));
+
+  /// Errors of the default output, an empty message once it recovers.
+  static Stream<String> get errorStream => outputErrorStream
+      .where((error) => error.output == defaultOutput.handle)
+      .map((error) => error.message);
+
+  /// Frame delivery counters, reported at most once per second.
+  static Stream<VideoProcessingStats> get statsStream => _eventStream
+      .where((dynamic event) =>
+          event is Map && event['event'] == 'videoProcessingStats')
+      .map((dynamic event) => VideoProcessingStats(
+            output: event['output'] ?? 0,
+            enqueued: event['enqueued'],
+            dropped: event['dropped'],
+            delivered: event['delivered'],
+            sent: event['sent'] ?? 0,
+            skipped: event['skipped'] ?? 0,
+            sentPerSecond: event['sentPerSecond'] ?? 0,
+            skippedPerSecond: event['skippedPerSecond'] ?? 0,
+          ));
 }
@@ -38,7 +38,21 @@ class MediaRecorderNative extends MediaRecorder {
     throw 'It\'s for Flutter Web only';
   }
 
+  /// On Windows and Linux, completes with the final recorder stats, see
+  /// [stats].
   @override
   Future<dynamic> stop() async => await WebRTC.invokeMethod(
       'stopRecordToFile', {'recorderId': _recorderId});
+
+  /// Counters of a running recording, Windows and Linux only. There a
+  /// '.y4m' path records raw I420 frames and any other path raw NV12 frames,
+  /// with per frame offsets and arrival times in '<path>.idx'.
+  ///
+  /// framesDropped counts frames skipped because the disk couldn't keep up,
+  /// framesResized those skipped because their size differs from the first.
+  Future<Map<String, dynamic>> stats() async {
+    final response = await WebRTC.invokeMethod(
+        'getRecorderStats', {'recorderId': _recorderId});
+    return Map<String, dynamic>.from(response as Map);
+  }
 }
@@ -99,6 +99,49 @@ class MediaStreamTrackNative extends MediaStreamTrack {
         .then((value) => value.buffer);
   }
 
+  /// Captures the next [count] frames, reusing one frame sink natively.
+  ///
+  /// Returns the frames that arrived within [timeout] as PNG bytes, throws if
+  /// none did. Platforms without burst support return a single frame.
+  Future<List<ByteBuffer>> captureFrames(int count,
+      {Duration timeout = const Duration(seconds: 5)}) async {
+    final frames = await _captureFrames('captureFrames.png', count, timeout);
+    return frames.map((frame) => frame.data).toList();
+  }
+
+  /// Like [captureFrames], but returns the raw I420 planes of each frame
+  /// instead of encoding them, which is several times cheaper natively.
+  /// Only supported on Windows and Linux.
+  Future<List<CapturedFrame>> captureI420Frames(int count,
+          {Duration timeout = const Duration(seconds: 5)}) =>
+      _captureFrames('captureFrames.yuv', count, timeout);
+
+  Future<List<CapturedFrame>> _captureFrames(
+      String name, int count, Duration timeout) async {
+    var filePath = await getTemporaryDirectory();
+    final path = '${filePath.path}/$name';
+    final response = await WebRTC.invokeMethod(
+      'captureFrame',
+      <String, dynamic>{
+        'trackId': _trackId,
+        'peerConnectionId': _peerConnectionId,
+        'path': path,
+        'count': count,
+        'timeoutMs': timeout.inMilliseconds,
+      },
+    );
+    final saved = response is List
+        ? response.cast<Map<dynamic, dynamic>>()
+        : [
+            <String, dynamic>{'path': path, 'width': 0, 'height': 0}
+          ];
+    return Future.wait(saved.map((info) async {
+      final bytes = await File(info['path'] as String).readAsBytes();
+      return CapturedFrame._(
+          info['width'] as int, info['height'] as int, bytes.buffer);
+    }));
+  }
+
   @override
   Future<void> applyConstraints([Map<String, dynamic>? constraints]) {
     if (constraints == null) return Future.value();
@@ -130,3 +173,14 @@ class MediaStreamTrackNative extends MediaStreamTrack {
     );
   }
 }
+
+/// A captured frame and its size. Frames from
+/// [MediaStreamTrackNative.captureI420Frames] hold the Y plane, then the U
+/// and V planes at half resolution, tightly packed.
+class CapturedFrame {
+  CapturedFrame._(this.width, this.height, this.data);
+
+  final int width;
+  final int height;
+  final ByteBuffer data;
+}
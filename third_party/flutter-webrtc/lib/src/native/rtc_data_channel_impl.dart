@@ -1,4 +1,6 @@
 import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
 
 import 'package:flutter/services.dart';
 
@@ -11,6 +13,13 @@ final _typeStringToMessageType = <String, MessageType>{
   'binary': MessageType.binary
 };
 
+// Kinds of the one byte header starting each frame on the frame channel,
+// matching DataChannelFrameKind on the native side.
+const int _frameBinary = 0;
+const int _frameText = 1;
+const int _frameAttach = 2;
+const int _frameHeaderSize = 1;
+
 /// A class that represents a WebRTC datachannel.
 /// Can send and receive text and binary messages.
 class RTCDataChannelNative extends RTCDataChannel {
@@ -25,6 +34,14 @@ class RTCDataChannelNative extends RTCDataChannel {
     _eventSubscription = _eventChannelFor(_peerConnectionId, _flutterId)
         .receiveBroadcastStream()
         .listen(eventListener, onError: errorListener);
+    if (WebRTC.platformIsWindows || WebRTC.platformIsLinux) {
+      _frameChannel = BasicMessageChannel<ByteData>(
+          'FlutterWebRTC/dataChannelFrame$_peerConnectionId$_flutterId',
+          const BinaryCodec())
+        ..setMessageHandler(frameListener);
+      // Messages received until now were queued as events.
+      _frameChannel!.send(_frame(_frameAttach, const <int>[]));
+    }
   }
   final String _peerConnectionId;
   final String _label;
@@ -40,6 +57,10 @@ class RTCDataChannelNative extends RTCDataChannel {
   RTCDataChannelState? _state;
   StreamSubscription<dynamic>? _eventSubscription;
 
+  /// Carries message payloads without the method codec, null on platforms
+  /// using dataChannelSend and events.
+  BasicMessageChannel<ByteData>? _frameChannel;
+
   @override
   RTCDataChannelState? get state => _state;
 
@@ -98,6 +119,31 @@ class RTCDataChannelNative extends RTCDataChannel {
     }
   }
 
+  /// Frame channel listener, for messages received after attaching.
+  Future<ByteData?> frameListener(ByteData? frame) async {
+    if (frame == null || frame.lengthInBytes < _frameHeaderSize) {
+      return null;
+    }
+    final payload = frame.buffer.asUint8List(
+        frame.offsetInBytes + _frameHeaderSize,
+        frame.lengthInBytes - _frameHeaderSize);
+    final message = frame.getUint8(0) == _frameBinary
+        ? RTCDataChannelMessage.fromBinary(payload)
+        : RTCDataChannelMessage(utf8.decode(payload));
+
+    onMessage?.call(message);
+
+    _messageController.add(message);
+    return null;
+  }
+
+  static ByteData _frame(int kind, List<int> payload) {
+    final frame = Uint8List(_frameHeaderSize + payload.length);
+    frame[0] = kind;
+    frame.setRange(_frameHeaderSize, frame.length, payload);
+    return frame.buffer.asByteData();
+  }
+
   EventChannel _eventChannelFor(String peerConnectionId, String flutterId) {
     return EventChannel(
         'FlutterWebRTC/dataChannelEvent$peerConnectionId$flutterId');
@@ -111,6 +157,13 @@ class RTCDataChannelNative extends RTCDataChannel {
 
   @override
   Future<void> send(RTCDataChannelMessage message) async {
+    final frameChannel = _frameChannel;
+    if (frameChannel != null) {
+      await frameChannel.send(message.isBinary
+          ? _frame(_frameBinary, message.binary)
+          : _frame(_frameText, utf8.encode(message.text)));
+      return;
+    }
     await WebRTC.invokeMethod('dataChannelSend', <String, dynamic>{
       'peerConnectionId': _peerConnectionId,
       'dataChannelId': _flutterId,
@@ -124,6 +177,7 @@ class RTCDataChannelNative extends RTCDataChannel {
     await _stateChangeController.close();
     await _messageController.close();
     await _eventSubscription?.cancel();
+    _frameChannel?.setMessageHandler(null);
     await WebRTC.invokeMethod('dataChannelClose', <String, dynamic>{
       'peerConnectionId': _peerConnectionId,
       'dataChannelId': _flutterId
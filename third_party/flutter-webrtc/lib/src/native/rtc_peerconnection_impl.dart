@@ -11,6 +11,7 @@ import 'rtc_dtmf_sender_impl.dart';
 import 'rtc_rtp_receiver_impl.dart';
 import 'rtc_rtp_sender_impl.dart';
 import 'rtc_rtp_transceiver_impl.dart';
+import 'stats_subscription.dart';
 import 'utils.dart';
 
 /*
@@ -470,6 +471,12 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Pushes [fields] of this connection's stats every [interval] instead of
+  /// polling [getStats], see [StatsSubscription]. Windows and Linux only.
+  Future<StatsSubscription> subscribeStats(List<String> fields,
+          {Duration interval = const Duration(seconds: 1)}) =>
+      StatsSubscription.start(_peerConnectionId, fields, interval);
+
   @override
   List<MediaStream> getLocalStreams() {
     return _localStreams;
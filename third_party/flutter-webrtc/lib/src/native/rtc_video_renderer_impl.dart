@@ -108,6 +108,38 @@ class RTCVideoRenderer extends ValueNotifier<RTCVideoValue>
     return super.dispose();
   }
 
+  /// Desktop only: limits the preview on top of its on-screen size.
+  ///
+  /// Frames are already scaled to the displayed size while converting, this
+  /// caps them further, e.g. for thumbnails that don't need every frame.
+  /// 0 means no limit.
+  Future<void> setPreviewPolicy(
+      {int maxWidth = 0, int maxHeight = 0, int maxFps = 0}) async {
+    if (_textureId == null) return;
+    await WebRTC.invokeMethod(
+        'videoRendererSetPreviewPolicy', <String, dynamic>{
+      'textureId': _textureId,
+      'maxWidth': maxWidth,
+      'maxHeight': maxHeight,
+      'maxFps': maxFps,
+    });
+  }
+
+  /// Desktop only: counters of the native renderer, all cumulative.
+  ///
+  /// - frames: new frames, each converted once off the raster thread.
+  /// - pulls: times the engine pulled the texture.
+  /// - repeatPulls: pulls without a new frame, served without conversion.
+  /// - pullTimeUs, maxPullTimeUs: raster thread time spent per pull.
+  /// - convertTimeUs: time spent scaling and converting frames.
+  /// - width, height: size of the last converted frame.
+  Future<Map<String, int>> getRendererStats() async {
+    if (_textureId == null) return const {};
+    final response = await WebRTC.invokeMethod(
+        'videoRendererGetStats', <String, dynamic>{'textureId': _textureId});
+    return Map<String, int>.from(response);
+  }
+
   void eventListener(dynamic event) {
     if (_disposed) return;
     final Map<dynamic, dynamic> map = event;
@@ -0,0 +1,120 @@
+import 'dart:async';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+import 'utils.dart';
+
+/// One member of one stats report, a column of a [StatsSubscription].
+class StatsColumn {
+  StatsColumn(this.reportId, this.type, this.member);
+
+  final String reportId;
+  final String type;
+  final String member;
+}
+
+/// Stats of a peer connection pushed by the plugin at a fixed interval,
+/// Windows and Linux only.
+///
+/// The plugin describes each column once and afterwards only sends the
+/// values that changed, as typed arrays, every interval even if none did.
+/// [updates] fires after each of them with the subscription itself, read
+/// it through [value] and [rate].
+class StatsSubscription {
+  StatsSubscription._(this._id) {
+    _eventSubscription = EventChannel('FlutterWebRTC/statsSubscription$_id')
+        .receiveBroadcastStream()
+        .listen(_onEvent);
+  }
+
+  static final _random = Random();
+
+  /// Starts pushing [fields] of the peer connection every [interval]. Fields
+  /// are '<report type>.<member>', e.g. 'inbound-rtp.jitter' or
+  /// 'candidate-pair.currentRoundTripTime', and must be numeric or boolean.
+  static Future<StatsSubscription> start(
+      String peerConnectionId, List<String> fields, Duration interval) async {
+    final subscription = StatsSubscription._(_random.nextInt(0x7FFFFFFF));
+    try {
+      await WebRTC.invokeMethod('subscribeStats', <String, dynamic>{
+        'peerConnectionId': peerConnectionId,
+        'subscriptionId': subscription._id,
+        'fields': fields,
+        'intervalMs': interval.inMilliseconds,
+      });
+    } on PlatformException catch (e) {
+      await subscription._eventSubscription?.cancel();
+      throw 'Unable to RTCPeerConnection::subscribeStats: ${e.message}';
+    }
+    return subscription;
+  }
+
+  final int _id;
+  StreamSubscription<dynamic>? _eventSubscription;
+  final _updates = StreamController<StatsSubscription>.broadcast();
+  final _columns = <StatsColumn>[];
+  final _columnIndex = <String, int>{};
+  var _values = <double>[];
+  var _previous = <double>[];
+  int _timestampUs = 0;
+  int _previousTimestampUs = 0;
+
+  List<StatsColumn> get columns => List.unmodifiable(_columns);
+
+  Stream<StatsSubscription> get updates => _updates.stream;
+
+  /// Timestamp of the latest values, in microseconds.
+  int get timestampUs => _timestampUs;
+
+  /// The latest value of [member] in report [reportId], null until known.
+  double? value(String reportId, String member) {
+    final index = _columnIndex['$reportId\n$member'];
+    if (index == null || _values[index].isNaN) return null;
+    return _values[index];
+  }
+
+  /// The change of [member] per second between the last two updates, e.g.
+  /// bytes per second for 'bytesReceived'. Null until known.
+  double? rate(String reportId, String member) {
+    final index = _columnIndex['$reportId\n$member'];
+    if (index == null || index >= _previous.length) return null;
+    final elapsedUs = _timestampUs - _previousTimestampUs;
+    final change = _values[index] - _previous[index];
+    if (elapsedUs <= 0 || change.isNaN) return null;
+    return change * 1e6 / elapsedUs;
+  }
+
+  Future<void> cancel() async {
+    await _eventSubscription?.cancel();
+    await WebRTC.invokeMethod(
+        'unsubscribeStats', <String, dynamic>{'subscriptionId': _id});
+    await _updates.close();
+  }
+
+  void _onEvent(dynamic event) {
+    final Map<dynamic, dynamic> map = event;
+    switch (map['event']) {
+      case 'statsSchema':
+        for (final List<dynamic> column in map['columns']) {
+          _columnIndex['${column[0]}\n${column[2]}'] = _columns.length;
+          _columns.add(StatsColumn(column[0], column[1], column[2]));
+          _values.add(double.nan);
+        }
+        break;
+      case 'statsDelta':
+        final Int32List indices = map['indices'];
+        final Float64List values = map['values'];
+        _previous = _values;
+        _previousTimestampUs = _timestampUs;
+        _values = List.of(_values);
+        for (var i = 0; i < indices.length; i++) {
+          _values[indices[i]] = values[i];
+        }
+        _timestampUs = map['timestampUs'];
+        _updates.add(this);
+        break;
+    }
+  }
+}
@@ -0,0 +1,152 @@
+// Standard codec benchmark.
+//
+// Encodes and decodes the two message shapes that dominate the plugin's
+// traffic, a getStats result (a list of nested report maps) and a 1 MB
+// binary payload, and reports the time per message of:
+//   - encoding into a vector grown as it goes, as the codec did before it
+//     precomputed the encoded size, against StandardMessageCodec, which
+//     reserves the whole message up front;
+//   - decoding with StandardCodecSerializer::GetInstance(), which copies
+//     byte lists, against GetByteListViewInstance(), which the Linux
+//     method channel uses to read large byte lists in place.
+//
+// Usage: codec_bench [--runs N] [--reports N] [--payload BYTES]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <flutter/standard_message_codec.h>
+
+#include "byte_buffer_streams.h"
+
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+namespace {
+
+double NowMs() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Best time of |runs| calls of |body|, after one warm-up call.
+template <typename Body>
+double BestMs(int runs, Body body) {
+  body();
+  double best = 1e9;
+  for (int run = 0; run < runs; run++) {
+    const double start = NowMs();
+    body();
+    best = std::min(best, NowMs() - start);
+  }
+  return best;
+}
+
+// Shaped like FlutterPeerConnection::GetStats results: one map per report
+// with a nested map of its values.
+EncodableValue StatsMessage(int reports) {
+  EncodableList list;
+  for (int i = 0; i < reports; i++) {
+    EncodableMap values;
+    for (int v = 0; v < 30; v++) {
+      const std::string key = "metric" + std::to_string(v);
+      if (v % 3 == 0) {
+        values[EncodableValue(key)] = EncodableValue(v * 1.5 + i);
+      } else if (v % 3 == 1) {
+        values[EncodableValue(key)] = EncodableValue(int64_t(v) << 33);
+      } else {
+        values[EncodableValue(key)] =
+            EncodableValue("RTCInboundRTPVideoStream_" + std::to_string(i));
+      }
+    }
+    list.push_back(EncodableValue(EncodableMap{
+        {EncodableValue("id"), EncodableValue("RTC" + std::to_string(i))},
+        {EncodableValue("type"), EncodableValue("inbound-rtp")},
+        {EncodableValue("timestamp"), EncodableValue(1.7e15 + i)},
+        {EncodableValue("values"), EncodableValue(std::move(values))},
+    }));
+  }
+  return EncodableValue(EncodableMap{
+      {EncodableValue("stats"), EncodableValue(std::move(list))},
+  });
+}
+
+EncodableValue BinaryMessage(size_t payload) {
+  return EncodableValue(EncodableMap{
+      {EncodableValue("type"), EncodableValue("binary")},
+      {EncodableValue("data"),
+       EncodableValue(std::vector<uint8_t>(payload, 0x5A))},
+  });
+}
+
+std::vector<uint8_t> EncodeGrowing(const EncodableValue& message) {
+  std::vector<uint8_t> encoded;
+  flutter::ByteBufferStreamWriter stream(&encoded);
+  flutter::StandardCodecSerializer::GetInstance().WriteValue(message, &stream);
+  return encoded;
+}
+
+// Decodes |encoded| as the message being dispatched, so views can keep it
+// alive like they keep the GBytes of a platform message.
+EncodableValue Decode(const flutter::StandardMessageCodec& codec,
+                      const std::shared_ptr<std::vector<uint8_t>>& encoded) {
+  auto storage = encoded;
+  flutter::ScopedIncomingMessage incoming(
+      encoded->data(),
+      [](void* context) -> std::shared_ptr<const void> {
+        return *static_cast<std::shared_ptr<std::vector<uint8_t>>*>(context);
+      },
+      &storage);
+  return *codec.DecodeMessage(encoded->data(), encoded->size());
+}
+
+void Bench(const char* name, const EncodableValue& message, int runs) {
+  const auto& copying = flutter::StandardMessageCodec::GetInstance();
+  const auto& viewing = flutter::StandardMessageCodec::GetInstance(
+      &flutter::StandardCodecSerializer::GetByteListViewInstance());
+  auto encoded =
+      std::make_shared<std::vector<uint8_t>>(*copying.EncodeMessage(message));
+  if (EncodeGrowing(message) != *encoded) {
+    fprintf(stderr, "%s: encodings differ\n", name);
+    exit(1);
+  }
+
+  printf("%s, %zu bytes, best of %d\n", name, encoded->size(), runs);
+  printf("  encode growing      %8.3f ms\n",
+         BestMs(runs, [&] { EncodeGrowing(message); }));
+  printf("  encode reserved     %8.3f ms\n",
+         BestMs(runs, [&] { copying.EncodeMessage(message); }));
+  printf("  decode copying      %8.3f ms\n",
+         BestMs(runs, [&] { Decode(copying, encoded); }));
+  printf("  decode views        %8.3f ms\n",
+         BestMs(runs, [&] { Decode(viewing, encoded); }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int runs = 50, reports = 40;
+  size_t payload = 1024 * 1024;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+      runs = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--reports") && i + 1 < argc) {
+      reports = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--payload") && i + 1 < argc) {
+      payload = strtoul(argv[++i], nullptr, 10);
+    }
+  }
+
+  Bench("stats", StatsMessage(reports), runs);
+  Bench("binary", BinaryMessage(payload), runs);
+  return 0;
+}
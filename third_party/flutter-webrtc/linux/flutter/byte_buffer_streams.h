@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "include/flutter/byte_streams.h"
@@ -19,9 +20,12 @@ namespace flutter {
 class ByteBufferStreamReader : public ByteStreamReader {
  public:
   // Createa a reader reading from |bytes|, which must have a length of |size|.
-  // |bytes| must remain valid for the lifetime of this object.
-  explicit ByteBufferStreamReader(const uint8_t* bytes, size_t size)
-      : bytes_(bytes), size_(size) {}
+  // |bytes| must remain valid for the lifetime of this object, and for as
+  // long as |storage| is held if one is given.
+  explicit ByteBufferStreamReader(const uint8_t* bytes,
+                                  size_t size,
+                                  std::shared_ptr<const void> storage = nullptr)
+      : bytes_(bytes), size_(size), storage_(std::move(storage)) {}
 
   virtual ~ByteBufferStreamReader() = default;
 
@@ -52,11 +56,26 @@ class ByteBufferStreamReader : public ByteStreamReader {
     }
   }
 
+  // |ByteStreamReader|
+  const uint8_t* ReadView(size_t length) override {
+    if (!storage_ || location_ + length > size_) {
+      return nullptr;
+    }
+    const uint8_t* view = &bytes_[location_];
+    location_ += length;
+    return view;
+  }
+
+  // |ByteStreamReader|
+  std::shared_ptr<const void> storage() const override { return storage_; }
+
  private:
   // The buffer to read from.
   const uint8_t* bytes_;
   // The total size of the buffer.
   size_t size_;
+  // Keeps |bytes_| alive for views, null if they can't outlive the reader.
+  std::shared_ptr<const void> storage_;
   // The current read location.
   size_t location_ = 0;
 };
@@ -86,9 +105,7 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   void WriteAlignment(uint8_t alignment) {
     uint8_t mod = bytes_->size() % alignment;
     if (mod) {
-      for (int i = 0; i < alignment - mod; ++i) {
-        WriteByte(0);
-      }
+      bytes_->resize(bytes_->size() + alignment - mod);
     }
   }
 
@@ -97,6 +114,46 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   std::vector<uint8_t>* bytes_;
 };
 
+// Marks |bytes| as the platform message being dispatched on this thread
+// while in scope. Codecs decoding that message can ask for its storage and
+// return views into it that outlive the handler. |retain| is only called
+// then, with |context|, and must return a reference keeping |bytes| alive.
+class ScopedIncomingMessage {
+ public:
+  using Retain = std::shared_ptr<const void> (*)(void* context);
+
+  ScopedIncomingMessage(const uint8_t* bytes, Retain retain, void* context)
+      : previous_(current_) {
+    current_ = {bytes, retain, context};
+  }
+
+  ~ScopedIncomingMessage() { current_ = previous_; }
+
+  // Prevent copying.
+  ScopedIncomingMessage(ScopedIncomingMessage const&) = delete;
+  ScopedIncomingMessage& operator=(ScopedIncomingMessage const&) = delete;
+
+  // Returns a reference keeping |bytes| alive if they are the message being
+  // dispatched, otherwise nullptr.
+  static std::shared_ptr<const void> StorageFor(const uint8_t* bytes) {
+    if (bytes == nullptr || bytes != current_.bytes) {
+      return nullptr;
+    }
+    return current_.retain(current_.context);
+  }
+
+ private:
+  struct Message {
+    const uint8_t* bytes;
+    Retain retain;
+    void* context;
+  };
+
+  Message previous_;
+
+  static inline thread_local Message current_ = {nullptr, nullptr, nullptr};
+};
+
 }  // namespace flutter
 
 #endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_BYTE_BUFFER_STREAMS_H_
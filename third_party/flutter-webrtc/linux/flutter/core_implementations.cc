@@ -18,6 +18,7 @@
 #include <variant>
 
 #include "binary_messenger_impl.h"
+#include "byte_buffer_streams.h"
 #include "include/flutter/engine_method_result.h"
 #include "include/flutter/texture_registrar.h"
 #include "texture_registrar_impl.h"
@@ -115,9 +116,20 @@ static void ForwardToHandler(FlBinaryMessenger* messenger,
     return;
   }
 
-  message_handler(
-      static_cast<const uint8_t*>(g_bytes_get_data(message, nullptr)),
-      g_bytes_get_size(message), std::move(reply_handler));
+  const uint8_t* bytes =
+      static_cast<const uint8_t*>(g_bytes_get_data(message, nullptr));
+  // Lets codecs keep views into |message| past the handler.
+  ScopedIncomingMessage incoming(
+      bytes,
+      [](void* context) -> std::shared_ptr<const void> {
+        return std::shared_ptr<const void>(
+            g_bytes_ref(static_cast<GBytes*>(context)),
+            [](const void* bytes) {
+              g_bytes_unref(static_cast<GBytes*>(const_cast<void*>(bytes)));
+            });
+      },
+      message);
+  message_handler(bytes, g_bytes_get_size(message), std::move(reply_handler));
 }
 }  // namespace
 
@@ -7,6 +7,10 @@
 
 // Interfaces for interacting with a stream of bytes, for use in codecs.
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 namespace flutter {
 
 // An interface for a class that reads from a byte stream.
@@ -26,6 +30,14 @@ class ByteStreamReader {
   // the start of the stream, unless it is already aligned.
   virtual void ReadAlignment(uint8_t alignment) = 0;
 
+  // Returns the next |length| bytes in place and advances past them, or
+  // nullptr if the stream can't hand out views into its storage.
+  virtual const uint8_t* ReadView(size_t /*length*/) { return nullptr; }
+
+  // Returns what keeps the bytes returned by ReadView alive, or nullptr if
+  // they are only valid for as long as the stream.
+  virtual std::shared_ptr<const void> storage() const { return nullptr; }
+
   // Reads and returns the next 32-bit integer from the stream.
   int32_t ReadInt32() {
     int32_t value = 0;
@@ -5,11 +5,34 @@
 #ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_SERIALIZER_H_
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_SERIALIZER_H_
 
+#include <any>
+#include <cstdint>
+#include <memory>
+
 #include "byte_streams.h"
 #include "encodable_value.h"
 
 namespace flutter {
 
+// A read-only view of a byte list inside a received message, kept alive by
+// |storage|. Serializers from StandardCodecSerializer::GetByteListViewInstance
+// decode large kUInt8List values into a CustomEncodableValue holding one of
+// these instead of copying them into a std::vector<uint8_t>; writing one
+// encodes it as a regular byte list.
+struct ByteListView {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  std::shared_ptr<const void> storage;
+};
+
+// Returns the view held by |value|, or nullptr if it holds something else.
+inline const ByteListView* GetByteListView(const EncodableValue& value) {
+  const auto* custom = std::get_if<CustomEncodableValue>(&value);
+  return custom ? std::any_cast<ByteListView>(
+                      &static_cast<const std::any&>(*custom))
+                : nullptr;
+}
+
 // Encapsulates the logic for encoding/decoding EncodableValues to/from the
 // standard codec binary representation.
 //
@@ -22,6 +45,19 @@ class StandardCodecSerializer {
   // Returns the shared serializer instance.
   static const StandardCodecSerializer& GetInstance();
 
+  // Returns a shared serializer that reads byte lists of at least
+  // kByteListViewMinSize bytes as ByteListView values, when the stream can
+  // keep its storage alive. Everything else is read like GetInstance() does.
+  static const StandardCodecSerializer& GetByteListViewInstance();
+
+  // Byte lists smaller than this are cheaper to copy than to reference.
+  static constexpr size_t kByteListViewMinSize = 64 * 1024;
+
+  // Whether large byte lists are read as ByteListView values.
+  bool reads_byte_list_views() const {
+    return byte_list_view_min_size_ != SIZE_MAX;
+  }
+
   // Prevent copying.
   StandardCodecSerializer(StandardCodecSerializer const&) = delete;
   StandardCodecSerializer& operator=(StandardCodecSerializer const&) = delete;
@@ -68,7 +104,18 @@ class StandardCodecSerializer {
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the supported list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector, ByteStreamWriter* stream) const;
+  void WriteVector(const std::vector<T>& vector,
+                   ByteStreamWriter* stream) const;
+
+  // Writes the |size| bytes at |data| to |stream| as a byte list.
+  void WriteBytes(const uint8_t* data,
+                  size_t size,
+                  ByteStreamWriter* stream) const;
+
+  explicit StandardCodecSerializer(size_t byte_list_view_min_size);
+
+  // Byte lists of at least this size are read as views when possible.
+  size_t byte_list_view_min_size_ = SIZE_MAX;
 };
 
 }  // namespace flutter
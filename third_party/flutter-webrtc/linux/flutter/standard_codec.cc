@@ -71,6 +71,11 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
       return EncodedType::kList;
     case 11:
       return EncodedType::kMap;
+    case 12:
+      if (GetByteListView(value)) {
+        return EncodedType::kUInt8List;
+      }
+      break;
     case 13:
       return EncodedType::kFloat32List;
   }
@@ -78,17 +83,128 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Returns the number of bytes StandardCodecSerializer::WriteSize uses for
+// |size|.
+size_t EncodedSizeLength(size_t size) {
+  return size < 254 ? 1 : size <= 0xffff ? 3 : 5;
+}
+
+// Returns |position| rounded up to a multiple of |alignment|, where the
+// writer's WriteAlignment leaves it.
+size_t AlignedPosition(size_t position, size_t alignment) {
+  size_t mod = position % alignment;
+  return mod ? position + alignment - mod : position;
+}
+
+// Returns the position after a fixed-type list of |count| elements of
+// |type_size| bytes is written at |position|.
+size_t EncodedVectorEnd(size_t count, size_t type_size, size_t position) {
+  position += EncodedSizeLength(count);
+  if (count == 0) {
+    return position;
+  }
+  return AlignedPosition(position, type_size) + count * type_size;
+}
+
+// Returns the stream position after StandardCodecSerializer::WriteValue
+// writes |value| at |position|, alignment padding included, looking at no
+// more than |budget| values. Lists and maps are cut short once it runs out
+// and custom values other than byte list views count as their type byte
+// only, so the result is then a lower bound.
+size_t EncodedEnd(const EncodableValue& value,
+                  size_t position,
+                  size_t* budget) {
+  if (*budget > 0) {
+    --*budget;
+  }
+  position += 1;  // The type byte.
+  switch (value.index()) {
+    case 0:
+    case 1:
+      return position;
+    case 2:
+      return position + 4;
+    case 3:
+      return position + 8;
+    case 4:
+      return AlignedPosition(position, 8) + 8;
+    case 5: {
+      size_t size = std::get<std::string>(value).size();
+      return position + EncodedSizeLength(size) + size;
+    }
+    case 6:
+      return EncodedVectorEnd(std::get<std::vector<uint8_t>>(value).size(), 1,
+                              position);
+    case 7:
+      return EncodedVectorEnd(std::get<std::vector<int32_t>>(value).size(), 4,
+                              position);
+    case 8:
+      return EncodedVectorEnd(std::get<std::vector<int64_t>>(value).size(), 8,
+                              position);
+    case 9:
+      return EncodedVectorEnd(std::get<std::vector<double>>(value).size(), 8,
+                              position);
+    case 10: {
+      const auto& list = std::get<EncodableList>(value);
+      position += EncodedSizeLength(list.size());
+      for (auto it = list.begin(); it != list.end() && *budget > 0; ++it) {
+        position = EncodedEnd(*it, position, budget);
+      }
+      return position;
+    }
+    case 11: {
+      const auto& map = std::get<EncodableMap>(value);
+      position += EncodedSizeLength(map.size());
+      for (auto it = map.begin(); it != map.end() && *budget > 0; ++it) {
+        position = EncodedEnd(it->first, position, budget);
+        position = EncodedEnd(it->second, position, budget);
+      }
+      return position;
+    }
+    case 12:
+      if (const ByteListView* view = GetByteListView(value)) {
+        return EncodedVectorEnd(view->size, 1, position);
+      }
+      return position;
+    case 13:
+      return EncodedVectorEnd(std::get<std::vector<float>>(value).size(), 4,
+                              position);
+  }
+  return position;
+}
+
+// Values looked at when sizing a message before encoding it. Walking a big
+// tree of small values costs about as much as the reallocations it saves,
+// while big strings and lists are sized after a few values.
+constexpr size_t kEncodedSizeBudget = 256;
+
+// Returns the buffer size to reserve for writing |value| at |position|.
+size_t EncodedSizeHint(const EncodableValue& value, size_t position) {
+  size_t budget = kEncodedSizeBudget;
+  return EncodedEnd(value, position, &budget);
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
 
 StandardCodecSerializer::~StandardCodecSerializer() = default;
 
+StandardCodecSerializer::StandardCodecSerializer(
+    size_t byte_list_view_min_size)
+    : byte_list_view_min_size_(byte_list_view_min_size) {}
+
 const StandardCodecSerializer& StandardCodecSerializer::GetInstance() {
   static StandardCodecSerializer sInstance;
   return sInstance;
 };
 
+const StandardCodecSerializer&
+StandardCodecSerializer::GetByteListViewInstance() {
+  static StandardCodecSerializer sInstance(kByteListViewMinSize);
+  return sInstance;
+}
+
 EncodableValue StandardCodecSerializer::ReadValue(
     ByteStreamReader* stream) const {
   uint8_t type = stream->ReadByte();
@@ -124,9 +240,11 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
       }
       break;
     }
-    case 6:
-      WriteVector(std::get<std::vector<uint8_t>>(value), stream);
+    case 6: {
+      const auto& bytes = std::get<std::vector<uint8_t>>(value);
+      WriteBytes(bytes.data(), bytes.size(), stream);
       break;
+    }
     case 7:
       WriteVector(std::get<std::vector<int32_t>>(value), stream);
       break;
@@ -154,6 +272,10 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
       break;
     }
     case 12:
+      if (const ByteListView* view = GetByteListView(value)) {
+        WriteBytes(view->data, view->size, stream);
+        break;
+      }
       std::cerr
           << "Unhandled custom type in StandardCodecSerializer::WriteValue. "
           << "Custom types require codec extensions." << std::endl;
@@ -188,10 +310,23 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
+    }
+    case EncodedType::kUInt8List: {
+      size_t size = ReadSize(stream);
+      if (size >= byte_list_view_min_size_) {
+        std::shared_ptr<const void> storage = stream->storage();
+        if (storage) {
+          if (const uint8_t* data = stream->ReadView(size)) {
+            return EncodableValue(CustomEncodableValue(
+                ByteListView{data, size, std::move(storage)}));
+          }
+        }
+      }
+      std::vector<uint8_t> bytes(size);
+      stream->ReadBytes(bytes.data(), size);
+      return EncodableValue(std::move(bytes));
     }
-    case EncodedType::kUInt8List:
-      return ReadVector<uint8_t>(stream);
     case EncodedType::kInt32List:
       return ReadVector<int32_t>(stream);
     case EncodedType::kInt64List:
@@ -205,7 +340,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +350,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -268,11 +403,11 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -287,6 +422,15 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
                      count * type_size);
 }
 
+void StandardCodecSerializer::WriteBytes(const uint8_t* data,
+                                         size_t size,
+                                         ByteStreamWriter* stream) const {
+  WriteSize(size, stream);
+  if (size > 0) {
+    stream->WriteBytes(data, size);
+  }
+}
+
 // ===== standard_message_codec.h =====
 
 // static
@@ -321,7 +465,11 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
   if (!binary_message) {
     return std::make_unique<EncodableValue>();
   }
-  ByteBufferStreamReader stream(binary_message, message_size);
+  ByteBufferStreamReader stream(
+      binary_message, message_size,
+      serializer_->reads_byte_list_views()
+          ? ScopedIncomingMessage::StorageFor(binary_message)
+          : nullptr);
   return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
 }
 
@@ -329,6 +477,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(EncodedSizeHint(message, 0));
   ByteBufferStreamWriter stream(encoded.get());
   serializer_->WriteValue(message, &stream);
   return encoded;
@@ -365,7 +514,11 @@ StandardMethodCodec::~StandardMethodCodec() = default;
 std::unique_ptr<MethodCall<EncodableValue>>
 StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
                                               size_t message_size) const {
-  ByteBufferStreamReader stream(message, message_size);
+  ByteBufferStreamReader stream(
+      message, message_size,
+      serializer_->reads_byte_list_views()
+          ? ScopedIncomingMessage::StorageFor(message)
+          : nullptr);
   EncodableValue method_name_value = serializer_->ReadValue(&stream);
   const auto* method_name = std::get_if<std::string>(&method_name_value);
   if (!method_name) {
@@ -382,11 +535,16 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
+  const EncodableValue method_name(method_call.method_name());
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  const size_t arguments_position = EncodedSizeHint(method_name, 0);
+  const EncodableValue* arguments = method_call.arguments();
+  encoded->reserve(arguments ? EncodedSizeHint(*arguments, arguments_position)
+                             : arguments_position + 1);
   ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
-  if (method_call.arguments()) {
-    serializer_->WriteValue(*method_call.arguments(), &stream);
+  serializer_->WriteValue(method_name, &stream);
+  if (arguments) {
+    serializer_->WriteValue(*arguments, &stream);
   } else {
     serializer_->WriteValue(EncodableValue(), &stream);
   }
@@ -397,6 +555,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeSuccessEnvelopeInternal(
     const EncodableValue* result) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(result ? EncodedSizeHint(*result, 1) : 2);
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(0);
   if (result) {
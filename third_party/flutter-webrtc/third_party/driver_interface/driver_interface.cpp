@@ -1,15 +1,24 @@
+#ifdef _WIN32
 #pragma warning(push)
 #pragma warning(disable : 4244)
+#endif
 
+#include <algorithm>
 #include <string>
 #include <vector>
-#define NOMINMAX
-#include <Windows.h>
 #include <limits>
 #include <memory>
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
 #include "shared_memory/shared.inl"
+#else
+#include <cstdlib>
+#include "shared_memory/shared_posix.inl"
+#endif
 #include "driver_interface.h"
+#include "image_kernels.h"
 
 #ifdef _WIN64
 #define GUID_OFFSET 0x10
@@ -19,6 +28,8 @@
 
 static const int MAX_CAPNUM = SharedImageMemory::MAX_CAPNUM;
 
+#ifdef _WIN32
+
 static void rtrim(std::string& s) {
     s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) {
         return !std::isspace(ch) && !std::iscntrl(ch);
@@ -40,8 +51,25 @@ static bool get_name(int num, std::string& str, std::string& dkey) {
     dkey = std::string(key);
     return true;
 }
-
-inline int invertImageBuffer(const uint8_t* src_argb, uint8_t* dst_argb, int width, int height);
+#else
+// There is no driver registry on POSIX, every CapNum slot is a shared memory
+// object that a receiver creates. The number of advertised slots is taken
+// from CAMCONNECT_VCAM_COUNT (default 1).
+static bool get_name(int num, std::string& str, std::string& dkey) {
+    static const int count = [] {
+        const char* env = std::getenv("CAMCONNECT_VCAM_COUNT");
+        const int n = env ? std::atoi(env) : 1;
+        return std::clamp(n, 0, static_cast<int>(MAX_CAPNUM));
+    }();
+    if (num >= count)
+        return false;
+    char name[32];
+    SharedImageMemory::GetName(num, name);
+    str = "CamConnect Virtual Camera" + (num ? " " + std::to_string(num + 1) : std::string());
+    dkey = std::string(name);
+    return true;
+}
+#endif
 
 std::vector<DeviceInfo> DriverInterface::GetDevices() {
     std::vector<DeviceInfo> deviceNames;
@@ -55,103 +83,116 @@ std::vector<DeviceInfo> DriverInterface::GetDevices() {
     return deviceNames;
 }
 
-int DriverInterface::SetDevice(const std::string& devicePath) {
-    int CapNum;
-    bool found = false;
-
-    for (CapNum = 0; CapNum < MAX_CAPNUM; CapNum++) {
+int DriverInterface::FindDevice(const std::string& devicePath) {
+    for (int CapNum = 0; CapNum < MAX_CAPNUM; CapNum++) {
         std::string dName, dkey;
         if (get_name(CapNum, dName, dkey) && dkey == devicePath) {
-            found = true;
-            break;
+            return CapNum;
         }
     }
+    return -1; // device not found.
+}
+
+std::unique_ptr<VirtualCameraOutput> VirtualCameraOutput::Create(const std::string& devicePath) {
+    const int CapNum = DriverInterface::FindDevice(devicePath);
+    if (CapNum < 0)
+        return nullptr;
+    return std::unique_ptr<VirtualCameraOutput>(new VirtualCameraOutput(CapNum));
+}
 
-    if (!found)
-        return 1; // device not found.
+VirtualCameraOutput::VirtualCameraOutput(int capNum)
+    : shm_(std::make_unique<SharedImageMemory>(capNum)) {}
 
-    if (shm_ != nullptr)
-        shm_ = nullptr;
+VirtualCameraOutput::~VirtualCameraOutput() = default;
 
-    shm_ = std::make_unique<SharedImageMemory>(CapNum);
-    return 0; // success
+int VirtualCameraOutput::GetCapNum() const {
+    return shm_->GetCapNum();
 }
 
-void DriverInterface::DestroyDevice() {
-    if (shm_ != nullptr) {
-        shm_ = nullptr;
-    }
+void VirtualCameraOutput::SetMaxResolution(int maxWidth, int maxHeight) {
+    maxWidth_ = std::max(maxWidth, 0);
+    maxHeight_ = std::max(maxHeight, 0);
 }
 
-int DriverInterface::SendBuffer(const uint8_t *buffer, int width, int height) {
-    if (shm_ == nullptr) {
-        return -1;
+int VirtualCameraOutput::SendBuffer(const I420Buffer& frame) {
+    if (!shm_->SendIsReady() || !shm_->WantsFrame()) {
+        // happens when no app is capturing the camera, or it's still busy with the last frame
+        return -2;
     }
 
-    if (!shm_->SendIsReady()) {
-        // happens when no app is capturing the camera yet
-        return -2;
+    // Fit the frame into the maximum resolution, keeping the aspect ratio.
+    int width = frame.width, height = frame.height;
+    if ((maxWidth_ > 0 && width > maxWidth_) || (maxHeight_ > 0 && height > maxHeight_)) {
+        const double scale = std::min(maxWidth_ > 0 ? static_cast<double>(maxWidth_) / width : 1.0,
+                                      maxHeight_ > 0 ? static_cast<double>(maxHeight_) / height : 1.0);
+        width = std::max(2, static_cast<int>(width * scale + 0.5) & ~1);
+        height = std::max(2, static_cast<int>(height * scale + 0.5) & ~1);
     }
 
-    if (width != width_ || height != height_) {
-        width_ = width, height_ = height;
-        bufferSize_ = width_ * height_ * 4;
-        delete[] outBuffer_;
-        outBuffer_ = new uint8_t[bufferSize_];
+    // Prefer handing the planes over as is, the receiver converts if it needs to.
+    if (shm_->AcceptsFormat(SharedImageMemory::FORMAT_I420)) {
+        return SendPlanar(frame, SharedImageMemory::FORMAT_I420, width, height);
+    }
+    if (shm_->AcceptsFormat(SharedImageMemory::FORMAT_NV12)) {
+        return SendPlanar(frame, SharedImageMemory::FORMAT_NV12, width, height);
     }
 
-    invertImageBuffer(buffer, outBuffer_, width, height);
+    const int stride = width;
+    const uint32_t bufferSize = static_cast<uint32_t>(width) * height * 4;
 
-    const int stride = width_;
     constexpr SharedImageMemory::EFormat format = SharedImageMemory::FORMAT_UINT8;
     // Note: RESIZEMODE_LINEAR means nearest neighbor scaling.
     constexpr SharedImageMemory::EResizeMode resize_mode = SharedImageMemory::RESIZEMODE_LINEAR;
     constexpr SharedImageMemory::EMirrorMode mirror_mode = SharedImageMemory::MIRRORMODE_DISABLED;
     // Keep showing last received frame after stopping while receiving app is still capturing.
     constexpr int timeout = std::numeric_limits<int>::max() - SharedImageMemory::RECEIVE_MAX_WAIT;
-    return shm_->Send(width, height, stride, bufferSize_, format, resize_mode, mirror_mode, timeout, outBuffer_);
+    return shm_->SendInPlace(width, height, stride, bufferSize, format, resize_mode, mirror_mode, timeout,
+        [&](uint8_t* data) {
+            // Write rows bottom-up through a negative stride, this flips the image
+            // and mirroring is done per row, so no separate invert pass is needed.
+            // Scaling happens per row in the same pass.
+            uint8_t* last_row = data + static_cast<size_t>(height - 1) * stride * 4;
+            I420ScaleToABGR(frame.dataY, frame.strideY, frame.dataU, frame.strideU,
+                frame.dataV, frame.strideV, frame.width, frame.height,
+                last_row, -stride * 4, width, height, true, ScaleFilter::kAuto);
+        });
 }
 
-// Static variable initializations
-int DriverInterface::width_ = 1280;
-int DriverInterface::height_ = 720;
-DWORD DriverInterface::bufferSize_ = width_ * height_ * 4;
-uint8_t* DriverInterface::outBuffer_ = new uint8_t[bufferSize_];
-std::unique_ptr<SharedImageMemory> DriverInterface::shm_ = nullptr;
-
-/**
- * @brief Inverts the orientation of a BGRA image buffer horizontally.
- */
-inline int invertImageBuffer(
-    const uint8_t* src_argb,
-    uint8_t* dst_argb,
-    int width,
-    int height
-) {
-    if (!src_argb || !dst_argb || width <= 0 || height == 0) {
-        return -1;
+int VirtualCameraOutput::SendPlanar(const I420Buffer& frame, int planarFormat, int width, int height) {
+    const auto format = static_cast<SharedImageMemory::EFormat>(planarFormat);
+    const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+
+    // Tightly packed planes, top-down and unmirrored.
+    uint32_t offsets[3];
+    int strides[3];
+    strides[0] = width;
+    offsets[0] = 0;
+    offsets[1] = static_cast<uint32_t>(width) * height;
+    if (format == SharedImageMemory::FORMAT_I420) {
+        strides[1] = strides[2] = chromaWidth;
+        offsets[2] = offsets[1] + static_cast<uint32_t>(chromaWidth) * chromaHeight;
+    } else {
+        strides[1] = chromaWidth * 2;
+        strides[2] = 0;
+        offsets[2] = 0;
     }
-    const int stride = width * 4;
-    int src_stride_argb = stride;
-    // Invert the image.
-    src_argb = src_argb + (height - 1) * src_stride_argb;
-    src_stride_argb = -src_stride_argb;
-
-    // Mirror plane
-    for (int y = 0; y < height; ++y) {
-        const uint32_t* src32 = (const uint32_t*)(src_argb);
-        uint32_t* dst32 = (uint32_t*)(dst_argb);
-        src32 += width - 1;
-        for (int x = 0; x < width - 1; x += 2) {
-            dst32[x] = src32[0];
-            dst32[x + 1] = src32[-1];
-            src32 -= 2;
-        }
-        if (width & 1) {
-            dst32[width - 1] = src32[0];
-        }
-        dst_argb += stride;
-        src_argb += src_stride_argb;
-    }
-    return 0;
-}
\ No newline at end of file
+    const uint32_t bufferSize = offsets[1] + static_cast<uint32_t>(chromaWidth) * chromaHeight * 2;
+
+    constexpr SharedImageMemory::EResizeMode resize_mode = SharedImageMemory::RESIZEMODE_LINEAR;
+    constexpr SharedImageMemory::EMirrorMode mirror_mode = SharedImageMemory::MIRRORMODE_DISABLED;
+    constexpr int timeout = std::numeric_limits<int>::max() - SharedImageMemory::RECEIVE_MAX_WAIT;
+    return shm_->SendPlanarInPlace(width, height, format, offsets, strides, bufferSize, resize_mode, mirror_mode, timeout,
+        [&](uint8_t* data) {
+            if (format == SharedImageMemory::FORMAT_I420) {
+                I420Scale(frame.dataY, frame.strideY, frame.dataU, frame.strideU, frame.dataV, frame.strideV,
+                    frame.width, frame.height,
+                    data + offsets[0], strides[0], data + offsets[1], strides[1], data + offsets[2], strides[2],
+                    width, height, ScaleFilter::kAuto);
+            } else {
+                I420ScaleToNV12(frame.dataY, frame.strideY, frame.dataU, frame.strideU, frame.dataV, frame.strideV,
+                    frame.width, frame.height,
+                    data + offsets[0], strides[0], data + offsets[1], strides[1],
+                    width, height, ScaleFilter::kAuto);
+            }
+        });
+}
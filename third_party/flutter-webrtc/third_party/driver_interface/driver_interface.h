@@ -16,46 +16,102 @@ struct DeviceInfo
     std::string devicePath;    // The path of the device.
 };
 
-class DriverInterface {
-private:
-    static int width_;
-    static int height_;
-    static uint8_t* outBuffer_;
-    static unsigned long bufferSize_;
-    static std::unique_ptr<SharedImageMemory> shm_;
+/**
+ * @brief A decoded I420 frame, the planes are borrowed from the caller.
+ */
+struct I420Buffer
+{
+    const uint8_t* dataY;
+    const uint8_t* dataU;
+    const uint8_t* dataV;
+    int strideY;
+    int strideU;
+    int strideV;
+    int width;
+    int height;
+};
 
+/**
+ * @brief Output to one virtual camera device (CapNum), with its own
+ * shared memory connection, conversion buffer and resolution.
+ *
+ * An output is not thread-safe, it's meant to be fed by a single thread.
+ */
+class VirtualCameraOutput {
 public:
     /**
-     * @brief Get installed UnityCapture device infos.
+     * @brief Open an output for a device.
+     *
+     * @param[in] devicePath The device path, as reported by DriverInterface::GetDevices.
+     *
+     * @return The output, nullptr if the device was not found.
      */
-    static std::vector<DeviceInfo> GetDevices();
+    static std::unique_ptr<VirtualCameraOutput> Create(const std::string& devicePath);
+
+    ~VirtualCameraOutput();
 
     /**
-     * @brief Set the active device handle.
+     * @brief The CapNum of the device this output sends to.
+     */
+    int GetCapNum() const;
+
+    /**
+     * @brief Limit the resolution of I420 frames sent to the device.
      *
-     * @param[in] devicePath The device path to set as the active device.
+     * Larger frames are scaled down on the sender, keeping their aspect ratio,
+     * so only the target size frame goes through shared memory.
      *
-     * @return 0: Success,
-     * 1: Failure (device not found).
-    */
-    static int SetDevice(const std::string& devicePath);
+     * @param[in] maxWidth Maximum width, 0 for no limit.
+     * @param[in] maxHeight Maximum height, 0 for no limit.
+     */
+    void SetMaxResolution(int maxWidth, int maxHeight);
 
     /**
-     * @brief Destroy the active device handle.
+     * @brief Send an I420 frame to vcam.
+     *
+     * If the receiver accepts planar frames the planes are copied as I420
+     * (or NV12), otherwise the frame is converted, flipped and mirrored in a
+     * single pass straight into the shared memory frame slot. Frames above
+     * the maximum resolution are scaled down within the same pass.
+     *
+     * Nothing is converted or written until an app capturing the camera asks
+     * for a frame, the first frame after a request is sent right away.
+     *
+     * @param[in] frame I420 frame planes.
+     *
+     * @return 0: Failure (buffer too large), 1: Success (frame not requested yet),
+     * 2: Success, -2: Skipped (no app is capturing the camera or asking for a frame).
      */
-    static void DestroyDevice();
+    int SendBuffer(const I420Buffer& frame);
+
+private:
+    explicit VirtualCameraOutput(int capNum);
+
+    /**
+     * @brief Copy an I420 frame into the shared memory as I420 or NV12 planes.
+     */
+    int SendPlanar(const I420Buffer& frame, int planarFormat, int width, int height);
+
+    int maxWidth_ = 0;
+    int maxHeight_ = 0;
+    std::unique_ptr<SharedImageMemory> shm_;
+};
+
+class DriverInterface {
+public:
+    /**
+     * @brief Get installed UnityCapture device infos.
+     */
+    static std::vector<DeviceInfo> GetDevices();
 
     /**
-     * @brief Send frame buffer to vcam.
+     * @brief Find the CapNum of a device.
      *
-     * @param[in] buffer BGRA frame buffer.
-     * @param[in] width Width of frame buffer.
-     * @param[in] height Height of frame buffer.
+     * @param[in] devicePath The device path to look up.
      *
-     * @return 0: Success, 1: Failure.
-     * -1: Failure (no active device).
+     * @return The CapNum, -1 if the device was not found.
      */
-    static int SendBuffer(const uint8_t* buffer, int width, int height);
+    static int FindDevice(const std::string& devicePath);
 };
 
 #endif // DRIVER_INTERFACE_H
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "frame_buffer_pool.h"
+
+namespace {
+
+struct PoolState {
+    std::mutex mutex;
+    std::vector<FrameBuffer*> free_buffers;
+    size_t buffers = 0;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+// Leases may outlive static destruction (e.g. held by other statics),
+// so the state is intentionally never destroyed.
+PoolState& State() {
+    static PoolState* state = new PoolState();
+    return *state;
+}
+
+/**
+ * @brief Round size up to its bucket, buckets are spaced at 1/8 of
+ * the next power of two so a bucket wastes at most 12.5%.
+ */
+size_t BucketSize(size_t size) {
+    size_t step = 4096;
+    while (step * 8 < size) {
+        step <<= 1;
+    }
+    return (std::max<size_t>(size, 1) + step - 1) & ~(step - 1);
+}
+
+} // namespace
+
+FrameBufferLease FrameBufferPool::Acquire(size_t size) {
+    PoolState& state = State();
+    const size_t capacity = BucketSize(size);
+
+    FrameBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto& free_buffers = state.free_buffers;
+
+        auto it = std::find_if(free_buffers.begin(), free_buffers.end(),
+            [capacity](const FrameBuffer* b) { return b->capacity_ == capacity; });
+
+        if (it != free_buffers.end()) {
+            buffer = *it;
+            free_buffers.erase(it);
+            state.hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            state.misses.fetch_add(1, std::memory_order_relaxed);
+
+            if (state.buffers < MAX_BUFFERS) {
+                buffer = new FrameBuffer();
+                state.buffers++;
+            } else if (!free_buffers.empty()) {
+                // Evict a free buffer of a different bucket (resolution change).
+                buffer = free_buffers.back();
+                free_buffers.pop_back();
+            } else {
+                buffer = new FrameBuffer();
+                buffer->pooled_ = false;
+            }
+        }
+    }
+
+    if (buffer->capacity_ != capacity) {
+        buffer->data_.reset(new uint8_t[capacity]);
+        buffer->capacity_ = capacity;
+    }
+    buffer->size_ = size;
+
+    return FrameBufferLease(buffer, &FrameBufferPool::Release);
+}
+
+void FrameBufferPool::Release(FrameBuffer* buffer) {
+    if (!buffer->pooled_) {
+        delete buffer;
+        return;
+    }
+    PoolState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.free_buffers.push_back(buffer);
+}
+
+FrameBufferPoolStats FrameBufferPool::GetStats() {
+    PoolState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    FrameBufferPoolStats stats;
+    stats.hits = state.hits.load(std::memory_order_relaxed);
+    stats.misses = state.misses.load(std::memory_order_relaxed);
+    stats.buffers = state.buffers;
+    stats.inUse = state.buffers - state.free_buffers.size();
+    return stats;
+}
+
+void FrameBufferPool::Trim() {
+    PoolState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    for (FrameBuffer* buffer : state.free_buffers) {
+        delete buffer;
+    }
+    state.buffers -= state.free_buffers.size();
+    state.free_buffers.clear();
+}
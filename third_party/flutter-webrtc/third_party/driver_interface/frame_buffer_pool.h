@@ -0,0 +1,84 @@
+#ifndef FRAME_BUFFER_POOL_H
+#define FRAME_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A pixel buffer handed out by FrameBufferPool.
+ *
+ * The buffer is written once by the producer and must be treated as
+ * immutable once it has been shared with a consumer.
+ */
+class FrameBuffer {
+public:
+    uint8_t* data() { return data_.get(); }
+    const uint8_t* data() const { return data_.get(); }
+
+    /**
+     * @brief The size that was requested when acquiring the buffer.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief The allocated size of the buffer (its size bucket).
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    friend class FrameBufferPool;
+
+    std::unique_ptr<uint8_t[]> data_;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    bool pooled_ = true;
+};
+
+// A lease holds shared ownership of a pooled buffer, the buffer
+// goes back to the pool when the last lease referencing it is released.
+using FrameBufferLease = std::shared_ptr<FrameBuffer>;
+using ConstFrameBufferLease = std::shared_ptr<const FrameBuffer>;
+
+struct FrameBufferPoolStats {
+    uint64_t hits;      // Acquires served by a free pooled buffer.
+    uint64_t misses;    // Acquires that had to allocate.
+    size_t buffers;     // Buffers currently owned by the pool.
+    size_t inUse;       // Pooled buffers currently leased out.
+};
+
+/**
+ * @brief Fixed-capacity pool of reusable, size-bucketed frame buffers.
+ */
+class FrameBufferPool {
+public:
+    // Maximum number of buffers the pool keeps around for reuse.
+    static constexpr size_t MAX_BUFFERS = 8;
+
+    /**
+     * @brief Lease a buffer that can hold at least size bytes.
+     *
+     * When every pooled buffer is leased out a transient buffer is
+     * allocated instead, it's freed rather than pooled on release.
+     *
+     * @param[in] size Required size of the buffer in bytes.
+     *
+     * @return Lease of the buffer, never null.
+     */
+    static FrameBufferLease Acquire(size_t size);
+
+    /**
+     * @brief Get the pool hit/miss counters.
+     */
+    static FrameBufferPoolStats GetStats();
+
+    /**
+     * @brief Free all buffers that are not currently leased out.
+     */
+    static void Trim();
+
+private:
+    static void Release(FrameBuffer* buffer);
+};
+
+#endif // FRAME_BUFFER_POOL_H
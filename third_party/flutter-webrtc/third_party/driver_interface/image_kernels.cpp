@@ -0,0 +1,846 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "image_kernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define IMAGE_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define IMAGE_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// MSVC accepts AVX2 intrinsics in any function, GCC and Clang
+// need the function itself to be compiled for the target.
+#if defined(IMAGE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+using MirrorRowFunc = void (*)(const uint32_t* src, uint32_t* dst, int width);
+
+void MirrorRow_C(const uint32_t* src, uint32_t* dst, int width) {
+    src += width - 1;
+    for (int x = 0; x < width - 1; x += 2) {
+        dst[x] = src[0];
+        dst[x + 1] = src[-1];
+        src -= 2;
+    }
+    if (width & 1) {
+        dst[width - 1] = src[0];
+    }
+}
+
+// BT.601 limited range coefficients in 16.16 fixed point.
+constexpr int kYG = 76309;   // 1.164
+constexpr int kVR = 104597;  // 1.596
+constexpr int kUG = 25675;   // 0.391
+constexpr int kVG = 53279;   // 0.813
+constexpr int kUB = 132201;  // 2.018
+
+using YuvRowFunc = void (*)(const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+                            uint32_t* dst, int width, bool mirror);
+
+inline uint8_t Clamp255(int v) {
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+inline uint32_t YuvPixel(int y, int u, int v) {
+    const int y1 = (y - 16) * kYG + 32768;
+    const int r = (y1 + kVR * (v - 128)) >> 16;
+    const int g = (y1 - kUG * (u - 128) - kVG * (v - 128)) >> 16;
+    const int b = (y1 + kUB * (u - 128)) >> 16;
+    // Little-endian word, so bytes land as R, G, B, A.
+    return static_cast<uint32_t>(Clamp255(r)) |
+           static_cast<uint32_t>(Clamp255(g)) << 8 |
+           static_cast<uint32_t>(Clamp255(b)) << 16 |
+           0xFF000000u;
+}
+
+/**
+ * @brief Convert pixels [begin, width) of a row, SIMD kernels use it for the tail.
+ */
+void I420ToABGRRowRange_C(const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+                          uint32_t* dst, int begin, int width, bool mirror) {
+    for (int x = begin; x < width; ++x) {
+        dst[mirror ? width - 1 - x : x] = YuvPixel(src_y[x], src_u[x >> 1], src_v[x >> 1]);
+    }
+}
+
+void I420ToABGRRow_C(const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+                     uint32_t* dst, int width, bool mirror) {
+    I420ToABGRRowRange_C(src_y, src_u, src_v, dst, 0, width, mirror);
+}
+
+using MergeUVRowFunc = void (*)(const uint8_t* src_u, const uint8_t* src_v, uint8_t* dst_uv, int width);
+
+void MergeUVRow_C(const uint8_t* src_u, const uint8_t* src_v, uint8_t* dst_uv, int width) {
+    for (int x = 0; x < width; ++x) {
+        dst_uv[2 * x] = src_u[x];
+        dst_uv[2 * x + 1] = src_v[x];
+    }
+}
+
+using InterpolateRowFunc = void (*)(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                                   int width, int fraction);
+using AccumulateRowFunc = void (*)(const uint8_t* src, uint16_t* acc, int width);
+
+/**
+ * @brief Blend two rows, dst = (src0 * (256 - fraction) + src1 * fraction + 128) >> 8.
+ * The fraction is in [1, 255], callers copy src0 for 0.
+ */
+void InterpolateRow_C(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                      int width, int fraction) {
+    const int fraction0 = 256 - fraction;
+    for (int x = 0; x < width; ++x) {
+        dst[x] = static_cast<uint8_t>((src0[x] * fraction0 + src1[x] * fraction + 128) >> 8);
+    }
+}
+
+void AccumulateRow_C(const uint8_t* src, uint16_t* acc, int width) {
+    for (int x = 0; x < width; ++x) {
+        acc[x] = static_cast<uint16_t>(acc[x] + src[x]);
+    }
+}
+
+using BoxRow2xFunc = void (*)(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int dst_width);
+
+/**
+ * @brief Average 2x2 blocks of two rows, the exact 2x case of the box filter.
+ */
+void BoxRow2x_C(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int dst_width) {
+    for (int x = 0; x < dst_width; ++x) {
+        dst[x] = static_cast<uint8_t>((src0[2 * x] + src0[2 * x + 1] + src1[2 * x] + src1[2 * x + 1] + 2) >> 2);
+    }
+}
+
+using FilterColsFunc = void (*)(const uint8_t* src, const int* x0, const int* fx, uint8_t* dst, int width);
+
+/**
+ * @brief Horizontal bilinear pass, dst[x] blends src[x0[x]] and src[x0[x] + 1] by fx[x].
+ * src must be readable 4 bytes past the last x0.
+ */
+void FilterCols_C(const uint8_t* src, const int* x0, const int* fx, uint8_t* dst, int width) {
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* p = src + x0[x];
+        dst[x] = static_cast<uint8_t>((p[0] * (256 - fx[x]) + p[1] * fx[x] + 128) >> 8);
+    }
+}
+
+#ifdef IMAGE_KERNELS_X86
+void InterpolateRow_SSE2(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                         int width, int fraction) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i f0 = _mm_set1_epi16(static_cast<short>(256 - fraction));
+    const __m128i f1 = _mm_set1_epi16(static_cast<short>(fraction));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x));
+        // At most 255 * 256 + 128, so the 16-bit lanes don't overflow.
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), f0),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), f1));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), f0),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), f1));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+    InterpolateRow_C(src0 + x, src1 + x, dst + x, width - x, fraction);
+}
+
+void AccumulateRow_SSE2(const uint8_t* src, uint16_t* acc, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i* a = reinterpret_cast<__m128i*>(acc + x);
+        _mm_storeu_si128(a, _mm_add_epi16(_mm_loadu_si128(a), _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(a + 1, _mm_add_epi16(_mm_loadu_si128(a + 1), _mm_unpackhi_epi8(v, zero)));
+    }
+    AccumulateRow_C(src + x, acc + x, width - x);
+}
+
+void BoxRow2x_SSE2(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int dst_width) {
+    const __m128i low = _mm_set1_epi16(0xFF);
+    const __m128i round = _mm_set1_epi16(2);
+    int x = 0;
+    for (; x + 16 <= dst_width; x += 16) {
+        __m128i sums[2];
+        for (int i = 0; i < 2; ++i) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + 2 * x + 16 * i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + 2 * x + 16 * i));
+            // Horizontal pairs: even byte + odd byte of each 16-bit lane.
+            const __m128i pa = _mm_add_epi16(_mm_and_si128(a, low), _mm_srli_epi16(a, 8));
+            const __m128i pb = _mm_add_epi16(_mm_and_si128(b, low), _mm_srli_epi16(b, 8));
+            sums[i] = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(pa, pb), round), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+    BoxRow2x_C(src0 + 2 * x, src1 + 2 * x, dst + x, dst_width - x);
+}
+
+void MirrorRow_SSE2(const uint32_t* src, uint32_t* dst, int width) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + width - x - 4));
+        v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), v);
+    }
+    if (x < width) {
+        MirrorRow_C(src, dst + x, width - x);
+    }
+}
+
+void MergeUVRow_SSE2(const uint8_t* src_u, const uint8_t* src_v, uint8_t* dst_uv, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_u + x));
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_v + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_uv + 2 * x), _mm_unpacklo_epi8(u, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_uv + 2 * x + 16), _mm_unpackhi_epi8(u, v));
+    }
+    MergeUVRow_C(src_u + x, src_v + x, dst_uv + 2 * x, width - x);
+}
+
+TARGET_AVX2 void MirrorRow_AVX2(const uint32_t* src, uint32_t* dst, int width) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + width - x - 8));
+        v = _mm256_permutevar8x32_epi32(v, reverse);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), v);
+    }
+    if (x < width) {
+        MirrorRow_SSE2(src, dst + x, width - x);
+    }
+}
+
+// Same fixed point math as YuvPixel on 8 pixels at a time, so results are bit-exact.
+TARGET_AVX2 void I420ToABGRRow_AVX2(const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+                                    uint32_t* dst, int width, bool mirror) {
+    const __m256i duplicate = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi32(255);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        int32_t u4, v4;
+        memcpy(&u4, src_u + (x >> 1), 4);
+        memcpy(&v4, src_v + (x >> 1), 4);
+
+        const __m256i y = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src_y + x)));
+        __m256i u = _mm256_castsi128_si256(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(u4)));
+        __m256i v = _mm256_castsi128_si256(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(v4)));
+        u = _mm256_sub_epi32(_mm256_permutevar8x32_epi32(u, duplicate), _mm256_set1_epi32(128));
+        v = _mm256_sub_epi32(_mm256_permutevar8x32_epi32(v, duplicate), _mm256_set1_epi32(128));
+
+        const __m256i y1 = _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_sub_epi32(y, _mm256_set1_epi32(16)), _mm256_set1_epi32(kYG)),
+            _mm256_set1_epi32(32768));
+
+        __m256i r = _mm256_add_epi32(y1, _mm256_mullo_epi32(v, _mm256_set1_epi32(kVR)));
+        __m256i g = _mm256_sub_epi32(_mm256_sub_epi32(y1,
+            _mm256_mullo_epi32(u, _mm256_set1_epi32(kUG))),
+            _mm256_mullo_epi32(v, _mm256_set1_epi32(kVG)));
+        __m256i b = _mm256_add_epi32(y1, _mm256_mullo_epi32(u, _mm256_set1_epi32(kUB)));
+
+        r = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(r, 16), zero), max);
+        g = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(g, 16), zero), max);
+        b = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(b, 16), zero), max);
+
+        __m256i pixels = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                                         _mm256_or_si256(_mm256_slli_epi32(b, 16), alpha));
+        if (mirror) {
+            pixels = _mm256_permutevar8x32_epi32(pixels, reverse);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + width - x - 8), pixels);
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), pixels);
+        }
+    }
+    I420ToABGRRowRange_C(src_y, src_u, src_v, dst, x, width, mirror);
+}
+
+TARGET_AVX2 void FilterCols_AVX2(const uint8_t* src, const int* x0, const int* fx, uint8_t* dst, int width) {
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i one = _mm256_set1_epi32(256);
+    const __m256i round = _mm256_set1_epi32(128);
+    // Byte 0 of each dword, per 128-bit lane.
+    const __m256i pack = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x0 + x));
+        const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fx + x));
+        // Loads src[x0], src[x0 + 1] (and 2 unused bytes) per pixel.
+        const __m256i pair = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), index, 1);
+        const __m256i a = _mm256_and_si256(pair, byte);
+        const __m256i b = _mm256_and_si256(_mm256_srli_epi32(pair, 8), byte);
+        __m256i v = _mm256_add_epi32(_mm256_mullo_epi32(a, _mm256_sub_epi32(one, f)), _mm256_mullo_epi32(b, f));
+        v = _mm256_shuffle_epi8(_mm256_srli_epi32(_mm256_add_epi32(v, round), 8), pack);
+        const uint32_t lo = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(v)));
+        const uint32_t hi = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_extracti128_si256(v, 1)));
+        memcpy(dst + x, &lo, 4);
+        memcpy(dst + x + 4, &hi, 4);
+    }
+    FilterCols_C(src, x0 + x, fx + x, dst + x, width - x);
+}
+
+bool CpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false; // the OS doesn't preserve the YMM registers.
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // IMAGE_KERNELS_X86
+
+#ifdef IMAGE_KERNELS_NEON
+void MirrorRow_NEON(const uint32_t* src, uint32_t* dst, int width) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        uint32x4_t v = vrev64q_u32(vld1q_u32(src + width - x - 4));
+        vst1q_u32(dst + x, vcombine_u32(vget_high_u32(v), vget_low_u32(v)));
+    }
+    if (x < width) {
+        MirrorRow_C(src, dst + x, width - x);
+    }
+}
+
+void InterpolateRow_NEON(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                         int width, int fraction) {
+    const uint8x8_t f0 = vdup_n_u8(static_cast<uint8_t>(256 - fraction));
+    const uint8x8_t f1 = vdup_n_u8(static_cast<uint8_t>(fraction));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16_t a = vld1q_u8(src0 + x);
+        const uint8x16_t b = vld1q_u8(src1 + x);
+        const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), f0), vget_low_u8(b), f1);
+        const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), f0), vget_high_u8(b), f1);
+        // Rounding narrow adds 128 before the shift.
+        vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+    InterpolateRow_C(src0 + x, src1 + x, dst + x, width - x, fraction);
+}
+
+void AccumulateRow_NEON(const uint8_t* src, uint16_t* acc, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16_t v = vld1q_u8(src + x);
+        vst1q_u16(acc + x, vaddw_u8(vld1q_u16(acc + x), vget_low_u8(v)));
+        vst1q_u16(acc + x + 8, vaddw_u8(vld1q_u16(acc + x + 8), vget_high_u8(v)));
+    }
+    AccumulateRow_C(src + x, acc + x, width - x);
+}
+
+void BoxRow2x_NEON(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int dst_width) {
+    int x = 0;
+    for (; x + 8 <= dst_width; x += 8) {
+        const uint16x8_t sum = vaddq_u16(vpaddlq_u8(vld1q_u8(src0 + 2 * x)), vpaddlq_u8(vld1q_u8(src1 + 2 * x)));
+        vst1_u8(dst + x, vrshrn_n_u16(sum, 2)); // (sum + 2) >> 2
+    }
+    BoxRow2x_C(src0 + 2 * x, src1 + 2 * x, dst + x, dst_width - x);
+}
+
+void MergeUVRow_NEON(const uint8_t* src_u, const uint8_t* src_v, uint8_t* dst_uv, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x2_t uv;
+        uv.val[0] = vld1q_u8(src_u + x);
+        uv.val[1] = vld1q_u8(src_v + x);
+        vst2q_u8(dst_uv + 2 * x, uv);
+    }
+    MergeUVRow_C(src_u + x, src_v + x, dst_uv + 2 * x, width - x);
+}
+
+// Same fixed point math as YuvPixel on 4 pixels at a time, so results are bit-exact.
+inline uint32x4_t YuvPixels_NEON(int32x4_t y, int32x4_t u, int32x4_t v) {
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t max = vdupq_n_s32(255);
+
+    const int32x4_t y1 = vaddq_s32(vmulq_n_s32(vsubq_s32(y, vdupq_n_s32(16)), kYG), vdupq_n_s32(32768));
+    int32x4_t r = vmlaq_n_s32(y1, v, kVR);
+    int32x4_t g = vmlsq_n_s32(vmlsq_n_s32(y1, u, kUG), v, kVG);
+    int32x4_t b = vmlaq_n_s32(y1, u, kUB);
+
+    r = vminq_s32(vmaxq_s32(vshrq_n_s32(r, 16), zero), max);
+    g = vminq_s32(vmaxq_s32(vshrq_n_s32(g, 16), zero), max);
+    b = vminq_s32(vmaxq_s32(vshrq_n_s32(b, 16), zero), max);
+
+    const uint32x4_t rg = vorrq_u32(vreinterpretq_u32_s32(r), vshlq_n_u32(vreinterpretq_u32_s32(g), 8));
+    const uint32x4_t ba = vorrq_u32(vshlq_n_u32(vreinterpretq_u32_s32(b), 16), vdupq_n_u32(0xFF000000u));
+    return vorrq_u32(rg, ba);
+}
+
+inline uint32x4_t Reverse_NEON(uint32x4_t v) {
+    v = vrev64q_u32(v);
+    return vcombine_u32(vget_high_u32(v), vget_low_u32(v));
+}
+
+void I420ToABGRRow_NEON(const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+                        uint32_t* dst, int width, bool mirror) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint32_t u4, v4;
+        memcpy(&u4, src_u + (x >> 1), 4);
+        memcpy(&v4, src_v + (x >> 1), 4);
+
+        // Duplicate each chroma sample for the two pixels sharing it.
+        const uint8x8_t u8 = vreinterpret_u8_u32(vdup_n_u32(u4));
+        const uint8x8_t v8 = vreinterpret_u8_u32(vdup_n_u32(v4));
+        const int16x8_t u16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(u8, u8))), vdupq_n_s16(128));
+        const int16x8_t v16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(v8, v8))), vdupq_n_s16(128));
+        const uint16x8_t y16 = vmovl_u8(vld1_u8(src_y + x));
+
+        uint32x4_t lo = YuvPixels_NEON(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(y16))),
+                                       vmovl_s16(vget_low_s16(u16)), vmovl_s16(vget_low_s16(v16)));
+        uint32x4_t hi = YuvPixels_NEON(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(y16))),
+                                       vmovl_s16(vget_high_s16(u16)), vmovl_s16(vget_high_s16(v16)));
+        if (mirror) {
+            vst1q_u32(dst + width - x - 4, Reverse_NEON(lo));
+            vst1q_u32(dst + width - x - 8, Reverse_NEON(hi));
+        } else {
+            vst1q_u32(dst + x, lo);
+            vst1q_u32(dst + x + 4, hi);
+        }
+    }
+    I420ToABGRRowRange_C(src_y, src_u, src_v, dst, x, width, mirror);
+}
+#endif // IMAGE_KERNELS_NEON
+
+struct Kernels {
+    MirrorRowFunc mirror_row;
+    YuvRowFunc yuv_row;
+    MergeUVRowFunc merge_uv_row;
+    InterpolateRowFunc interpolate_row;
+    AccumulateRowFunc accumulate_row;
+    FilterColsFunc filter_cols;
+    BoxRow2xFunc box_row_2x;
+    const char* name;
+};
+
+#if defined(IMAGE_KERNELS_X86)
+const Kernels kAvx2Kernels = {MirrorRow_AVX2, I420ToABGRRow_AVX2, MergeUVRow_SSE2, InterpolateRow_SSE2, AccumulateRow_SSE2, FilterCols_AVX2, BoxRow2x_SSE2, "avx2"};
+const Kernels kSse2Kernels = {MirrorRow_SSE2, I420ToABGRRow_C, MergeUVRow_SSE2, InterpolateRow_SSE2, AccumulateRow_SSE2, FilterCols_C, BoxRow2x_SSE2, "sse2"};
+#elif defined(IMAGE_KERNELS_NEON)
+const Kernels kNeonKernels = {MirrorRow_NEON, I420ToABGRRow_NEON, MergeUVRow_NEON, InterpolateRow_NEON, AccumulateRow_NEON, FilterCols_C, BoxRow2x_NEON, "neon"};
+#endif
+const Kernels kCKernels = {MirrorRow_C, I420ToABGRRow_C, MergeUVRow_C, InterpolateRow_C, AccumulateRow_C, FilterCols_C, BoxRow2x_C, "c"};
+
+// The kernel sets this CPU can run, best first.
+std::vector<const Kernels*> SupportedKernels() {
+    std::vector<const Kernels*> supported;
+#if defined(IMAGE_KERNELS_X86)
+    if (CpuHasAVX2()) {
+        supported.push_back(&kAvx2Kernels);
+    }
+    // SSE2 is part of the x86-64 baseline.
+    supported.push_back(&kSse2Kernels);
+#elif defined(IMAGE_KERNELS_NEON)
+    // NEON is mandatory on ARM64.
+    supported.push_back(&kNeonKernels);
+#endif
+    supported.push_back(&kCKernels);
+    return supported;
+}
+
+std::atomic<const Kernels*>& ActiveKernels() {
+    static std::atomic<const Kernels*> kernels(SupportedKernels().front());
+    return kernels;
+}
+
+const Kernels& GetKernels() {
+    return *ActiveKernels().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Produces the rows of a scaled plane one at a time, so callers can
+ * consume each row (e.g. convert it) while it's still in cache.
+ */
+class RowScaler {
+public:
+    void Init(int src_width, int src_height, int dst_width, int dst_height, ScaleFilter filter) {
+        if (filter == ScaleFilter::kAuto) {
+            // Bilinear skips source pixels when shrinking by 2x or more, box averages them all.
+            filter = (src_width >= 2 * dst_width && src_height >= 2 * dst_height)
+                ? ScaleFilter::kBox : ScaleFilter::kBilinear;
+        }
+        if (src_width == src_width_ && src_height == src_height_ &&
+            dst_width == dst_width_ && dst_height == dst_height_ && filter == filter_) {
+            return;
+        }
+        src_width_ = src_width, src_height_ = src_height;
+        dst_width_ = dst_width, dst_height_ = dst_height;
+        filter_ = filter;
+
+        x0_.resize(dst_width);
+        x1_.resize(dst_width);
+        fx_.resize(dst_width);
+        // Padded, so column filters can read past the last pixel.
+        row_.resize(static_cast<size_t>(src_width) + 4);
+        if (filter == ScaleFilter::kBox) {
+            acc_.resize(src_width);
+            sums_.resize(static_cast<size_t>(src_width) + 1);
+            reciprocal_.resize(dst_width);
+            half_.resize(dst_width);
+            reciprocal_rows_ = 0;
+            for (int x = 0; x < dst_width; ++x) {
+                x0_[x] = static_cast<int>(static_cast<int64_t>(x) * src_width / dst_width);
+                x1_[x] = std::max(x0_[x] + 1, static_cast<int>(static_cast<int64_t>(x + 1) * src_width / dst_width));
+            }
+        } else {
+            for (int x = 0; x < dst_width; ++x) {
+                const int64_t pos = BilinearPosition(x, src_width, dst_width);
+                x0_[x] = static_cast<int>(pos >> 16);
+                fx_[x] = static_cast<int>((pos >> 8) & 0xFF);
+            }
+        }
+    }
+
+    void ScaleRow(const uint8_t* src, int src_stride, int dst_y, uint8_t* dst) {
+        const Kernels& kernels = GetKernels();
+
+        if (filter_ == ScaleFilter::kBox && src_width_ == 2 * dst_width_ && src_height_ == 2 * dst_height_) {
+            const uint8_t* row = src + static_cast<ptrdiff_t>(2 * dst_y) * src_stride;
+            kernels.box_row_2x(row, row + src_stride, dst, dst_width_);
+            return;
+        }
+
+        if (filter_ == ScaleFilter::kBox) {
+            const int y0 = static_cast<int>(static_cast<int64_t>(dst_y) * src_height_ / dst_height_);
+            int y1 = std::max(y0 + 1, static_cast<int>(static_cast<int64_t>(dst_y + 1) * src_height_ / dst_height_));
+            y1 = std::min(y1, y0 + 256); // keeps the 16-bit sums from overflowing.
+
+            std::fill(acc_.begin(), acc_.end(), 0);
+            for (int y = y0; y < y1; ++y) {
+                kernels.accumulate_row(src + static_cast<ptrdiff_t>(y) * src_stride, acc_.data(), src_width_);
+            }
+
+            // Prefix sums turn every column span into a single subtraction.
+            uint32_t sum = 0;
+            sums_[0] = 0;
+            for (int x = 0; x < src_width_; ++x) {
+                sum += acc_[x];
+                sums_[x + 1] = sum;
+            }
+
+            const int rows = y1 - y0;
+            if (rows != reciprocal_rows_) {
+                // ceil(2^40 / count): (n * r) >> 40 == n / count for any n < 2^24, count <= 2^16.
+                for (int x = 0; x < dst_width_; ++x) {
+                    const uint64_t count = static_cast<uint64_t>(rows) * (x1_[x] - x0_[x]);
+                    reciprocal_[x] = ((uint64_t(1) << 40) + count - 1) / count;
+                    half_[x] = static_cast<uint32_t>(count / 2);
+                }
+                reciprocal_rows_ = rows;
+            }
+            for (int x = 0; x < dst_width_; ++x) {
+                const uint64_t sum = sums_[x1_[x]] - sums_[x0_[x]] + half_[x];
+                dst[x] = static_cast<uint8_t>((sum * reciprocal_[x]) >> 40);
+            }
+            return;
+        }
+
+        const int64_t pos = BilinearPosition(dst_y, src_height_, dst_height_);
+        const int y0 = static_cast<int>(pos >> 16);
+        const int y1 = std::min(y0 + 1, src_height_ - 1);
+        const int fy = static_cast<int>((pos >> 8) & 0xFF);
+
+        const uint8_t* row = src + static_cast<ptrdiff_t>(y0) * src_stride;
+        if (fy != 0 && y1 != y0) {
+            kernels.interpolate_row(row, src + static_cast<ptrdiff_t>(y1) * src_stride, row_.data(), src_width_, fy);
+        } else {
+            memcpy(row_.data(), row, src_width_);
+        }
+        // The last pixel always has a zero fraction, repeat it for the padding.
+        memset(row_.data() + src_width_, row_[src_width_ - 1], 4);
+
+        kernels.filter_cols(row_.data(), x0_.data(), fx_.data(), dst, dst_width_);
+    }
+
+private:
+    // Source coordinate of the center of dst pixel i in 16.16 fixed point, clamped to the source.
+    static int64_t BilinearPosition(int i, int src_size, int dst_size) {
+        const int64_t pos = ((2 * static_cast<int64_t>(i) + 1) * src_size << 16) / (2 * dst_size) - 32768;
+        return std::min<int64_t>(std::max<int64_t>(pos, 0), static_cast<int64_t>(src_size - 1) << 16);
+    }
+
+    int src_width_ = 0, src_height_ = 0;
+    int dst_width_ = 0, dst_height_ = 0;
+    ScaleFilter filter_ = ScaleFilter::kAuto;
+    std::vector<int> x0_, x1_, fx_;
+    std::vector<uint8_t> row_;
+    std::vector<uint16_t> acc_;
+    std::vector<uint32_t> sums_;
+    std::vector<uint64_t> reciprocal_;
+    std::vector<uint32_t> half_;
+    int reciprocal_rows_ = 0;
+};
+
+// Scratch state of the Scale* functions, one set per thread so
+// concurrent virtual camera outputs don't share it.
+struct ScaleScratch {
+    RowScaler luma;
+    RowScaler chroma;
+    std::vector<uint8_t> rows;
+};
+
+ScaleScratch& GetScaleScratch() {
+    thread_local ScaleScratch scratch;
+    return scratch;
+}
+
+} // namespace
+
+int TransformImage32(const uint8_t* src, int src_stride,
+                     uint8_t* dst, int dst_stride,
+                     int width, int height, ImageTransform transform) {
+    if (!src || !dst || width <= 0 || height <= 0) {
+        return -1;
+    }
+
+    if (transform != ImageTransform::kMirror) {
+        // Walk the source bottom-up.
+        src = src + static_cast<ptrdiff_t>(height - 1) * src_stride;
+        src_stride = -src_stride;
+    }
+
+    if (transform == ImageTransform::kFlip) {
+        const size_t row_size = static_cast<size_t>(width) * 4;
+        for (int y = 0; y < height; ++y) {
+            memcpy(dst, src, row_size);
+            src += src_stride;
+            dst += dst_stride;
+        }
+        return 0;
+    }
+
+    const MirrorRowFunc mirror_row = GetKernels().mirror_row;
+    for (int y = 0; y < height; ++y) {
+        mirror_row(reinterpret_cast<const uint32_t*>(src), reinterpret_cast<uint32_t*>(dst), width);
+        src += src_stride;
+        dst += dst_stride;
+    }
+    return 0;
+}
+
+const char* ImageKernelName() {
+    return GetKernels().name;
+}
+
+int SetImageKernels(const char* name) {
+    for (const Kernels* kernels : SupportedKernels()) {
+        if (name != nullptr && strcmp(kernels->name, name) == 0) {
+            ActiveKernels().store(kernels, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int I420ToABGR(const uint8_t* src_y, int stride_y,
+               const uint8_t* src_u, int stride_u,
+               const uint8_t* src_v, int stride_v,
+               uint8_t* dst, int dst_stride,
+               int width, int height, bool mirror) {
+    if (!src_y || !src_u || !src_v || !dst || width <= 0 || height <= 0) {
+        return -1;
+    }
+
+    const YuvRowFunc yuv_row = GetKernels().yuv_row;
+    for (int y = 0; y < height; ++y) {
+        yuv_row(src_y, src_u, src_v, reinterpret_cast<uint32_t*>(dst), width, mirror);
+        src_y += stride_y;
+        if (y & 1) {
+            src_u += stride_u;
+            src_v += stride_v;
+        }
+        dst += dst_stride;
+    }
+    return 0;
+}
+
+int CopyPlane(const uint8_t* src, int src_stride,
+              uint8_t* dst, int dst_stride,
+              int width, int height) {
+    if (!src || !dst || width <= 0 || height <= 0) {
+        return -1;
+    }
+
+    if (src_stride == width && dst_stride == width) {
+        memcpy(dst, src, static_cast<size_t>(width) * height);
+        return 0;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        memcpy(dst, src, width);
+        src += src_stride;
+        dst += dst_stride;
+    }
+    return 0;
+}
+
+int I420ToNV12(const uint8_t* src_y, int stride_y,
+               const uint8_t* src_u, int stride_u,
+               const uint8_t* src_v, int stride_v,
+               uint8_t* dst_y, int dst_stride_y,
+               uint8_t* dst_uv, int dst_stride_uv,
+               int width, int height) {
+    if (!src_u || !src_v || !dst_uv ||
+        CopyPlane(src_y, stride_y, dst_y, dst_stride_y, width, height) != 0) {
+        return -1;
+    }
+
+    const MergeUVRowFunc merge_uv_row = GetKernels().merge_uv_row;
+    const int chroma_width = (width + 1) / 2;
+    const int chroma_height = (height + 1) / 2;
+    for (int y = 0; y < chroma_height; ++y) {
+        merge_uv_row(src_u, src_v, dst_uv, chroma_width);
+        src_u += stride_u;
+        src_v += stride_v;
+        dst_uv += dst_stride_uv;
+    }
+    return 0;
+}
+
+int ScalePlane(const uint8_t* src, int src_stride, int src_width, int src_height,
+               uint8_t* dst, int dst_stride, int dst_width, int dst_height,
+               ScaleFilter filter) {
+    if (!src || !dst || src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return -1;
+    }
+    if (src_width == dst_width && src_height == dst_height) {
+        return CopyPlane(src, src_stride, dst, dst_stride, dst_width, dst_height);
+    }
+
+    RowScaler& scaler = GetScaleScratch().luma;
+    scaler.Init(src_width, src_height, dst_width, dst_height, filter);
+    for (int y = 0; y < dst_height; ++y) {
+        scaler.ScaleRow(src, src_stride, y, dst + static_cast<ptrdiff_t>(y) * dst_stride);
+    }
+    return 0;
+}
+
+int I420ScaleToABGR(const uint8_t* src_y, int stride_y,
+                    const uint8_t* src_u, int stride_u,
+                    const uint8_t* src_v, int stride_v,
+                    int src_width, int src_height,
+                    uint8_t* dst, int dst_stride,
+                    int dst_width, int dst_height,
+                    bool mirror, ScaleFilter filter) {
+    if (src_width == dst_width && src_height == dst_height) {
+        return I420ToABGR(src_y, stride_y, src_u, stride_u, src_v, stride_v,
+                          dst, dst_stride, dst_width, dst_height, mirror);
+    }
+    if (!src_y || !src_u || !src_v || !dst || src_width <= 0 || src_height <= 0 ||
+        dst_width <= 0 || dst_height <= 0) {
+        return -1;
+    }
+
+    const int src_chroma_width = (src_width + 1) / 2, src_chroma_height = (src_height + 1) / 2;
+    const int dst_chroma_width = (dst_width + 1) / 2, dst_chroma_height = (dst_height + 1) / 2;
+
+    ScaleScratch& scratch = GetScaleScratch();
+    scratch.luma.Init(src_width, src_height, dst_width, dst_height, filter);
+    scratch.chroma.Init(src_chroma_width, src_chroma_height, dst_chroma_width, dst_chroma_height, filter);
+    scratch.rows.resize(static_cast<size_t>(dst_width) + 2 * static_cast<size_t>(dst_chroma_width));
+    uint8_t* row_y = scratch.rows.data();
+    uint8_t* row_u = row_y + dst_width;
+    uint8_t* row_v = row_u + dst_chroma_width;
+
+    // Scale a row of each plane, then convert it before moving on.
+    const YuvRowFunc yuv_row = GetKernels().yuv_row;
+    for (int y = 0; y < dst_height; ++y) {
+        scratch.luma.ScaleRow(src_y, stride_y, y, row_y);
+        if ((y & 1) == 0) {
+            scratch.chroma.ScaleRow(src_u, stride_u, y >> 1, row_u);
+            scratch.chroma.ScaleRow(src_v, stride_v, y >> 1, row_v);
+        }
+        yuv_row(row_y, row_u, row_v, reinterpret_cast<uint32_t*>(dst), dst_width, mirror);
+        dst += dst_stride;
+    }
+    return 0;
+}
+
+int I420Scale(const uint8_t* src_y, int stride_y,
+              const uint8_t* src_u, int stride_u,
+              const uint8_t* src_v, int stride_v,
+              int src_width, int src_height,
+              uint8_t* dst_y, int dst_stride_y,
+              uint8_t* dst_u, int dst_stride_u,
+              uint8_t* dst_v, int dst_stride_v,
+              int dst_width, int dst_height, ScaleFilter filter) {
+    const int src_chroma_width = (src_width + 1) / 2, src_chroma_height = (src_height + 1) / 2;
+    const int dst_chroma_width = (dst_width + 1) / 2, dst_chroma_height = (dst_height + 1) / 2;
+    if (ScalePlane(src_y, stride_y, src_width, src_height,
+                   dst_y, dst_stride_y, dst_width, dst_height, filter) != 0 ||
+        ScalePlane(src_u, stride_u, src_chroma_width, src_chroma_height,
+                   dst_u, dst_stride_u, dst_chroma_width, dst_chroma_height, filter) != 0 ||
+        ScalePlane(src_v, stride_v, src_chroma_width, src_chroma_height,
+                   dst_v, dst_stride_v, dst_chroma_width, dst_chroma_height, filter) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int I420ScaleToNV12(const uint8_t* src_y, int stride_y,
+                    const uint8_t* src_u, int stride_u,
+                    const uint8_t* src_v, int stride_v,
+                    int src_width, int src_height,
+                    uint8_t* dst_y, int dst_stride_y,
+                    uint8_t* dst_uv, int dst_stride_uv,
+                    int dst_width, int dst_height, ScaleFilter filter) {
+    if (src_width == dst_width && src_height == dst_height) {
+        return I420ToNV12(src_y, stride_y, src_u, stride_u, src_v, stride_v,
+                          dst_y, dst_stride_y, dst_uv, dst_stride_uv, dst_width, dst_height);
+    }
+    if (!src_u || !src_v || !dst_uv ||
+        ScalePlane(src_y, stride_y, src_width, src_height,
+                   dst_y, dst_stride_y, dst_width, dst_height, filter) != 0) {
+        return -1;
+    }
+
+    const int src_chroma_width = (src_width + 1) / 2, src_chroma_height = (src_height + 1) / 2;
+    const int dst_chroma_width = (dst_width + 1) / 2, dst_chroma_height = (dst_height + 1) / 2;
+
+    ScaleScratch& scratch = GetScaleScratch();
+    scratch.chroma.Init(src_chroma_width, src_chroma_height, dst_chroma_width, dst_chroma_height, filter);
+    scratch.rows.resize(2 * static_cast<size_t>(dst_chroma_width));
+    uint8_t* row_u = scratch.rows.data();
+    uint8_t* row_v = row_u + dst_chroma_width;
+
+    const MergeUVRowFunc merge_uv_row = GetKernels().merge_uv_row;
+    for (int y = 0; y < dst_chroma_height; ++y) {
+        scratch.chroma.ScaleRow(src_u, stride_u, y, row_u);
+        scratch.chroma.ScaleRow(src_v, stride_v, y, row_v);
+        merge_uv_row(row_u, row_v, dst_uv, dst_chroma_width);
+        dst_uv += dst_stride_uv;
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+#include <cstdint>
+
+/**
+ * @brief Orientation change applied by TransformImage32.
+ */
+enum class ImageTransform {
+    kFlip,        // Reverse the row order (vertical flip).
+    kMirror,      // Reverse the pixels of each row (horizontal mirror).
+    kFlipMirror,  // Both of the above, i.e. a 180 degree rotation.
+};
+
+/**
+ * @brief Filter used when scaling.
+ */
+enum class ScaleFilter {
+    kAuto,      // kBox when shrinking by 2x or more in both directions, kBilinear otherwise.
+    kBilinear,  // Interpolates the 2x2 nearest source pixels.
+    kBox,       // Averages all source pixels covered by a destination pixel.
+};
+
+/**
+ * @brief Flip and/or mirror an image of 32-bit pixels (BGRA, RGBA, ...).
+ *
+ * The row kernel is picked once at runtime from the CPU features
+ * (AVX2, SSE2 or NEON), falling back to scalar code.
+ *
+ * @param[in] src Source image.
+ * @param[in] src_stride Bytes between source rows.
+ * @param[out] dst Destination image, must not overlap src.
+ * @param[in] dst_stride Bytes between destination rows.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @param[in] transform The transform to apply.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int TransformImage32(const uint8_t* src, int src_stride,
+                     uint8_t* dst, int dst_stride,
+                     int width, int height, ImageTransform transform);
+
+/**
+ * @brief Convert an I420 image to 32-bit pixels laid out R, G, B, A in
+ * memory (libyuv's ABGR), using BT.601 limited range coefficients.
+ *
+ * A negative dst_stride writes the rows bottom-up, pass the address of
+ * the last destination row in that case.
+ *
+ * @param[in] src_y, src_u, src_v The Y, U and V planes.
+ * @param[in] stride_y, stride_u, stride_v Bytes between rows of each plane.
+ * @param[out] dst Destination image.
+ * @param[in] dst_stride Bytes between destination rows, may be negative.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @param[in] mirror Reverse the pixels of each row while converting.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int I420ToABGR(const uint8_t* src_y, int stride_y,
+               const uint8_t* src_u, int stride_u,
+               const uint8_t* src_v, int stride_v,
+               uint8_t* dst, int dst_stride,
+               int width, int height, bool mirror);
+
+/**
+ * @brief Copy a plane of 8-bit samples row by row.
+ *
+ * @param[in] src Source plane.
+ * @param[in] src_stride Bytes between source rows.
+ * @param[out] dst Destination plane.
+ * @param[in] dst_stride Bytes between destination rows.
+ * @param[in] width Width in bytes.
+ * @param[in] height Height in rows.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int CopyPlane(const uint8_t* src, int src_stride,
+              uint8_t* dst, int dst_stride,
+              int width, int height);
+
+/**
+ * @brief Convert an I420 image to NV12, copying Y and interleaving U and V.
+ *
+ * @param[in] src_y, src_u, src_v The Y, U and V planes.
+ * @param[in] stride_y, stride_u, stride_v Bytes between rows of each plane.
+ * @param[out] dst_y Destination Y plane.
+ * @param[in] dst_stride_y Bytes between destination Y rows.
+ * @param[out] dst_uv Destination interleaved UV plane.
+ * @param[in] dst_stride_uv Bytes between destination UV rows.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int I420ToNV12(const uint8_t* src_y, int stride_y,
+               const uint8_t* src_u, int stride_u,
+               const uint8_t* src_v, int stride_v,
+               uint8_t* dst_y, int dst_stride_y,
+               uint8_t* dst_uv, int dst_stride_uv,
+               int width, int height);
+
+/**
+ * @brief Scale a plane of 8-bit samples.
+ *
+ * @param[in] src Source plane.
+ * @param[in] src_stride Bytes between source rows.
+ * @param[in] src_width, src_height Source size.
+ * @param[out] dst Destination plane.
+ * @param[in] dst_stride Bytes between destination rows.
+ * @param[in] dst_width, dst_height Destination size.
+ * @param[in] filter The filter to use.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int ScalePlane(const uint8_t* src, int src_stride, int src_width, int src_height,
+               uint8_t* dst, int dst_stride, int dst_width, int dst_height,
+               ScaleFilter filter);
+
+/**
+ * @brief Scale and convert an I420 image to ABGR in one pass, see I420ToABGR.
+ *
+ * Each destination row is scaled into a scratch row and converted right away,
+ * no scaled frame is ever materialized.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int I420ScaleToABGR(const uint8_t* src_y, int stride_y,
+                    const uint8_t* src_u, int stride_u,
+                    const uint8_t* src_v, int stride_v,
+                    int src_width, int src_height,
+                    uint8_t* dst, int dst_stride,
+                    int dst_width, int dst_height,
+                    bool mirror, ScaleFilter filter);
+
+/**
+ * @brief Scale an I420 image.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int I420Scale(const uint8_t* src_y, int stride_y,
+              const uint8_t* src_u, int stride_u,
+              const uint8_t* src_v, int stride_v,
+              int src_width, int src_height,
+              uint8_t* dst_y, int dst_stride_y,
+              uint8_t* dst_u, int dst_stride_u,
+              uint8_t* dst_v, int dst_stride_v,
+              int dst_width, int dst_height, ScaleFilter filter);
+
+/**
+ * @brief Scale an I420 image into NV12, see I420ToNV12.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int I420ScaleToNV12(const uint8_t* src_y, int stride_y,
+                    const uint8_t* src_u, int stride_u,
+                    const uint8_t* src_v, int stride_v,
+                    int src_width, int src_height,
+                    uint8_t* dst_y, int dst_stride_y,
+                    uint8_t* dst_uv, int dst_stride_uv,
+                    int dst_width, int dst_height, ScaleFilter filter);
+
+/**
+ * @brief Name of the row kernels selected for this CPU ("avx2", "sse2", "neon" or "c").
+ */
+const char* ImageKernelName();
+
+/**
+ * @brief Use the named row kernels instead of the ones selected for this CPU,
+ * so tests and benchmarks can run every variant. Call while no conversion runs.
+ *
+ * @param[in] name "avx2", "sse2", "neon" or "c".
+ *
+ * @return 0: Success, -1: Failure (unknown, or not supported by this CPU).
+ */
+int SetImageKernels(const char* name);
+
+#endif // IMAGE_KERNELS_H
@@ -35,12 +35,16 @@ struct SharedImageMemory
 		if (m_hWantFrameEvent) CloseHandle(m_hWantFrameEvent);
 		if (m_hSentFrameEvent) CloseHandle(m_hSentFrameEvent);
 		if (m_hSharedFile) CloseHandle(m_hSharedFile);
+		if (m_pExt) UnmapViewOfFile(m_pExt);
+		if (m_hExtFile) CloseHandle(m_hExtFile);
 	}
 
 	int32_t GetCapNum() { return m_CapNum; }
 	enum { MAX_CAPNUM = ('z' - '0') }; //see Open() for why this number
 	enum { RECEIVE_MAX_WAIT = 200 }; //How many milliseconds to wait for new frame
-	enum EFormat { FORMAT_UINT8, FORMAT_FP16_GAMMA, FORMAT_FP16_LINEAR };
+	enum EFormat { FORMAT_UINT8, FORMAT_FP16_GAMMA, FORMAT_FP16_LINEAR, FORMAT_I420, FORMAT_NV12 };
+	enum { LEGACY_FORMATS = (1 << FORMAT_UINT8) | (1 << FORMAT_FP16_GAMMA) | (1 << FORMAT_FP16_LINEAR) };
+	enum { EXT_VERSION = 2 }; //2: sentTimeNs
 	enum EResizeMode { RESIZEMODE_DISABLED = 0, RESIZEMODE_LINEAR = 1 };
 	enum EMirrorMode { MIRRORMODE_DISABLED = 0, MIRRORMODE_HORIZONTALLY = 1 };
 	enum EReceiveResult { RECEIVERES_CAPTUREINACTIVE, RECEIVERES_NEWFRAME, RECEIVERES_OLDFRAME };
@@ -66,6 +70,39 @@ struct SharedImageMemory
 		return Open(false);
 	}
 
+	// Sender: whether a receiver asked for a frame since the last Send, call after SendIsReady.
+	// Receivers only start asking once a first frame was sent, so an empty buffer counts as asked.
+	bool WantsFrame()
+	{
+		if (!m_pSharedBuf->width) return true;
+		if (WaitForSingleObject(m_hWantFrameEvent, 0) != WAIT_OBJECT_0) return false;
+		SetEvent(m_hWantFrameEvent); //put the request back, Send consumes it
+		return true;
+	}
+
+	// Receiver: advertise the formats (bitmask of 1 << EFormat) it can consume.
+	// Receivers that never call this (e.g. the original filter) only get LEGACY_FORMATS.
+	void SetAcceptedFormats(uint32_t Formats)
+	{
+		m_AcceptedFormats = Formats;
+		if (m_pExt) m_pExt->acceptedFormats = Formats;
+	}
+
+	// Sender: whether the receiver advertised support for Format, call after SendIsReady.
+	bool AcceptsFormat(EFormat Format)
+	{
+		if (!m_pExt) return (LEGACY_FORMATS & (1 << Format)) != 0;
+		return m_pExt->version >= 1 && (m_pExt->acceptedFormats & (1 << Format)) != 0;
+	}
+
+	// Receiver: plane layout of the current planar frame, call from within the Receive callback.
+	bool GetPlaneLayout(uint32_t (&PlaneOffsets)[3], int (&PlaneStrides)[3])
+	{
+		if (!m_pExt) return false;
+		for (int i = 0; i < 3; i++) { PlaneOffsets[i] = m_pExt->planeOffset[i]; PlaneStrides[i] = m_pExt->planeStride[i]; }
+		return true;
+	}
+
 	enum ESendResult { SENDRES_TOOLARGE, SENDRES_WARN_FRAMESKIP, SENDRES_OK };
 	ESendResult Send(int width, int height, int stride, DWORD DataSize, EFormat format, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, const uint8_t* buffer)
 	{
@@ -73,6 +110,8 @@ struct SharedImageMemory
 		UCASSERT(m_pSharedBuf);
 		if (m_pSharedBuf->maxSize < DataSize) return SENDRES_TOOLARGE;
 
+		// Take the request before writing, one made while writing is for the next frame.
+		bool DidSkipFrame = (WaitForSingleObject(m_hWantFrameEvent, 0) != WAIT_OBJECT_0);
 		WaitForSingleObject(m_hMutex, INFINITE); //lock mutex
 		m_pSharedBuf->width = width;
 		m_pSharedBuf->height = height;
@@ -82,14 +121,68 @@ struct SharedImageMemory
 		m_pSharedBuf->mirrormode = mirrormode;
 		m_pSharedBuf->timeout = timeout;
 		memcpy(m_pSharedBuf->data, buffer, DataSize);
+		if (m_pExt && m_pExt->version >= 2) m_pExt->sentTimeNs = NowNs();
 		ReleaseMutex(m_hMutex); //unlock mutex
 
 		SetEvent(m_hSentFrameEvent);
+		return (DidSkipFrame ? SENDRES_WARN_FRAMESKIP : SENDRES_OK);
+	}
+
+	// Like Send, but lets the caller write the frame straight into the shared buffer
+	// (while holding the mutex) instead of copying a prepared buffer into it.
+	template <typename WriteFunc>
+	ESendResult SendInPlace(int width, int height, int stride, DWORD DataSize, EFormat format, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, WriteFunc write)
+	{
+		UCASSERT(m_pSharedBuf);
+		if (m_pSharedBuf->maxSize < DataSize) return SENDRES_TOOLARGE;
+
+		// Take the request before writing, one made while writing is for the next frame.
 		bool DidSkipFrame = (WaitForSingleObject(m_hWantFrameEvent, 0) != WAIT_OBJECT_0);
+		WaitForSingleObject(m_hMutex, INFINITE); //lock mutex
+		m_pSharedBuf->width = width;
+		m_pSharedBuf->height = height;
+		m_pSharedBuf->stride = stride;
+		m_pSharedBuf->format = format;
+		m_pSharedBuf->resizemode = resizemode;
+		m_pSharedBuf->mirrormode = mirrormode;
+		m_pSharedBuf->timeout = timeout;
+		write(m_pSharedBuf->data);
+		if (m_pExt && m_pExt->version >= 2) m_pExt->sentTimeNs = NowNs();
+		ReleaseMutex(m_hMutex); //unlock mutex
 
+		SetEvent(m_hSentFrameEvent);
 		return (DidSkipFrame ? SENDRES_WARN_FRAMESKIP : SENDRES_OK);
 	}
 
+	// Like SendInPlace for FORMAT_I420 / FORMAT_NV12 frames. Planes are stored top-down
+	// at PlaneOffsets from the start of the frame data, the header stride is the Y stride.
+	template <typename WriteFunc>
+	ESendResult SendPlanarInPlace(int width, int height, EFormat format, const uint32_t (&PlaneOffsets)[3], const int (&PlaneStrides)[3], DWORD DataSize, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, WriteFunc write)
+	{
+		UCASSERT(m_pExt);
+		return SendInPlace(width, height, PlaneStrides[0], DataSize, format, resizemode, mirrormode, timeout,
+			[&](uint8_t* data)
+			{
+				for (int i = 0; i < 3; i++) { m_pExt->planeOffset[i] = PlaneOffsets[i]; m_pExt->planeStride[i] = PlaneStrides[i]; }
+				write(data);
+			});
+	}
+
+	// Monotonic time at which the current frame was published, for latency measurements.
+	// 0 if the receiver's extension predates version 2.
+	uint64_t GetSentTimeNs()
+	{
+		return (m_pExt && m_pExt->version >= 2) ? m_pExt->sentTimeNs : 0;
+	}
+
+	static uint64_t NowNs()
+	{
+		LARGE_INTEGER Counter, Frequency;
+		QueryPerformanceCounter(&Counter);
+		QueryPerformanceFrequency(&Frequency);
+		return (uint64_t)(Counter.QuadPart / Frequency.QuadPart) * 1000000000ull + (uint64_t)(Counter.QuadPart % Frequency.QuadPart) * 1000000000ull / (uint64_t)Frequency.QuadPart;
+	}
+
 private:
 	bool Open(bool ForReceiving)
 	{
@@ -102,6 +195,7 @@ private:
 		char CS_NAME_EVENT_WANT [] = "UnityCapture_Want0"; CS_NAME_EVENT_WANT [sizeof(CS_NAME_EVENT_WANT ) - 2] = CSCapNumChar;
 		char CS_NAME_EVENT_SENT [] = "UnityCapture_Sent0"; CS_NAME_EVENT_SENT [sizeof(CS_NAME_EVENT_SENT ) - 2] = CSCapNumChar;
 		char CS_NAME_SHARED_DATA[] = "UnityCapture_Data0"; CS_NAME_SHARED_DATA[sizeof(CS_NAME_SHARED_DATA) - 2] = CSCapNumChar;
+		char CS_NAME_SHARED_EXT [] = "UnityCapture_Ext0";  CS_NAME_SHARED_EXT [sizeof(CS_NAME_SHARED_EXT ) - 2] = CSCapNumChar;
 
 		if (!m_hMutex)
 		{
@@ -127,6 +221,15 @@ private:
 			if (!m_hSentFrameEvent) return false;
 		}
 
+		if (!m_hExtFile)
+		{
+			// Optional, senders fall back to the legacy formats if the receiver doesn't create it.
+			if (ForReceiving) m_hExtFile = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, NULL, sizeof(SharedMemExtHeader), CS_NAME_SHARED_EXT);
+			else              m_hExtFile = OpenFileMappingA(FILE_MAP_WRITE, FALSE, CS_NAME_SHARED_EXT);
+			if (m_hExtFile) m_pExt = (SharedMemExtHeader*)MapViewOfFile(m_hExtFile, FILE_MAP_WRITE, 0, 0, 0);
+			if (m_pExt && ForReceiving) { m_pExt->acceptedFormats = (m_AcceptedFormats ? m_AcceptedFormats : (uint32_t)LEGACY_FORMATS); m_pExt->version = EXT_VERSION; }
+		}
+
 		if (!m_hSharedFile)
 		{
 			if (ForReceiving) m_hSharedFile = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, NULL, sizeof(SharedMemHeader) + MAX_SHARED_IMAGE_SIZE, CS_NAME_SHARED_DATA);
@@ -156,10 +259,24 @@ private:
 		uint8_t data[1];
 	};
 
+	// Versioned extension living in its own mapping, so the layout of SharedMemHeader
+	// stays what existing receivers expect.
+	struct SharedMemExtHeader
+	{
+		volatile uint32_t version;
+		volatile uint32_t acceptedFormats; //bitmask of 1 << EFormat, written by the receiver
+		uint32_t planeOffset[3];  //of the current planar frame, from SharedMemHeader::data
+		int planeStride[3];
+		volatile uint64_t sentTimeNs; //NowNs() when the current frame was published, version 2
+	};
+
 	int32_t m_CapNum;
 	HANDLE m_hMutex;
 	HANDLE m_hWantFrameEvent;
 	HANDLE m_hSentFrameEvent;
 	HANDLE m_hSharedFile;
 	SharedMemHeader* m_pSharedBuf;
+	HANDLE m_hExtFile;
+	SharedMemExtHeader* m_pExt;
+	uint32_t m_AcceptedFormats;
 };
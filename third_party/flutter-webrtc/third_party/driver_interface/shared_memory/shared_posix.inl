@@ -0,0 +1,357 @@
+/*
+  POSIX port of the Unity Capture shared memory protocol (see shared.inl).
+
+  The Win32 version uses a named mutex, two named auto-reset events and a
+  named file mapping per CapNum. Here all of them live in a single shm_open
+  object of the same name: a control block holding a process-shared robust
+  mutex and two futex words standing in for the events, followed by the
+  same SharedMemHeader and frame data as on Windows.
+
+  Receivers create the object and own it, like the Win32 mapping it goes
+  away with the last of them: that one unlinks the name on teardown and
+  flags the object, so senders drop their mapping and wait for the next
+  receiver's. A receiver that crashes leaves the name behind, the next
+  receiver reuses it.
+*/
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define MAX_SHARED_IMAGE_SIZE (3840 * 2160 * 4 * sizeof(short)) //4K (RGBA max 16bit per pixel)
+
+#define UCASSERT(cond) ((void)0)
+
+struct SharedImageMemory
+{
+	SharedImageMemory(int32_t CapNum)
+	{
+		m_CapNum = CapNum;
+		m_pControl = NULL;
+		m_pSharedBuf = NULL;
+		m_MappingSize = 0;
+		m_AcceptedFormats = 0;
+		m_IsReceiver = false;
+	}
+
+	~SharedImageMemory()
+	{
+		Close();
+	}
+
+	int32_t GetCapNum() { return m_CapNum; }
+	enum { MAX_CAPNUM = ('z' - '0') }; //see GetName() for why this number
+	enum { RECEIVE_MAX_WAIT = 200 }; //How many milliseconds to wait for new frame
+	enum EFormat { FORMAT_UINT8, FORMAT_FP16_GAMMA, FORMAT_FP16_LINEAR, FORMAT_I420, FORMAT_NV12 };
+	enum { LEGACY_FORMATS = (1 << FORMAT_UINT8) | (1 << FORMAT_FP16_GAMMA) | (1 << FORMAT_FP16_LINEAR) };
+	enum { EXT_VERSION = 2 }; //2: sentTimeNs
+	enum EResizeMode { RESIZEMODE_DISABLED = 0, RESIZEMODE_LINEAR = 1 };
+	enum EMirrorMode { MIRRORMODE_DISABLED = 0, MIRRORMODE_HORIZONTALLY = 1 };
+	enum EReceiveResult { RECEIVERES_CAPTUREINACTIVE, RECEIVERES_NEWFRAME, RECEIVERES_OLDFRAME };
+
+	typedef void (*ReceiveCallbackFunc)(int width, int height, int stride, EFormat format, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, uint8_t* buffer, void* callback_data);
+
+	EReceiveResult Receive(ReceiveCallbackFunc callback, void* callback_data)
+	{
+		if (!Open(true) || !m_pSharedBuf->width) return RECEIVERES_CAPTUREINACTIVE;
+
+		SetEvent(&m_pControl->wantFrame);
+		bool IsNewFrame = WaitEvent(&m_pControl->sentFrame, RECEIVE_MAX_WAIT);
+
+		Lock(); //lock mutex
+		callback(m_pSharedBuf->width, m_pSharedBuf->height, m_pSharedBuf->stride, (EFormat)m_pSharedBuf->format, (EResizeMode)m_pSharedBuf->resizemode, (EMirrorMode)m_pSharedBuf->mirrormode, m_pSharedBuf->timeout, m_pSharedBuf->data, callback_data);
+		Unlock(); //unlock mutex
+
+		return (IsNewFrame ? RECEIVERES_NEWFRAME : RECEIVERES_OLDFRAME);
+	}
+
+	bool SendIsReady()
+	{
+		if (m_pControl && m_pControl->unlinked.load()) Close(); //the receivers are gone, look for a new object
+		return Open(false);
+	}
+
+	// Sender: whether a receiver asked for a frame since the last Send, call after SendIsReady.
+	// Receivers only start asking once a first frame was sent, so an empty buffer counts as asked.
+	bool WantsFrame()
+	{
+		return !m_pSharedBuf->width || m_pControl->wantFrame.load() == 1;
+	}
+
+	// Receiver: advertise the formats (bitmask of 1 << EFormat) it can consume.
+	// Receivers that never call this only get LEGACY_FORMATS.
+	void SetAcceptedFormats(uint32_t Formats)
+	{
+		m_AcceptedFormats = Formats;
+		if (m_pControl) m_pControl->ext.acceptedFormats = Formats;
+	}
+
+	// Sender: whether the receiver advertised support for Format, call after SendIsReady.
+	bool AcceptsFormat(EFormat Format)
+	{
+		if (!m_pControl) return (LEGACY_FORMATS & (1 << Format)) != 0;
+		return m_pControl->ext.version >= 1 && (m_pControl->ext.acceptedFormats & (1 << Format)) != 0;
+	}
+
+	// Receiver: plane layout of the current planar frame, call from within the Receive callback.
+	bool GetPlaneLayout(uint32_t (&PlaneOffsets)[3], int (&PlaneStrides)[3])
+	{
+		if (!m_pControl) return false;
+		for (int i = 0; i < 3; i++) { PlaneOffsets[i] = m_pControl->ext.planeOffset[i]; PlaneStrides[i] = m_pControl->ext.planeStride[i]; }
+		return true;
+	}
+
+	enum ESendResult { SENDRES_TOOLARGE, SENDRES_WARN_FRAMESKIP, SENDRES_OK };
+	ESendResult Send(int width, int height, int stride, uint32_t DataSize, EFormat format, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, const uint8_t* buffer)
+	{
+		return SendInPlace(width, height, stride, DataSize, format, resizemode, mirrormode, timeout,
+			[&](uint8_t* data) { memcpy(data, buffer, DataSize); });
+	}
+
+	// Like Send, but lets the caller write the frame straight into the shared buffer
+	// (while holding the mutex) instead of copying a prepared buffer into it.
+	template <typename WriteFunc>
+	ESendResult SendInPlace(int width, int height, int stride, uint32_t DataSize, EFormat format, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, WriteFunc write)
+	{
+		UCASSERT(m_pSharedBuf);
+		if (m_pSharedBuf->maxSize < DataSize) return SENDRES_TOOLARGE;
+
+		// Take the request before writing, one made while writing is for the next frame.
+		bool DidSkipFrame = !WaitEvent(&m_pControl->wantFrame, 0);
+		Lock(); //lock mutex
+		m_pSharedBuf->width = width;
+		m_pSharedBuf->height = height;
+		m_pSharedBuf->stride = stride;
+		m_pSharedBuf->format = format;
+		m_pSharedBuf->resizemode = resizemode;
+		m_pSharedBuf->mirrormode = mirrormode;
+		m_pSharedBuf->timeout = timeout;
+		write(m_pSharedBuf->data);
+		m_pControl->ext.sentTimeNs = NowNs();
+		Unlock(); //unlock mutex
+
+		SetEvent(&m_pControl->sentFrame);
+		return (DidSkipFrame ? SENDRES_WARN_FRAMESKIP : SENDRES_OK);
+	}
+
+	// Like SendInPlace for FORMAT_I420 / FORMAT_NV12 frames. Planes are stored top-down
+	// at PlaneOffsets from the start of the frame data, the header stride is the Y stride.
+	template <typename WriteFunc>
+	ESendResult SendPlanarInPlace(int width, int height, EFormat format, const uint32_t (&PlaneOffsets)[3], const int (&PlaneStrides)[3], uint32_t DataSize, EResizeMode resizemode, EMirrorMode mirrormode, int timeout, WriteFunc write)
+	{
+		UCASSERT(m_pControl);
+		return SendInPlace(width, height, PlaneStrides[0], DataSize, format, resizemode, mirrormode, timeout,
+			[&](uint8_t* data)
+			{
+				for (int i = 0; i < 3; i++) { m_pControl->ext.planeOffset[i] = PlaneOffsets[i]; m_pControl->ext.planeStride[i] = PlaneStrides[i]; }
+				write(data);
+			});
+	}
+
+	// Monotonic time at which the current frame was published, for latency measurements.
+	uint64_t GetSentTimeNs()
+	{
+		return m_pControl ? m_pControl->ext.sentTimeNs : 0;
+	}
+
+	static uint64_t NowNs()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+	}
+
+	// Name of the shared memory object of CapNum, as passed to shm_open.
+	static void GetName(int32_t CapNum, char (&Name)[32])
+	{
+		if (CapNum > MAX_CAPNUM) CapNum = MAX_CAPNUM;
+		char CSCapNumChar = (CapNum ? '0' + CapNum : '\0'); //same naming as the Win32 objects
+		strcpy(Name, "/UnityCapture_Data0");
+		Name[sizeof("/UnityCapture_Data0") - 2] = CSCapNumChar;
+	}
+
+private:
+	enum { CONTROL_MAGIC = 0x55434d34 }; //'UCM4', bumped whenever SharedControl changes
+
+	// Same fields as the Win32 UnityCapture_Ext mapping.
+	struct SharedMemExtHeader
+	{
+		volatile uint32_t version;
+		volatile uint32_t acceptedFormats; //bitmask of 1 << EFormat, written by the receiver
+		uint32_t planeOffset[3];  //of the current planar frame, from SharedMemHeader::data
+		int planeStride[3];
+		volatile uint64_t sentTimeNs; //NowNs() when the current frame was published, version 2
+	};
+
+	struct SharedControl
+	{
+		std::atomic<uint32_t> magic;
+		std::atomic<uint32_t> wantFrame; //auto-reset event, 1 when signaled
+		std::atomic<uint32_t> sentFrame; //auto-reset event, 1 when signaled
+		std::atomic<uint32_t> unlinked; //1 once the last receiver unlinked the name
+		uint32_t receivers; //receivers that have it open, guarded by mutex
+		pthread_mutex_t mutex;
+		SharedMemExtHeader ext;
+	};
+
+	struct SharedMemHeader
+	{
+		uint32_t maxSize;
+		int width;
+		int height;
+		int stride;
+		int format;
+		int resizemode;
+		int mirrormode;
+		int timeout;
+		uint8_t data[1];
+	};
+
+	enum { HEADER_OFFSET = (sizeof(SharedControl) + 63) & ~63 };
+
+	bool Open(bool ForReceiving)
+	{
+		if (m_pSharedBuf) return true; //already open
+
+		char Name[32];
+		GetName(m_CapNum, Name);
+
+		const size_t Size = HEADER_OFFSET + sizeof(SharedMemHeader) + MAX_SHARED_IMAGE_SIZE;
+		int fd = shm_open(Name, ForReceiving ? (O_RDWR | O_CREAT) : O_RDWR, 0666);
+		if (fd < 0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || ((size_t)st.st_size < Size && (!ForReceiving || ftruncate(fd, Size) != 0)))
+		{
+			close(fd);
+			return false;
+		}
+
+		void* p = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (p == MAP_FAILED) return false;
+
+		SharedControl* control = (SharedControl*)p;
+		if (control->magic.load() != CONTROL_MAGIC)
+		{
+			if (!ForReceiving) { munmap(p, Size); return false; } //receiver didn't initialize it yet
+
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+			pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+			pthread_mutex_init(&control->mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
+			control->wantFrame.store(0);
+			control->sentFrame.store(0);
+			control->unlinked.store(0);
+			control->receivers = 0;
+			control->ext.sentTimeNs = 0;
+			control->magic.store(CONTROL_MAGIC);
+		}
+
+		m_pControl = control;
+		m_MappingSize = Size;
+		m_pSharedBuf = (SharedMemHeader*)((uint8_t*)p + HEADER_OFFSET);
+
+		if (ForReceiving)
+		{
+			// Opened just as the last receiver unlinked it, try again with the next one.
+			Lock();
+			const bool Unlinked = (control->unlinked.load() != 0);
+			if (!Unlinked) control->receivers++;
+			Unlock();
+			if (Unlinked) { Close(); return false; }
+			m_IsReceiver = true;
+			m_pControl->ext.acceptedFormats = (m_AcceptedFormats ? m_AcceptedFormats : (uint32_t)LEGACY_FORMATS);
+			m_pControl->ext.version = EXT_VERSION;
+		}
+
+		if (ForReceiving && m_pSharedBuf->maxSize != MAX_SHARED_IMAGE_SIZE)
+			m_pSharedBuf->maxSize = MAX_SHARED_IMAGE_SIZE;
+
+		return true;
+	}
+
+	void Close()
+	{
+		if (!m_pControl) return;
+		if (m_IsReceiver)
+		{
+			Lock();
+			if (--m_pControl->receivers == 0)
+			{
+				char Name[32];
+				GetName(m_CapNum, Name);
+				m_pControl->unlinked.store(1);
+				shm_unlink(Name);
+			}
+			Unlock();
+		}
+		munmap(m_pControl, m_MappingSize);
+		m_pControl = NULL;
+		m_pSharedBuf = NULL;
+		m_MappingSize = 0;
+		m_IsReceiver = false;
+	}
+
+	void Lock()
+	{
+		if (pthread_mutex_lock(&m_pControl->mutex) == EOWNERDEAD)
+			pthread_mutex_consistent(&m_pControl->mutex); //the other side died while holding it
+	}
+
+	void Unlock()
+	{
+		pthread_mutex_unlock(&m_pControl->mutex);
+	}
+
+	static void SetEvent(std::atomic<uint32_t>* Event)
+	{
+		Event->store(1);
+#ifdef __linux__
+		syscall(SYS_futex, (uint32_t*)Event, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+	}
+
+	// Returns true if the event was signaled within TimeoutMs, resetting it.
+	static bool WaitEvent(std::atomic<uint32_t>* Event, int TimeoutMs)
+	{
+		if (Event->exchange(0) == 1) return true;
+		if (TimeoutMs <= 0) return false;
+
+		const uint64_t Deadline = NowNs() + (uint64_t)TimeoutMs * 1000000ull;
+		for (;;)
+		{
+			const uint64_t Now = NowNs();
+			if (Now >= Deadline) return false;
+			const uint64_t Remaining = Deadline - Now;
+#ifdef __linux__
+			timespec ts = { (time_t)(Remaining / 1000000000ull), (long)(Remaining % 1000000000ull) };
+			syscall(SYS_futex, (uint32_t*)Event, FUTEX_WAIT, 0, &ts, NULL, 0);
+#else
+			timespec ts = { 0, (long)(Remaining < 1000000ull ? Remaining : 1000000ull) };
+			nanosleep(&ts, NULL);
+#endif
+			if (Event->exchange(0) == 1) return true;
+		}
+	}
+
+	int32_t m_CapNum;
+	SharedControl* m_pControl;
+	SharedMemHeader* m_pSharedBuf;
+	size_t m_MappingSize;
+	uint32_t m_AcceptedFormats;
+	bool m_IsReceiver;
+};
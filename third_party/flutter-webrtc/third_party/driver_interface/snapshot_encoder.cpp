@@ -0,0 +1,658 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <vector>
+
+#include "image_kernels.h"
+#include "snapshot_encoder.h"
+
+namespace {
+
+// CRC-32 tables for slicing-by-8, table 0 is the classic byte table.
+struct CrcTables {
+    uint32_t t[8][256];
+
+    CrcTables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int k = 1; k < 8; k++) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+            }
+        }
+    }
+};
+
+const CrcTables& GetCrcTables() {
+    static const CrcTables tables;
+    return tables;
+}
+
+inline uint32_t Load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+// Index of the lowest set bit of a nonzero |v|.
+inline int LowestSetBit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return int(index);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Length of the common prefix of |a| and |b|, at most |limit| bytes.
+// Compares eight bytes at a time, little endian targets only.
+inline size_t MatchLength(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t length = 0;
+    while (length + 8 <= limit) {
+        const uint64_t diff = Load64(a + length) ^ Load64(b + length);
+        if (diff != 0) {
+            return length + (LowestSetBit(diff) >> 3);
+        }
+        length += 8;
+    }
+    while (length < limit && a[length] == b[length]) {
+        length++;
+    }
+    return length;
+}
+
+inline uint32_t Load32LE(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+void PutBE32(std::vector<uint8_t>* out, uint32_t v) {
+    const uint8_t bytes[4] = {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)};
+    out->insert(out->end(), bytes, bytes + 4);
+}
+
+// ---- Deflate ----------------------------------------------------------------
+
+constexpr int kWindowSize = 32768;
+constexpr int kMinMatch = 4;
+constexpr int kMaxMatch = 258;
+constexpr int kHashBits = 15;
+// Symbols collected before a block is written with its own Huffman codes.
+constexpr size_t kBlockSymbols = 1 << 16;
+
+constexpr int kNumLitLen = 286;
+constexpr int kNumDist = 30;
+constexpr int kNumCodeLen = 19;
+constexpr int kMaxBits = 15;
+constexpr int kMaxCodeLenBits = 7;
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t kCodeLenOrder[kNumCodeLen] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+struct SymbolTables {
+    uint8_t length_code[kMaxMatch + 1];  // Match length to code - 257.
+    uint8_t dist_code[512];              // See DistCode.
+
+    SymbolTables() {
+        for (int code = 0; code < 29; code++) {
+            const int end = std::min(kLengthBase[code] + (1 << kLengthExtra[code]), kMaxMatch + 1);
+            for (int len = kLengthBase[code]; len < end; len++) {
+                length_code[len] = uint8_t(code);
+            }
+        }
+        length_code[kMaxMatch] = 28;
+        for (int code = 0; code < 30; code++) {
+            for (int d = kDistBase[code]; d < kDistBase[code] + (1 << kDistExtra[code]); d++) {
+                const int index = d <= 256 ? d - 1 : 256 + ((d - 1) >> 7);
+                if (index < 512) {
+                    dist_code[index] = uint8_t(code);
+                }
+            }
+        }
+    }
+
+    int DistCode(int dist) const {
+        return dist <= 256 ? dist_code[dist - 1] : dist_code[256 + ((dist - 1) >> 7)];
+    }
+};
+
+const SymbolTables& GetSymbolTables() {
+    static const SymbolTables tables;
+    return tables;
+}
+
+// Appends bits least significant first, 32 bits at a time. Reserve()
+// must make room for whatever is Put next.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>* out) : out_(out), size_(out->size()) {}
+
+    void Reserve(size_t bytes) {
+        if (out_->size() < size_ + bytes + 8) {
+            out_->resize(std::max(out_->size() * 2, size_ + bytes + 8));
+        }
+    }
+
+    // |bits| holds |count| <= 32 bits.
+    void Put(uint32_t bits, int count) {
+        acc_ |= uint64_t(bits) << filled_;
+        filled_ += count;
+        if (filled_ >= 32) {
+            const uint32_t word = uint32_t(acc_);
+            const uint8_t bytes[4] = {uint8_t(word), uint8_t(word >> 8), uint8_t(word >> 16), uint8_t(word >> 24)};
+            memcpy(out_->data() + size_, bytes, 4);
+            size_ += 4;
+            acc_ >>= 32;
+            filled_ -= 32;
+        }
+    }
+
+    // Pads to a byte boundary and trims |out| to what was written.
+    void Finish() {
+        while (filled_ > 0) {
+            (*out_)[size_++] = uint8_t(acc_);
+            acc_ >>= 8;
+            filled_ -= 8;
+        }
+        acc_ = 0;
+        filled_ = 0;
+        out_->resize(size_);
+    }
+
+private:
+    std::vector<uint8_t>* out_;
+    size_t size_;
+    uint64_t acc_ = 0;
+    int filled_ = 0;
+};
+
+// Computes code lengths no longer than |max_bits| for |freq|, zero for
+// unused symbols, following the length limiting of miniz.
+void BuildLengths(const uint32_t* freq, int count, int max_bits, uint8_t* lengths) {
+    memset(lengths, 0, count);
+    std::vector<int> used;
+    for (int i = 0; i < count; i++) {
+        if (freq[i]) {
+            used.push_back(i);
+        }
+    }
+    if (used.empty()) {
+        return;
+    }
+    if (used.size() == 1) {
+        // Decoders want complete codes, pair it with an unused symbol.
+        lengths[used[0]] = 1;
+        lengths[used[0] == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    // Plain Huffman tree, the depth of each leaf is its length.
+    struct Node { uint32_t freq; int left, right; };
+    std::vector<Node> nodes;
+    nodes.reserve(used.size() * 2);
+    using Entry = std::pair<uint32_t, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (int symbol : used) {
+        nodes.push_back({freq[symbol], -1, -1});
+        heap.push({freq[symbol], int(nodes.size()) - 1});
+    }
+    while (heap.size() > 1) {
+        const Entry a = heap.top(); heap.pop();
+        const Entry b = heap.top(); heap.pop();
+        nodes.push_back({a.first + b.first, a.second, b.second});
+        heap.push({a.first + b.first, int(nodes.size()) - 1});
+    }
+    std::vector<int> depth(nodes.size(), 0);
+    int num_codes[33] = {};
+    for (int i = int(nodes.size()) - 1; i >= 0; i--) {
+        if (nodes[i].left >= 0) {
+            depth[nodes[i].left] = depth[nodes[i].right] = depth[i] + 1;
+        } else {
+            num_codes[std::min(depth[i], 32)]++;
+        }
+    }
+
+    for (int i = max_bits + 1; i <= 32; i++) {
+        num_codes[max_bits] += num_codes[i];
+    }
+    uint32_t total = 0;
+    for (int i = max_bits; i > 0; i--) {
+        total += uint32_t(num_codes[i]) << (max_bits - i);
+    }
+    while (total != (1u << max_bits)) {
+        num_codes[max_bits]--;
+        for (int i = max_bits - 1; i > 0; i--) {
+            if (num_codes[i]) {
+                num_codes[i]--;
+                num_codes[i + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    // Least frequent symbols get the longest codes.
+    std::sort(used.begin(), used.end(), [freq](int a, int b) {
+        return freq[a] != freq[b] ? freq[a] < freq[b] : a < b;
+    });
+    size_t next = 0;
+    for (int len = max_bits; len > 0; len--) {
+        for (int n = num_codes[len]; n > 0; n--) {
+            lengths[used[next++]] = uint8_t(len);
+        }
+    }
+}
+
+// Canonical codes for |lengths|, bit reversed for the LSB-first writer.
+void BuildCodes(const uint8_t* lengths, int count, uint16_t* codes) {
+    int bl_count[kMaxBits + 1] = {};
+    for (int i = 0; i < count; i++) {
+        bl_count[lengths[i]]++;
+    }
+    bl_count[0] = 0;
+    int next_code[kMaxBits + 2] = {};
+    int code = 0;
+    for (int bits = 1; bits <= kMaxBits; bits++) {
+        code = (code + bl_count[bits - 1]) << 1;
+        next_code[bits] = code;
+    }
+    for (int i = 0; i < count; i++) {
+        const int len = lengths[i];
+        if (len == 0) {
+            codes[i] = 0;
+            continue;
+        }
+        uint32_t c = uint32_t(next_code[len]++);
+        uint32_t reversed = 0;
+        for (int b = 0; b < len; b++) {
+            reversed = (reversed << 1) | (c & 1);
+            c >>= 1;
+        }
+        codes[i] = uint16_t(reversed);
+    }
+}
+
+// A literal (< 256) or a match, packed as 1 << 31 | distance code << 24 |
+// length << 15 | (distance - 1), so the codes are looked up once.
+using Symbol = uint32_t;
+constexpr Symbol kMatchFlag = 1u << 31;
+
+// Symbols of one block with their frequencies, counted as they're added.
+struct Block {
+    std::vector<Symbol> symbols;
+    uint32_t lit_freq[kNumLitLen] = {};
+    uint32_t dist_freq[kNumDist] = {};
+
+    void AddLiteral(uint8_t literal) {
+        symbols.push_back(literal);
+        lit_freq[literal]++;
+    }
+
+    void AddMatch(const SymbolTables& tables, int length, int dist) {
+        const int dc = tables.DistCode(dist);
+        symbols.push_back(kMatchFlag | uint32_t(dc) << 24 | uint32_t(length) << 15 | uint32_t(dist - 1));
+        lit_freq[257 + tables.length_code[length]]++;
+        dist_freq[dc]++;
+    }
+
+    void Clear() {
+        symbols.clear();
+        std::fill(lit_freq, lit_freq + kNumLitLen, 0);
+        std::fill(dist_freq, dist_freq + kNumDist, 0);
+    }
+};
+
+void WriteBlock(Block* block, bool last, BitWriter* writer) {
+    const SymbolTables& tables = GetSymbolTables();
+    const std::vector<Symbol>& symbols = block->symbols;
+    uint32_t* lit_freq = block->lit_freq;
+    uint32_t* dist_freq = block->dist_freq;
+
+    lit_freq[256] = 1;  // End of block.
+    if (std::all_of(dist_freq, dist_freq + kNumDist, [](uint32_t f) { return f == 0; })) {
+        dist_freq[0] = 1;  // Some decoders reject an empty distance code.
+    }
+
+    uint8_t lit_len[kNumLitLen];
+    uint8_t dist_len[kNumDist];
+    BuildLengths(lit_freq, kNumLitLen, kMaxBits, lit_len);
+    BuildLengths(dist_freq, kNumDist, kMaxBits, dist_len);
+    uint16_t lit_code[kNumLitLen];
+    uint16_t dist_code[kNumDist];
+    BuildCodes(lit_len, kNumLitLen, lit_code);
+    BuildCodes(dist_len, kNumDist, dist_code);
+
+    int hlit = kNumLitLen;
+    while (hlit > 257 && lit_len[hlit - 1] == 0) hlit--;
+    int hdist = kNumDist;
+    while (hdist > 1 && dist_len[hdist - 1] == 0) hdist--;
+
+    // Run-length code the concatenated code lengths with symbols 16 to 18.
+    uint8_t all[kNumLitLen + kNumDist];
+    memcpy(all, lit_len, hlit);
+    memcpy(all + hlit, dist_len, hdist);
+    const int total = hlit + hdist;
+    std::vector<std::pair<uint8_t, uint8_t>> runs;  // Symbol and extra bits value.
+    uint32_t cl_freq[kNumCodeLen] = {};
+    for (int i = 0; i < total;) {
+        const uint8_t len = all[i];
+        int run = 1;
+        while (i + run < total && all[i + run] == len) run++;
+        if (len == 0 && run >= 3) {
+            const int n = std::min(run, 138);
+            if (n >= 11) runs.push_back({18, uint8_t(n - 11)});
+            else runs.push_back({17, uint8_t(n - 3)});
+            cl_freq[runs.back().first]++;
+            i += n;
+        } else if (len != 0 && run >= 4) {
+            runs.push_back({len, 0});
+            cl_freq[len]++;
+            const int n = std::min(run - 1, 6);
+            runs.push_back({16, uint8_t(n - 3)});
+            cl_freq[16]++;
+            i += 1 + n;
+        } else {
+            runs.push_back({len, 0});
+            cl_freq[len]++;
+            i++;
+        }
+    }
+    uint8_t cl_len[kNumCodeLen];
+    uint16_t cl_code[kNumCodeLen];
+    BuildLengths(cl_freq, kNumCodeLen, kMaxCodeLenBits, cl_len);
+    BuildCodes(cl_len, kNumCodeLen, cl_code);
+    int hclen = kNumCodeLen;
+    while (hclen > 4 && cl_len[kCodeLenOrder[hclen - 1]] == 0) hclen--;
+
+    // Header plus at most 48 bits per symbol.
+    writer->Reserve(1024 + symbols.size() * 6);
+
+    writer->Put(last ? 1 : 0, 1);
+    writer->Put(2, 2);  // Dynamic Huffman codes.
+    writer->Put(hlit - 257, 5);
+    writer->Put(hdist - 1, 5);
+    writer->Put(hclen - 4, 4);
+    for (int i = 0; i < hclen; i++) {
+        writer->Put(cl_len[kCodeLenOrder[i]], 3);
+    }
+    for (const auto& run : runs) {
+        writer->Put(cl_code[run.first], cl_len[run.first]);
+        if (run.first == 16) writer->Put(run.second, 2);
+        else if (run.first == 17) writer->Put(run.second, 3);
+        else if (run.first == 18) writer->Put(run.second, 7);
+    }
+
+    // Length codes with their extra bits, so a match is two Puts.
+    uint32_t length_bits[kMaxMatch + 1];
+    uint8_t length_count[kMaxMatch + 1];
+    for (int length = kMinMatch; length <= kMaxMatch; length++) {
+        const int lc = tables.length_code[length];
+        length_bits[length] = lit_code[257 + lc] | uint32_t(length - kLengthBase[lc]) << lit_len[257 + lc];
+        length_count[length] = uint8_t(lit_len[257 + lc] + kLengthExtra[lc]);
+    }
+
+    for (Symbol s : symbols) {
+        if (s & kMatchFlag) {
+            const int length = (s >> 15) & 0x1ff;
+            const int dist = int(s & 0x7fff) + 1;
+            const int dc = (s >> 24) & 0x1f;
+            writer->Put(length_bits[length], length_count[length]);
+            writer->Put(dist_code[dc] | uint32_t(dist - kDistBase[dc]) << dist_len[dc], dist_len[dc] + kDistExtra[dc]);
+        } else {
+            writer->Put(lit_code[s], lit_len[s]);
+        }
+    }
+    writer->Put(lit_code[256], lit_len[256]);
+}
+
+// Raw deflate stream of |data|: greedy LZ77 with one hash probe per position.
+void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>* out) {
+    BitWriter writer(out);
+    std::vector<int32_t> head(size_t(1) << kHashBits, -kWindowSize - 1);
+    const SymbolTables& tables = GetSymbolTables();
+    Block block;
+    block.symbols.reserve(kBlockSymbols);
+
+    size_t i = 0;
+    while (i < size) {
+        if (i + kMinMatch <= size) {
+            const uint32_t word = Load32(data + i);
+            const uint32_t hash = (word * 2654435761u) >> (32 - kHashBits);
+            const int32_t candidate = head[hash];
+            head[hash] = int32_t(i);
+            if (int32_t(i) - candidate <= kWindowSize && Load32(data + candidate) == word) {
+                const size_t limit = std::min<size_t>(kMaxMatch, size - i);
+                const size_t length = kMinMatch + MatchLength(data + candidate + kMinMatch, data + i + kMinMatch,
+                                                              limit - kMinMatch);
+                block.AddMatch(tables, int(length), int(i - candidate));
+                // Only the match end is hashed, enough to chain runs cheaply.
+                i += length;
+                if (i + kMinMatch <= size) {
+                    head[(Load32(data + i - 1) * 2654435761u) >> (32 - kHashBits)] = int32_t(i - 1);
+                }
+            } else {
+                block.AddLiteral(data[i]);
+                i++;
+            }
+        } else {
+            block.AddLiteral(data[i]);
+            i++;
+        }
+        if (block.symbols.size() == kBlockSymbols) {
+            WriteBlock(&block, i == size, &writer);
+            block.Clear();
+        }
+    }
+    if (!block.symbols.empty() || size == 0) {
+        WriteBlock(&block, true, &writer);
+    }
+    writer.Finish();
+}
+
+// The Paeth predictor of a sample, |a| left, |b| above, |c| above left.
+// Written with selects on 16-bit values only, so the row loop vectorizes
+// eight samples to a 128-bit register.
+inline uint8_t Paeth(int16_t a, int16_t b, int16_t c) {
+    const int16_t pa = int16_t(std::abs(b - c));
+    const int16_t pb = int16_t(std::abs(a - c));
+    const int16_t pc = int16_t(std::abs(a + b - 2 * c));
+    const int16_t bc = pb <= pc ? b : c;
+    return uint8_t(pa <= pb && pa <= pc ? a : bc);
+}
+
+void AppendChunk(std::vector<uint8_t>* png, const char* type, const uint8_t* data, size_t size) {
+    PutBE32(png, uint32_t(size));
+    const size_t start = png->size();
+    png->insert(png->end(), type, type + 4);
+    png->insert(png->end(), data, data + size);
+    PutBE32(png, Crc32(0, png->data() + start, size + 4));
+}
+
+}  // namespace
+
+SnapshotFormat SnapshotFormatForPath(const char* path) {
+    const char* dot = strrchr(path, '.');
+    if (dot == nullptr) {
+        return SnapshotFormat::kPng;
+    }
+    char ext[8] = {};
+    for (size_t i = 0; i + 1 < sizeof(ext) && dot[i + 1]; i++) {
+        ext[i] = char(tolower(static_cast<unsigned char>(dot[i + 1])));
+    }
+    if (!strcmp(ext, "yuv") || !strcmp(ext, "i420")) {
+        return SnapshotFormat::kI420;
+    }
+    return SnapshotFormat::kPng;
+}
+
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    const CrcTables& tables = GetCrcTables();
+    const auto& t = tables.t;
+    crc = ~crc;
+    while (size >= 8) {
+        const uint32_t lo = Load32LE(data) ^ crc;
+        const uint32_t hi = Load32LE(data + 4);
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size) {
+    // Largest n with 255 n (n + 1) / 2 + (n + 1) (65521 - 1) < 2^32, the
+    // sums are only reduced once per n bytes.
+    constexpr size_t kNMax = 5552;
+    constexpr uint32_t kBase = 65521;
+    uint32_t a = adler & 0xffff;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        size_t n = std::min(size, kNMax);
+        size -= n;
+        while (n >= 8) {
+            a += data[0]; b += a;
+            a += data[1]; b += a;
+            a += data[2]; b += a;
+            a += data[3]; b += a;
+            a += data[4]; b += a;
+            a += data[5]; b += a;
+            a += data[6]; b += a;
+            a += data[7]; b += a;
+            data += 8;
+            n -= 8;
+        }
+        while (n--) {
+            a += *data++;
+            b += a;
+        }
+        a %= kBase;
+        b %= kBase;
+    }
+    return (b << 16) | a;
+}
+
+int EncodePng(const uint8_t* rgba, int stride, int width, int height,
+              bool alpha, std::vector<uint8_t>* png) {
+    if (rgba == nullptr || png == nullptr || width <= 0 || height <= 0 || stride < width * 4) {
+        return -1;
+    }
+
+    // Paeth filtered scanlines, each prefixed by its filter type. The row
+    // above the first one is all zeros, which makes Paeth act as Sub there.
+    const int bpp = alpha ? 4 : 3;
+    const size_t row_bytes = size_t(width) * bpp;
+    std::vector<uint8_t> filtered((row_bytes + 1) * height);
+    std::vector<uint8_t> rows(row_bytes * 2, 0);
+    for (int y = 0; y < height; y++) {
+        // Distinct buffers, which lets the compiler vectorize the loops.
+        const uint8_t* __restrict prior = rows.data() + row_bytes * (y & 1);
+        uint8_t* __restrict row = rows.data() + row_bytes * ((y + 1) & 1);
+        uint8_t* __restrict dst = &filtered[(row_bytes + 1) * y];
+        const uint8_t* __restrict src = rgba + size_t(y) * stride;
+        if (alpha) {
+            memcpy(row, src, row_bytes);
+        } else {
+            for (int x = 0; x < width; x++) {
+                row[x * 3] = src[x * 4];
+                row[x * 3 + 1] = src[x * 4 + 1];
+                row[x * 3 + 2] = src[x * 4 + 2];
+            }
+        }
+        dst[0] = 4;  // Paeth.
+        dst++;
+        for (size_t x = 0; x < size_t(bpp); x++) {
+            dst[x] = uint8_t(row[x] - Paeth(0, prior[x], 0));
+        }
+        for (size_t x = bpp; x < row_bytes; x++) {
+            dst[x] = uint8_t(row[x] - Paeth(row[x - bpp], prior[x], prior[x - bpp]));
+        }
+    }
+
+    std::vector<uint8_t> idat;
+    idat.reserve(filtered.size() / 2);
+    idat.push_back(0x78);  // zlib header: deflate, 32K window,
+    idat.push_back(0x01);  // fastest compression level.
+    Deflate(filtered.data(), filtered.size(), &idat);
+    PutBE32(&idat, Adler32(1, filtered.data(), filtered.size()));
+
+    uint8_t ihdr[13];
+    const uint32_t size[2] = {uint32_t(width), uint32_t(height)};
+    for (int i = 0; i < 8; i++) {
+        ihdr[i] = uint8_t(size[i / 4] >> (24 - 8 * (i % 4)));  // Big endian.
+    }
+    ihdr[8] = 8;                // Bit depth.
+    ihdr[9] = alpha ? 6 : 2;    // RGBA or RGB.
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;  // Deflate, adaptive filters, no interlace.
+
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    png->clear();
+    png->reserve(idat.size() + 64);
+    png->insert(png->end(), kSignature, kSignature + 8);
+    AppendChunk(png, "IHDR", ihdr, sizeof(ihdr));
+    AppendChunk(png, "IDAT", idat.data(), idat.size());
+    AppendChunk(png, "IEND", nullptr, 0);
+    return 0;
+}
+
+int PackI420(const uint8_t* src_y, int stride_y,
+             const uint8_t* src_u, int stride_u,
+             const uint8_t* src_v, int stride_v,
+             int width, int height, std::vector<uint8_t>* i420) {
+    if (src_y == nullptr || src_u == nullptr || src_v == nullptr || i420 == nullptr || width <= 0 || height <= 0) {
+        return -1;
+    }
+    const int chroma_width = (width + 1) / 2;
+    const int chroma_height = (height + 1) / 2;
+    const size_t y_size = size_t(width) * height;
+    const size_t chroma_size = size_t(chroma_width) * chroma_height;
+    i420->resize(y_size + 2 * chroma_size);
+    uint8_t* dst = i420->data();
+    if (CopyPlane(src_y, stride_y, dst, width, width, height) != 0 ||
+        CopyPlane(src_u, stride_u, dst + y_size, chroma_width, chroma_width, chroma_height) != 0 ||
+        CopyPlane(src_v, stride_v, dst + y_size + chroma_size, chroma_width, chroma_width, chroma_height) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int WriteSnapshotFile(const char* path, const std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return -1;
+    }
+    // Unbuffered, the whole file goes out in one write.
+    setvbuf(file, nullptr, _IONBF, 0);
+    const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (fclose(file) == 0 && written) ? 0 : -1;
+}
@@ -0,0 +1,72 @@
+#ifndef SNAPSHOT_ENCODER_H
+#define SNAPSHOT_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief File formats a snapshot can be written in.
+ */
+enum class SnapshotFormat {
+    kPng,   // Deflate compressed PNG, RGB or RGBA.
+    kI420,  // Raw I420 planes (Y, then U, then V), no header.
+};
+
+/**
+ * @brief Pick the snapshot format from a file name, ".yuv" and ".i420"
+ * select kI420, anything else kPng.
+ */
+SnapshotFormat SnapshotFormatForPath(const char* path);
+
+/**
+ * @brief Update a CRC-32 (as used by PNG and zlib) with more data.
+ *
+ * Slicing-by-8 over precomputed tables, start with crc = 0.
+ */
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
+
+/**
+ * @brief Update an Adler-32 checksum with more data, start with adler = 1.
+ */
+uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size);
+
+/**
+ * @brief Encode an image of 32-bit pixels laid out R, G, B, A in memory
+ * as PNG.
+ *
+ * Rows are Paeth filtered and compressed with a single pass LZ77 matcher
+ * and per-block dynamic Huffman codes, about as small as zlib's fastest
+ * level in a third of its time.
+ *
+ * @param[in] rgba Source image.
+ * @param[in] stride Bytes between source rows.
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @param[in] alpha Keep the alpha channel, otherwise it's dropped and an
+ *            RGB PNG is written.
+ * @param[out] png Receives the PNG file.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int EncodePng(const uint8_t* rgba, int stride, int width, int height,
+              bool alpha, std::vector<uint8_t>* png);
+
+/**
+ * @brief Pack an I420 image into tightly strided Y, U and V planes.
+ *
+ * @return 0: Success, -1: Failure (invalid arguments).
+ */
+int PackI420(const uint8_t* src_y, int stride_y,
+             const uint8_t* src_u, int stride_u,
+             const uint8_t* src_v, int stride_v,
+             int width, int height, std::vector<uint8_t>* i420);
+
+/**
+ * @brief Write a buffer to a file with a single write.
+ *
+ * @return 0: Success, -1: Failure (the file couldn't be written).
+ */
+int WriteSnapshotFile(const char* path, const std::vector<uint8_t>& data);
+
+#endif // SNAPSHOT_ENCODER_H
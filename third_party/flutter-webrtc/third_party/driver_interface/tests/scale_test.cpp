@@ -0,0 +1,219 @@
+// Checks ScalePlane and the I420Scale* functions bit-exact against a
+// straightforward scalar reference of the box and bilinear filters.
+//
+// The fused I420ScaleToABGR and I420ScaleToNV12 must match scaling each
+// plane on its own followed by the unscaled conversion. Everything runs
+// once with each kernel set the CPU supports.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "image_kernels.h"
+
+namespace {
+
+int failures = 0;
+
+struct Size {
+    int width, height;
+};
+
+void Check(bool condition, const char* what, Size src, Size dst) {
+    if (!condition) {
+        fprintf(stderr, "FAILED (%s): %s (%dx%d -> %dx%d)\n", ImageKernelName(), what, src.width, src.height,
+                dst.width, dst.height);
+        failures++;
+    }
+}
+
+struct Plane {
+    Plane(Size size, int padding, uint32_t seed) : size(size), stride(size.width + padding) {
+        data.resize(size_t(stride) * size.height);
+        for (uint8_t& sample : data) {
+            seed = seed * 1103515245u + 12345u;
+            sample = uint8_t(seed >> 16);
+        }
+    }
+    uint8_t at(int x, int y) const { return data[size_t(y) * stride + x]; }
+
+    Size size;
+    int stride;
+    std::vector<uint8_t> data;
+};
+
+ScaleFilter Resolve(ScaleFilter filter, Size src, Size dst) {
+    if (filter != ScaleFilter::kAuto) {
+        return filter;
+    }
+    return src.width >= 2 * dst.width && src.height >= 2 * dst.height ? ScaleFilter::kBox : ScaleFilter::kBilinear;
+}
+
+// Rounded mean of the source pixels covered by each destination pixel,
+// at most 256 source rows per destination row.
+uint8_t BoxPixel(const Plane& src, Size dst, int x, int y) {
+    const int x0 = int(int64_t(x) * src.size.width / dst.width);
+    const int x1 = std::max(x0 + 1, int(int64_t(x + 1) * src.size.width / dst.width));
+    const int y0 = int(int64_t(y) * src.size.height / dst.height);
+    const int y1 = std::min(y0 + 256, std::max(y0 + 1, int(int64_t(y + 1) * src.size.height / dst.height)));
+    uint64_t sum = 0;
+    for (int sy = y0; sy < y1; ++sy) {
+        for (int sx = x0; sx < x1; ++sx) {
+            sum += src.at(sx, sy);
+        }
+    }
+    const uint64_t count = uint64_t(x1 - x0) * (y1 - y0);
+    return uint8_t((sum + count / 2) / count);
+}
+
+// Center of destination pixel i in source coordinates, 16.16 fixed point.
+int64_t Position(int i, int src_size, int dst_size) {
+    const int64_t pos = ((2 * int64_t(i) + 1) * src_size << 16) / (2 * dst_size) - 32768;
+    return std::min<int64_t>(std::max<int64_t>(pos, 0), int64_t(src_size - 1) << 16);
+}
+
+int Blend(int a, int b, int fraction) {
+    return (a * (256 - fraction) + b * fraction + 128) >> 8;
+}
+
+// Vertical blend of the two nearest rows, then horizontal blend of the two
+// nearest columns, each rounded to 8 bits.
+uint8_t BilinearPixel(const Plane& src, Size dst, int x, int y) {
+    const int64_t py = Position(y, src.size.height, dst.height);
+    const int y0 = int(py >> 16), y1 = std::min(y0 + 1, src.size.height - 1);
+    const int fy = int((py >> 8) & 0xFF);
+    const int64_t px = Position(x, src.size.width, dst.width);
+    const int x0 = int(px >> 16), x1 = std::min(x0 + 1, src.size.width - 1);
+    const int fx = int((px >> 8) & 0xFF);
+    const int left = Blend(src.at(x0, y0), src.at(x0, y1), fy);
+    const int right = Blend(src.at(x1, y0), src.at(x1, y1), fy);
+    return uint8_t(Blend(left, right, fx));
+}
+
+std::vector<uint8_t> Reference(const Plane& src, Size dst, ScaleFilter filter) {
+    std::vector<uint8_t> out(size_t(dst.width) * dst.height);
+    filter = Resolve(filter, src.size, dst);
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            uint8_t& pixel = out[size_t(y) * dst.width + x];
+            if (src.size.width == dst.width && src.size.height == dst.height) {
+                pixel = src.at(x, y);
+            } else if (filter == ScaleFilter::kBox) {
+                pixel = BoxPixel(src, dst, x, y);
+            } else {
+                pixel = BilinearPixel(src, dst, x, y);
+            }
+        }
+    }
+    return out;
+}
+
+// Drops the stride padding of a destination image.
+std::vector<uint8_t> Unpad(const std::vector<uint8_t>& image, int row_bytes, int stride, int height) {
+    std::vector<uint8_t> out;
+    for (int y = 0; y < height; ++y) {
+        out.insert(out.end(), image.begin() + size_t(y) * stride, image.begin() + size_t(y) * stride + row_bytes);
+    }
+    return out;
+}
+
+void CheckScale(Size src_size, Size dst_size, ScaleFilter filter) {
+    const Size src_chroma = {(src_size.width + 1) / 2, (src_size.height + 1) / 2};
+    const Size dst_chroma = {(dst_size.width + 1) / 2, (dst_size.height + 1) / 2};
+    const Plane y(src_size, 3, 1), u(src_chroma, 5, 2), v(src_chroma, 1, 3);
+
+    const std::vector<uint8_t> expected_y = Reference(y, dst_size, filter);
+    const std::vector<uint8_t> expected_u = Reference(u, dst_chroma, filter);
+    const std::vector<uint8_t> expected_v = Reference(v, dst_chroma, filter);
+
+    const int stride_y = dst_size.width + 7, stride_uv = dst_chroma.width + 7;
+    std::vector<uint8_t> out_y(size_t(stride_y) * dst_size.height);
+    Check(ScalePlane(y.data.data(), y.stride, src_size.width, src_size.height,
+                     out_y.data(), stride_y, dst_size.width, dst_size.height, filter) == 0,
+          "ScalePlane returns 0", src_size, dst_size);
+    Check(Unpad(out_y, dst_size.width, stride_y, dst_size.height) == expected_y, "ScalePlane", src_size, dst_size);
+
+    std::vector<uint8_t> out_u(size_t(stride_uv) * dst_chroma.height), out_v(out_u.size());
+    std::fill(out_y.begin(), out_y.end(), 0);
+    Check(I420Scale(y.data.data(), y.stride, u.data.data(), u.stride, v.data.data(), v.stride,
+                    src_size.width, src_size.height,
+                    out_y.data(), stride_y, out_u.data(), stride_uv, out_v.data(), stride_uv,
+                    dst_size.width, dst_size.height, filter) == 0,
+          "I420Scale returns 0", src_size, dst_size);
+    Check(Unpad(out_y, dst_size.width, stride_y, dst_size.height) == expected_y &&
+              Unpad(out_u, dst_chroma.width, stride_uv, dst_chroma.height) == expected_u &&
+              Unpad(out_v, dst_chroma.width, stride_uv, dst_chroma.height) == expected_v,
+          "I420Scale", src_size, dst_size);
+
+    std::vector<uint8_t> out_uv(size_t(stride_uv) * 2 * dst_chroma.height);
+    std::fill(out_y.begin(), out_y.end(), 0);
+    Check(I420ScaleToNV12(y.data.data(), y.stride, u.data.data(), u.stride, v.data.data(), v.stride,
+                          src_size.width, src_size.height,
+                          out_y.data(), stride_y, out_uv.data(), stride_uv * 2,
+                          dst_size.width, dst_size.height, filter) == 0,
+          "I420ScaleToNV12 returns 0", src_size, dst_size);
+    std::vector<uint8_t> expected_uv;
+    for (size_t i = 0; i < expected_u.size(); ++i) {
+        expected_uv.push_back(expected_u[i]);
+        expected_uv.push_back(expected_v[i]);
+    }
+    Check(Unpad(out_y, dst_size.width, stride_y, dst_size.height) == expected_y &&
+              Unpad(out_uv, dst_chroma.width * 2, stride_uv * 2, dst_chroma.height) == expected_uv,
+          "I420ScaleToNV12", src_size, dst_size);
+
+    // The fused path against scaling first and converting the result.
+    const int abgr_stride = dst_size.width * 4;
+    std::vector<uint8_t> expected_abgr(size_t(abgr_stride) * dst_size.height);
+    std::vector<uint8_t> abgr(expected_abgr.size());
+    I420ToABGR(expected_y.data(), dst_size.width, expected_u.data(), dst_chroma.width,
+               expected_v.data(), dst_chroma.width, expected_abgr.data(), abgr_stride,
+               dst_size.width, dst_size.height, true);
+    Check(I420ScaleToABGR(y.data.data(), y.stride, u.data.data(), u.stride, v.data.data(), v.stride,
+                          src_size.width, src_size.height, abgr.data(), abgr_stride,
+                          dst_size.width, dst_size.height, true, filter) == 0 &&
+              abgr == expected_abgr,
+          "I420ScaleToABGR", src_size, dst_size);
+}
+
+void CheckKernels() {
+    const struct {
+        Size src, dst;
+    } cases[] = {
+        {{1920, 1080}, {1280, 720}},
+        {{1920, 1080}, {960, 540}},   // exact 2x box
+        {{1920, 1080}, {640, 360}},
+        {{1280, 720}, {854, 480}},
+        {{64, 64}, {63, 63}},
+        {{37, 23}, {13, 7}},
+        {{7, 5}, {3, 2}},
+        {{300, 2}, {17, 1}},
+        {{2, 600}, {1, 1}},           // more than 256 rows per box
+        {{10, 10}, {33, 21}},         // upscale
+        {{33, 17}, {33, 17}},         // same size copies
+    };
+    const ScaleFilter filters[] = {ScaleFilter::kAuto, ScaleFilter::kBilinear, ScaleFilter::kBox};
+    for (const auto& c : cases) {
+        for (ScaleFilter filter : filters) {
+            CheckScale(c.src, c.dst, filter);
+        }
+    }
+
+    uint8_t sample = 0;
+    Check(ScalePlane(nullptr, 1, 1, 1, &sample, 1, 1, 1, ScaleFilter::kBox) == -1, "null src", {1, 1}, {1, 1});
+    Check(ScalePlane(&sample, 1, 1, 1, &sample, 1, 0, 1, ScaleFilter::kBox) == -1, "zero width", {1, 1}, {0, 1});
+}
+
+}  // namespace
+
+int main() {
+    for (const char* kernels : {"avx2", "sse2", "neon", "c"}) {
+        if (SetImageKernels(kernels) != 0) {
+            continue;  // not supported by this CPU.
+        }
+        const int before = failures;
+        CheckKernels();
+        printf("scale_test (%s): %s\n", kernels, failures > before ? "FAILED" : "passed");
+    }
+    return failures ? 1 : 0;
+}
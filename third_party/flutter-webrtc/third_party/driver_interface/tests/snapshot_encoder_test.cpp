@@ -0,0 +1,236 @@
+// Checks the hand-written PNG encoder against zlib.
+//
+// Crc32 and Adler32 are compared with published check values and with
+// zlib's crc32 and adler32 over lengths and offsets that cover the
+// slicing-by-8 and the deferred modulo paths. EncodePng output is parsed
+// back, its chunk CRCs verified, its IDAT inflated by zlib and unfiltered,
+// and the pixels compared with the source for odd sizes, padded strides,
+// flat (long matches) and noise (incompressible) images.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <zlib.h>
+
+#include "snapshot_encoder.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what, int width, int height) {
+    if (!condition) {
+        fprintf(stderr, "FAILED: %s (%dx%d)\n", what, width, height);
+        failures++;
+    }
+}
+
+std::vector<uint8_t> Random(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    for (uint8_t& sample : data) {
+        seed = seed * 1103515245u + 12345u;
+        sample = uint8_t(seed >> 16);
+    }
+    return data;
+}
+
+const uint8_t* Bytes(const char* text) {
+    return reinterpret_cast<const uint8_t*>(text);
+}
+
+void CheckChecksums() {
+    const char* digits = "123456789";
+    Check(Crc32(0, Bytes(digits), 9) == 0xCBF43926u, "crc32 check value", 9, 1);
+    Check(Crc32(0, nullptr, 0) == 0, "crc32 of nothing", 0, 1);
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    Check(Crc32(0, Bytes(fox), strlen(fox)) == 0x414FA339u, "crc32 fox", int(strlen(fox)), 1);
+    Check(Adler32(1, Bytes("Wikipedia"), 9) == 0x11E60398u, "adler32 Wikipedia", 9, 1);
+    Check(Adler32(1, Bytes(digits), 9) == 0x091E01DEu, "adler32 check value", 9, 1);
+    Check(Adler32(1, nullptr, 0) == 1, "adler32 of nothing", 0, 1);
+
+    // Misaligned starts and every tail length, in one call and split.
+    const std::vector<uint8_t> data = Random(4096, 7);
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t size = 0; size <= 80; size++) {
+            const uint8_t* p = data.data() + offset;
+            const uint32_t crc = uint32_t(crc32(0, p, uInt(size)));
+            Check(Crc32(0, p, size) == crc, "crc32 vs zlib", int(size), int(offset));
+            Check(Crc32(Crc32(0, p, size / 3), p + size / 3, size - size / 3) == crc, "crc32 split",
+                  int(size), int(offset));
+            const uint32_t adler = uint32_t(adler32(1, p, uInt(size)));
+            Check(Adler32(1, p, size) == adler, "adler32 vs zlib", int(size), int(offset));
+            Check(Adler32(Adler32(1, p, size / 3), p + size / 3, size - size / 3) == adler, "adler32 split",
+                  int(size), int(offset));
+        }
+    }
+
+    // All 0xff maximizes the sums between reductions, past several runs
+    // of the deferred modulo.
+    const std::vector<uint8_t> ones(100000, 0xff);
+    Check(Adler32(1, ones.data(), ones.size()) == uint32_t(adler32(1, ones.data(), uInt(ones.size()))),
+          "adler32 vs zlib, 0xff", int(ones.size()), 1);
+    const std::vector<uint8_t> noise = Random(1 << 20, 11);
+    Check(Crc32(0, noise.data(), noise.size()) == uint32_t(crc32(0, noise.data(), uInt(noise.size()))),
+          "crc32 vs zlib, 1 MB", 1 << 20, 1);
+}
+
+uint32_t ReadBE32(const uint8_t* p) {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+}
+
+uint8_t Paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = p > a ? p - a : a - p;
+    const int pb = p > b ? p - b : b - p;
+    const int pc = p > c ? p - c : c - p;
+    return uint8_t(pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+}
+
+// Decodes an 8-bit RGB or RGBA |png| into R, G, B, A pixels, false if
+// any part of it is malformed.
+bool DecodePng(const std::vector<uint8_t>& png, int* width, int* height, bool* alpha,
+               std::vector<uint8_t>* rgba) {
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (png.size() < 8 || memcmp(png.data(), kSignature, 8) != 0) {
+        return false;
+    }
+    std::vector<uint8_t> idat;
+    bool has_header = false, has_end = false;
+    for (size_t pos = 8; pos < png.size() && !has_end;) {
+        if (png.size() - pos < 12) {
+            return false;
+        }
+        const uint32_t length = ReadBE32(&png[pos]);
+        if (png.size() - pos - 12 < length) {
+            return false;
+        }
+        const uint8_t* type = &png[pos + 4];
+        const uint8_t* data = type + 4;
+        if (ReadBE32(data + length) != uint32_t(crc32(0, type, length + 4))) {
+            return false;
+        }
+        if (!memcmp(type, "IHDR", 4) && length == 13) {
+            *width = int(ReadBE32(data));
+            *height = int(ReadBE32(data + 4));
+            if (data[8] != 8 || (data[9] != 2 && data[9] != 6) || data[10] || data[11] || data[12]) {
+                return false;
+            }
+            *alpha = data[9] == 6;
+            has_header = true;
+        } else if (!memcmp(type, "IDAT", 4)) {
+            idat.insert(idat.end(), data, data + length);
+        } else if (!memcmp(type, "IEND", 4)) {
+            has_end = true;
+        }
+        pos += 12 + length;
+    }
+    if (!has_header || !has_end) {
+        return false;
+    }
+
+    // uncompress() checks the zlib header and the Adler-32 trailer too.
+    const int bpp = *alpha ? 4 : 3;
+    const size_t row_bytes = size_t(*width) * bpp;
+    std::vector<uint8_t> filtered((row_bytes + 1) * *height);
+    uLongf size = uLongf(filtered.size());
+    if (uncompress(filtered.data(), &size, idat.data(), uLong(idat.size())) != Z_OK || size != filtered.size()) {
+        return false;
+    }
+
+    std::vector<uint8_t> prior(row_bytes, 0), row(row_bytes);
+    rgba->assign(size_t(*width) * *height * 4, 255);
+    for (int y = 0; y < *height; y++) {
+        const uint8_t* line = &filtered[(row_bytes + 1) * y];
+        const uint8_t filter = line[0];
+        for (size_t x = 0; x < row_bytes; x++) {
+            const int a = x >= size_t(bpp) ? row[x - bpp] : 0;
+            const int b = prior[x];
+            const int c = x >= size_t(bpp) ? prior[x - bpp] : 0;
+            int predictor;
+            switch (filter) {
+            case 0: predictor = 0; break;
+            case 1: predictor = a; break;
+            case 2: predictor = b; break;
+            case 3: predictor = (a + b) / 2; break;
+            case 4: predictor = Paeth(a, b, c); break;
+            default: return false;
+            }
+            row[x] = uint8_t(line[1 + x] + predictor);
+        }
+        for (int x = 0; x < *width; x++) {
+            memcpy(&(*rgba)[(size_t(y) * *width + x) * 4], &row[size_t(x) * bpp], bpp);
+        }
+        prior.swap(row);
+    }
+    return true;
+}
+
+void CheckRoundTrip(const std::vector<uint8_t>& pixels, int width, int height, const char* what) {
+    // Padded rows, the padding must not leak into the image.
+    const int stride = width * 4 + 12;
+    std::vector<uint8_t> src(size_t(stride) * height, 0xA5);
+    for (int y = 0; y < height; y++) {
+        memcpy(&src[size_t(y) * stride], &pixels[size_t(y) * width * 4], size_t(width) * 4);
+    }
+
+    for (bool alpha : {true, false}) {
+        std::vector<uint8_t> png;
+        Check(EncodePng(src.data(), stride, width, height, alpha, &png) == 0, "encode returns 0", width, height);
+
+        int decoded_width = 0, decoded_height = 0;
+        bool decoded_alpha = !alpha;
+        std::vector<uint8_t> decoded;
+        const bool valid = DecodePng(png, &decoded_width, &decoded_height, &decoded_alpha, &decoded);
+        Check(valid, what, width, height);
+        if (!valid) {
+            continue;
+        }
+        Check(decoded_width == width && decoded_height == height && decoded_alpha == alpha, "header", width,
+              height);
+
+        std::vector<uint8_t> expected = pixels;
+        if (!alpha) {
+            for (size_t i = 3; i < expected.size(); i += 4) {
+                expected[i] = 255;
+            }
+        }
+        Check(decoded == expected, what, width, height);
+    }
+}
+
+}  // namespace
+
+int main() {
+    CheckChecksums();
+
+    const int sizes[][2] = {{1, 1}, {2, 1}, {1, 2}, {3, 3}, {37, 23}, {641, 7}};
+    for (const auto& size : sizes) {
+        const int width = size[0], height = size[1];
+        CheckRoundTrip(Random(size_t(width) * height * 4, uint32_t(width * 31 + height)), width, height, "noise");
+
+        std::vector<uint8_t> gradient(size_t(width) * height * 4);
+        for (size_t i = 0; i < gradient.size(); i++) {
+            gradient[i] = uint8_t((i / 4) % size_t(width) + (i / 4) / size_t(width) + (i & 3) * 60);
+        }
+        CheckRoundTrip(gradient, width, height, "gradient");
+    }
+
+    // Flat, nearly all maximum length matches.
+    CheckRoundTrip(std::vector<uint8_t>(size_t(300) * 200 * 4, 0x40), 300, 200, "flat");
+    // Incompressible and larger than a block of symbols, stored as
+    // literals over several dynamic Huffman blocks.
+    CheckRoundTrip(Random(size_t(512) * 512 * 4, 3), 512, 512, "noise");
+
+    uint8_t pixel[4] = {};
+    std::vector<uint8_t> png;
+    Check(EncodePng(nullptr, 4, 1, 1, true, &png) == -1, "null source", 1, 1);
+    Check(EncodePng(pixel, 4, 1, 1, true, nullptr) == -1, "null output", 1, 1);
+    Check(EncodePng(pixel, 4, 0, 1, true, &png) == -1, "zero width", 0, 1);
+    Check(EncodePng(pixel, 4, 1, 0, true, &png) == -1, "zero height", 1, 0);
+    Check(EncodePng(pixel, 3, 1, 1, true, &png) == -1, "short stride", 1, 1);
+
+    printf("snapshot_encoder_test: %s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// Checks TransformImage32 bit-exact against a per-pixel scalar reference.
+//
+// Every transform runs over widths that cover the SIMD bodies and all
+// tail lengths of the AVX2, SSE2 and NEON row kernels, with padded
+// strides, once with each kernel set the CPU supports.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "image_kernels.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what, int width, int height) {
+    if (!condition) {
+        fprintf(stderr, "FAILED (%s): %s (%dx%d)\n", ImageKernelName(), what, width, height);
+        failures++;
+    }
+}
+
+const char* Name(ImageTransform transform) {
+    switch (transform) {
+    case ImageTransform::kFlip:
+        return "flip";
+    case ImageTransform::kMirror:
+        return "mirror";
+    case ImageTransform::kFlipMirror:
+        return "flip+mirror";
+    }
+    return "?";
+}
+
+void Reference(const std::vector<uint32_t>& src, int src_pitch, std::vector<uint32_t>* dst, int dst_pitch,
+               int width, int height, ImageTransform transform) {
+    const bool flip = transform != ImageTransform::kMirror;
+    const bool mirror = transform != ImageTransform::kFlip;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int sy = flip ? height - 1 - y : y;
+            const int sx = mirror ? width - 1 - x : x;
+            (*dst)[size_t(y) * dst_pitch + x] = src[size_t(sy) * src_pitch + sx];
+        }
+    }
+}
+
+void CheckTransform(int width, int height, ImageTransform transform) {
+    // Padded rows, the padding must come out untouched.
+    const int src_pitch = width + 3, dst_pitch = width + 5;
+    std::vector<uint32_t> src(size_t(src_pitch) * height);
+    uint32_t seed = uint32_t(width * 7919 + height);
+    for (uint32_t& pixel : src) {
+        seed = seed * 1103515245u + 12345u;
+        pixel = seed;
+    }
+
+    std::vector<uint32_t> expected(size_t(dst_pitch) * height, 0xDEADBEEFu);
+    std::vector<uint32_t> actual = expected;
+    Reference(src, src_pitch, &expected, dst_pitch, width, height, transform);
+    const int result = TransformImage32(reinterpret_cast<const uint8_t*>(src.data()), src_pitch * 4,
+                                        reinterpret_cast<uint8_t*>(actual.data()), dst_pitch * 4,
+                                        width, height, transform);
+    Check(result == 0, "returns 0", width, height);
+    Check(actual == expected, Name(transform), width, height);
+}
+
+void CheckKernels() {
+    const ImageTransform transforms[] = {ImageTransform::kFlip, ImageTransform::kMirror, ImageTransform::kFlipMirror};
+    for (ImageTransform transform : transforms) {
+        for (int width = 1; width <= 69; ++width) {
+            for (int height = 1; height <= 4; ++height) {
+                CheckTransform(width, height, transform);
+            }
+        }
+        CheckTransform(1280, 9, transform);
+        CheckTransform(1921, 7, transform);
+    }
+
+    uint8_t pixel[4] = {};
+    Check(TransformImage32(nullptr, 4, pixel, 4, 1, 1, ImageTransform::kFlip) == -1, "null src", 1, 1);
+    Check(TransformImage32(pixel, 4, nullptr, 4, 1, 1, ImageTransform::kFlip) == -1, "null dst", 1, 1);
+    Check(TransformImage32(pixel, 4, pixel, 4, 0, 1, ImageTransform::kMirror) == -1, "zero width", 0, 1);
+    Check(TransformImage32(pixel, 4, pixel, 4, 1, 0, ImageTransform::kMirror) == -1, "zero height", 1, 0);
+}
+
+}  // namespace
+
+int main() {
+    for (const char* kernels : {"avx2", "sse2", "neon", "c"}) {
+        if (SetImageKernels(kernels) != 0) {
+            continue;  // not supported by this CPU.
+        }
+        const int before = failures;
+        CheckKernels();
+        printf("transform_test (%s): %s\n", kernels, failures > before ? "FAILED" : "passed");
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+// Checks I420ToABGR bit-exact against a per-pixel scalar BT.601
+// reference, and the fused bottom-up mirrored write used for the vcam
+// against converting first and applying TransformImage32 after, once with
+// each kernel set the CPU supports.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "image_kernels.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what, int width, int height) {
+    if (!condition) {
+        fprintf(stderr, "FAILED (%s): %s (%dx%d)\n", ImageKernelName(), what, width, height);
+        failures++;
+    }
+}
+
+uint8_t Clamp(int v) {
+    return uint8_t(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// BT.601 limited range in 16.16 fixed point, bytes R, G, B, A.
+void ReferencePixel(int y, int u, int v, uint8_t* rgba) {
+    const int y1 = (y - 16) * 76309 + 32768;
+    rgba[0] = Clamp((y1 + 104597 * (v - 128)) >> 16);
+    rgba[1] = Clamp((y1 - 25675 * (u - 128) - 53279 * (v - 128)) >> 16);
+    rgba[2] = Clamp((y1 + 132201 * (u - 128)) >> 16);
+    rgba[3] = 255;
+}
+
+std::vector<uint8_t> Random(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    for (uint8_t& sample : data) {
+        seed = seed * 1103515245u + 12345u;
+        sample = uint8_t(seed >> 16);
+    }
+    return data;
+}
+
+void CheckConvert(int width, int height) {
+    const int cw = (width + 1) / 2, ch = (height + 1) / 2;
+    const int stride_y = width + 3, stride_uv = cw + 1;
+    const std::vector<uint8_t> y = Random(size_t(stride_y) * height, uint32_t(width));
+    const std::vector<uint8_t> u = Random(size_t(stride_uv) * ch, uint32_t(height));
+    const std::vector<uint8_t> v = Random(size_t(stride_uv) * ch, uint32_t(width * height));
+
+    const int stride = width * 4;
+    std::vector<uint8_t> expected(size_t(stride) * height);
+    for (int row = 0; row < height; ++row) {
+        for (int x = 0; x < width; ++x) {
+            ReferencePixel(y[size_t(row) * stride_y + x], u[size_t(row / 2) * stride_uv + x / 2],
+                           v[size_t(row / 2) * stride_uv + x / 2], &expected[size_t(row) * stride + x * 4]);
+        }
+    }
+
+    std::vector<uint8_t> actual(expected.size());
+    Check(I420ToABGR(y.data(), stride_y, u.data(), stride_uv, v.data(), stride_uv,
+                     actual.data(), stride, width, height, false) == 0 &&
+              actual == expected,
+          "I420ToABGR", width, height);
+
+    // What the vcam send path does: last row first, mirrored.
+    std::vector<uint8_t> transformed(expected.size());
+    TransformImage32(expected.data(), stride, transformed.data(), stride, width, height, ImageTransform::kFlipMirror);
+    Check(I420ToABGR(y.data(), stride_y, u.data(), stride_uv, v.data(), stride_uv,
+                     actual.data() + size_t(height - 1) * stride, -stride, width, height, true) == 0 &&
+              actual == transformed,
+          "I420ToABGR bottom-up mirrored", width, height);
+}
+
+void CheckKernels() {
+    for (int width = 1; width <= 69; ++width) {
+        for (int height = 1; height <= 4; ++height) {
+            CheckConvert(width, height);
+        }
+    }
+    CheckConvert(1280, 9);
+    CheckConvert(1921, 7);
+
+    uint8_t sample[4] = {};
+    Check(I420ToABGR(nullptr, 1, sample, 1, sample, 1, sample, 4, 1, 1, false) == -1, "null y", 1, 1);
+    Check(I420ToABGR(sample, 1, sample, 1, sample, 1, sample, 4, 0, 1, false) == -1, "zero width", 0, 1);
+}
+
+}  // namespace
+
+int main() {
+    for (const char* kernels : {"avx2", "sse2", "neon", "c"}) {
+        if (SetImageKernels(kernels) != 0) {
+            continue;  // not supported by this CPU.
+        }
+        const int before = failures;
+        CheckKernels();
+        printf("yuv_test (%s): %s\n", kernels, failures > before ? "FAILED" : "passed");
+    }
+    return failures ? 1 : 0;
+}
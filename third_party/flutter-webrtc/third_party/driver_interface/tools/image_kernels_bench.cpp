@@ -0,0 +1,143 @@
+// Image kernel microbenchmark.
+//
+// Times TransformImage32 against the scalar flip+mirror loop it replaced
+// (the former invertImageBuffer), and the fused I420 -> vcam frame write
+// against the former convert, flip+mirror and copy passes, at 720p, 1080p
+// and 4K. Reports the time per frame of each.
+//
+// The former path converted with libyuv, which isn't part of this build,
+// so its first pass is timed with I420ToABGR instead; the comparison
+// measures the two extra full-frame passes.
+//
+// Usage: image_kernels_bench [--size WxH] [--runs N] [--kernels NAME]
+//
+// --size benchmarks a single frame size instead of the three defaults.
+// --kernels runs with "avx2", "sse2", "neon" or "c" instead of the kernels
+// selected for this CPU.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "image_kernels.h"
+
+namespace {
+
+double NowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The former invertImageBuffer: walks the source bottom-up and mirrors
+// each row one pixel at a time.
+void InvertImageScalar(const uint8_t* src_argb, uint8_t* dst_argb, int width, int height) {
+    const int stride = width * 4;
+    src_argb = src_argb + static_cast<ptrdiff_t>(height - 1) * stride;
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* src32 = reinterpret_cast<const uint32_t*>(src_argb);
+        uint32_t* dst32 = reinterpret_cast<uint32_t*>(dst_argb);
+        src32 += width - 1;
+        for (int x = 0; x < width - 1; x += 2) {
+            dst32[x] = src32[0];
+            dst32[x + 1] = src32[-1];
+            src32 -= 2;
+        }
+        if (width & 1) {
+            dst32[width - 1] = src32[0];
+        }
+        src_argb -= stride;
+        dst_argb += stride;
+    }
+}
+
+// Best time of |runs| calls of |body|, after one warm-up call.
+template <typename Body>
+double BestMs(int runs, Body body) {
+    body();
+    double best = 1e9;
+    for (int run = 0; run < runs; run++) {
+        const double start = NowMs();
+        body();
+        best = std::min(best, NowMs() - start);
+    }
+    return best;
+}
+
+void Bench(int width, int height, int runs) {
+    const size_t size = size_t(width) * height * 4;
+    std::vector<uint8_t> src(size), dst(size);
+    for (size_t i = 0; i < size; i++) {
+        src[i] = uint8_t(i * 31 + (i >> 12));
+    }
+    const int stride = width * 4;
+
+    printf("%dx%d, best of %d\n", width, height, runs);
+    printf("  scalar flip+mirror       %8.2f ms\n", BestMs(runs, [&] {
+        InvertImageScalar(src.data(), dst.data(), width, height);
+    }));
+    const struct {
+        ImageTransform transform;
+        const char* name;
+    } transforms[] = {
+        {ImageTransform::kFlip, "flip"},
+        {ImageTransform::kMirror, "mirror"},
+        {ImageTransform::kFlipMirror, "flip+mirror"},
+    };
+    for (const auto& transform : transforms) {
+        printf("  %-24s %8.2f ms\n", transform.name, BestMs(runs, [&] {
+            TransformImage32(src.data(), stride, dst.data(), stride, width, height, transform.transform);
+        }));
+    }
+
+    const int cw = (width + 1) / 2, ch = (height + 1) / 2;
+    std::vector<uint8_t> i420(size_t(width) * height + 2 * size_t(cw) * ch);
+    for (size_t i = 0; i < i420.size(); i++) {
+        i420[i] = uint8_t(i * 13 + (i >> 10));
+    }
+    const uint8_t* y = i420.data();
+    const uint8_t* u = y + size_t(width) * height;
+    const uint8_t* v = u + size_t(cw) * ch;
+    std::vector<uint8_t> rgb(size), shared(size);
+    printf("  I420 convert+invert+copy %8.2f ms\n", BestMs(runs, [&] {
+        I420ToABGR(y, width, u, cw, v, cw, rgb.data(), stride, width, height, false);
+        TransformImage32(rgb.data(), stride, dst.data(), stride, width, height, ImageTransform::kFlipMirror);
+        memcpy(shared.data(), dst.data(), size);
+    }));
+    printf("  I420 fused               %8.2f ms\n", BestMs(runs, [&] {
+        I420ToABGR(y, width, u, cw, v, cw, shared.data() + size_t(height - 1) * stride, -stride,
+                   width, height, true);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int width = 0, height = 0, runs = 20;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            sscanf(argv[++i], "%dx%d", &width, &height);
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--kernels") && i + 1 < argc) {
+            if (SetImageKernels(argv[++i]) != 0) {
+                fprintf(stderr, "kernels %s are not supported here\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+
+    printf("kernels: %s\n", ImageKernelName());
+    if (width > 0 && height > 0) {
+        Bench(width, height, runs);
+        return 0;
+    }
+    Bench(1280, 720, runs);
+    Bench(1920, 1080, runs);
+    Bench(3840, 2160, runs);
+    return 0;
+}
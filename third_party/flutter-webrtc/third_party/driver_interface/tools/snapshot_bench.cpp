@@ -0,0 +1,142 @@
+// Snapshot encoder benchmark.
+//
+// Encodes the same frame with svpng (the previous snapshot writer, stored
+// deflate through fputc) and with EncodePng, then writes the raw I420
+// planes, and reports the time per snapshot and the file size of each.
+//
+// Usage: snapshot_bench [--size WxH] [--rgba file] [--runs N] [--out dir]
+//
+// Without --rgba a synthetic camera-like frame is used: smooth gradients
+// with a little sensor noise. --rgba reads a raw R, G, B, A frame of the
+// given size instead.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "snapshot_encoder.h"
+#include "svpng.hpp"
+
+namespace {
+
+double NowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long FileSize(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+void SyntheticFrame(int width, int height, std::vector<uint8_t>* rgba) {
+    rgba->resize(size_t(width) * height * 4);
+    uint32_t seed = 12345;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            seed = seed * 1103515245u + 12345u;
+            const int noise = int((seed >> 16) & 7) - 3;
+            uint8_t* p = &(*rgba)[(size_t(y) * width + x) * 4];
+            const int r = 40 + 160 * x / width + ((x / 64 + y / 64) & 1) * 30;
+            const int g = 60 + 120 * y / height;
+            const int b = 90 + 80 * (x + y) / (width + height);
+            p[0] = uint8_t(std::min(255, std::max(0, r + noise)));
+            p[1] = uint8_t(std::min(255, std::max(0, g + noise)));
+            p[2] = uint8_t(std::min(255, std::max(0, b + noise)));
+            p[3] = 255;
+        }
+    }
+}
+
+// Planes for the raw snapshot, the encoder only copies them.
+void I420FromRgba(const std::vector<uint8_t>& rgba, int width, int height, std::vector<uint8_t>* i420) {
+    const int cw = (width + 1) / 2, ch = (height + 1) / 2;
+    i420->assign(size_t(width) * height + 2 * size_t(cw) * ch, 128);
+    for (size_t i = 0; i < size_t(width) * height; i++) {
+        const uint8_t* p = &rgba[i * 4];
+        (*i420)[i] = uint8_t((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) / 256 + 16);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int width = 1920, height = 1080, runs = 5;
+    const char* rgbaPath = nullptr;
+    std::string outDir = ".";
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            sscanf(argv[++i], "%dx%d", &width, &height);
+        } else if (!strcmp(argv[i], "--rgba") && i + 1 < argc) {
+            rgbaPath = argv[++i];
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outDir = argv[++i];
+        }
+    }
+
+    std::vector<uint8_t> rgba;
+    if (rgbaPath != nullptr) {
+        rgba.resize(size_t(width) * height * 4);
+        FILE* file = fopen(rgbaPath, "rb");
+        if (file == nullptr || fread(rgba.data(), 1, rgba.size(), file) != rgba.size()) {
+            fprintf(stderr, "cannot read %dx%d RGBA frame from %s\n", width, height, rgbaPath);
+            return 1;
+        }
+        fclose(file);
+    } else {
+        SyntheticFrame(width, height, &rgba);
+    }
+    std::vector<uint8_t> i420;
+    I420FromRgba(rgba, width, height, &i420);
+    const int cw = (width + 1) / 2;
+    const uint8_t* u = i420.data() + size_t(width) * height;
+    const uint8_t* v = u + size_t(cw) * ((height + 1) / 2);
+
+    const std::string svpngPath = outDir + "/snapshot_svpng.png";
+    const std::string pngPath = outDir + "/snapshot.png";
+    const std::string yuvPath = outDir + "/snapshot.yuv";
+    double svpngMs = 1e9, pngMs = 1e9, yuvMs = 1e9;
+
+    for (int run = 0; run < runs; run++) {
+        double start = NowMs();
+        FILE* file = fopen(svpngPath.c_str(), "wb");
+        if (file == nullptr) {
+            fprintf(stderr, "cannot write to %s\n", outDir.c_str());
+            return 1;
+        }
+        svpng(file, width, height, rgba.data(), 1);
+        fclose(file);
+        svpngMs = std::min(svpngMs, NowMs() - start);
+
+        start = NowMs();
+        std::vector<uint8_t> png;
+        EncodePng(rgba.data(), width * 4, width, height, false, &png);
+        WriteSnapshotFile(pngPath.c_str(), png);
+        pngMs = std::min(pngMs, NowMs() - start);
+
+        start = NowMs();
+        std::vector<uint8_t> packed;
+        PackI420(i420.data(), width, u, cw, v, cw, width, height, &packed);
+        WriteSnapshotFile(yuvPath.c_str(), packed);
+        yuvMs = std::min(yuvMs, NowMs() - start);
+    }
+
+    printf("%dx%d, best of %d\n", width, height, runs);
+    printf("svpng      %8.1f ms %10ld bytes\n", svpngMs, FileSize(svpngPath.c_str()));
+    printf("EncodePng  %8.1f ms %10ld bytes\n", pngMs, FileSize(pngPath.c_str()));
+    printf("raw I420   %8.1f ms %10ld bytes\n", yuvMs, FileSize(yuvPath.c_str()));
+    return 0;
+}
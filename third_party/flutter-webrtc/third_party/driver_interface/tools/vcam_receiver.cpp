@@ -0,0 +1,147 @@
+// Reference receiver for the POSIX shared memory transport.
+//
+// Plays the part of the virtual camera: it creates the shared memory slot of
+// a CapNum, requests frames like a capture client would and reports the frame
+// rate and the latency between the sender publishing a frame and it being read.
+//
+// Usage: vcam_receiver [capnum] [--format rgba|i420|nv12] [--seconds N] [--dump file]
+//
+// --format advertises the planar formats to the sender, a dump is written
+// as raw RGBA, I420 or NV12 depending on what was received.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "shared_memory/shared_posix.inl"
+
+namespace {
+
+struct ReceiveState {
+    int width = 0;
+    int height = 0;
+    size_t frameBytes = 0;
+    uint64_t latencyNs = 0;
+    const char* dumpPath = nullptr;
+    SharedImageMemory* shm = nullptr;
+};
+
+void OnFrame(int width, int height, int stride, SharedImageMemory::EFormat format,
+             SharedImageMemory::EResizeMode, SharedImageMemory::EMirrorMode,
+             int, uint8_t* buffer, void* callback_data) {
+    ReceiveState* state = static_cast<ReceiveState*>(callback_data);
+    state->width = width;
+    state->height = height;
+    state->latencyNs = SharedImageMemory::NowNs() - state->shm->GetSentTimeNs();
+
+    if (format == SharedImageMemory::FORMAT_I420 || format == SharedImageMemory::FORMAT_NV12) {
+        uint32_t offsets[3];
+        int strides[3];
+        state->shm->GetPlaneLayout(offsets, strides);
+        const int chromaHeight = (height + 1) / 2;
+        state->frameBytes = static_cast<size_t>(offsets[1]) + static_cast<size_t>(strides[1]) * chromaHeight +
+            (format == SharedImageMemory::FORMAT_I420 ? static_cast<size_t>(strides[2]) * chromaHeight : 0);
+
+        if (state->dumpPath != nullptr) {
+            if (FILE* file = fopen(state->dumpPath, "wb")) {
+                const int chromaWidth = (width + 1) / 2;
+                const int planes = (format == SharedImageMemory::FORMAT_I420 ? 3 : 2);
+                for (int p = 0; p < planes; p++) {
+                    const int rows = (p == 0 ? height : chromaHeight);
+                    const int rowBytes = (p == 0 ? width : (planes == 3 ? chromaWidth : chromaWidth * 2));
+                    for (int y = 0; y < rows; y++) {
+                        fwrite(buffer + offsets[p] + static_cast<size_t>(y) * strides[p], 1, rowBytes, file);
+                    }
+                }
+                fclose(file);
+                printf("dumped %dx%d %s frame to %s\n", width, height, planes == 3 ? "I420" : "NV12", state->dumpPath);
+            }
+            state->dumpPath = nullptr;
+        }
+        return;
+    }
+
+    state->frameBytes = static_cast<size_t>(stride) * height * 4;
+    if (state->dumpPath != nullptr && format == SharedImageMemory::FORMAT_UINT8) {
+        if (FILE* file = fopen(state->dumpPath, "wb")) {
+            for (int y = 0; y < height; y++) {
+                fwrite(buffer + static_cast<size_t>(y) * stride * 4, 4, width, file);
+            }
+            fclose(file);
+            printf("dumped %dx%d RGBA frame to %s\n", width, height, state->dumpPath);
+        }
+        state->dumpPath = nullptr;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int capNum = 0;
+    int seconds = 0;  // run until killed
+    uint32_t formats = SharedImageMemory::LEGACY_FORMATS;
+    ReceiveState state;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* format = argv[++i];
+            if (!strcmp(format, "i420")) formats |= 1 << SharedImageMemory::FORMAT_I420;
+            else if (!strcmp(format, "nv12")) formats |= 1 << SharedImageMemory::FORMAT_NV12;
+        } else if (!strcmp(argv[i], "--dump") && i + 1 < argc) {
+            state.dumpPath = argv[++i];
+        } else {
+            capNum = atoi(argv[i]);
+        }
+    }
+
+    SharedImageMemory shm(capNum);
+    shm.SetAcceptedFormats(formats);
+    state.shm = &shm;
+
+    char name[32];
+    SharedImageMemory::GetName(capNum, name);
+    printf("receiving on %s\n", name);
+
+    const uint64_t start = SharedImageMemory::NowNs();
+    uint64_t windowStart = start;
+    uint64_t frames = 0, oldFrames = 0, latencySum = 0, latencyMax = 0, total = 0;
+
+    for (;;) {
+        switch (shm.Receive(OnFrame, &state)) {
+        case SharedImageMemory::RECEIVERES_CAPTUREINACTIVE: {
+            timespec ts = {0, 10 * 1000000};  // wait for a sender
+            nanosleep(&ts, nullptr);
+            break;
+        }
+        case SharedImageMemory::RECEIVERES_NEWFRAME:
+            frames++, total++;
+            latencySum += state.latencyNs;
+            if (state.latencyNs > latencyMax) latencyMax = state.latencyNs;
+            break;
+        case SharedImageMemory::RECEIVERES_OLDFRAME:
+            oldFrames++;
+            break;
+        }
+
+        const uint64_t now = SharedImageMemory::NowNs();
+        if (now - windowStart >= 1000000000ull) {
+            const double elapsed = (now - windowStart) / 1e9;
+            printf("%dx%d %.1f fps, %zu bytes per frame, latency avg %.3f ms max %.3f ms, %llu timeouts\n",
+                   state.width, state.height, frames / elapsed, state.frameBytes,
+                   frames ? latencySum / 1e6 / frames : 0.0, latencyMax / 1e6,
+                   static_cast<unsigned long long>(oldFrames));
+            fflush(stdout);
+            windowStart = now;
+            frames = oldFrames = latencySum = latencyMax = 0;
+        }
+        if (seconds > 0 && now - start >= static_cast<uint64_t>(seconds) * 1000000000ull) {
+            break;
+        }
+    }
+
+    printf("received %llu frames\n", static_cast<unsigned long long>(total));
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Synthetic frame source for the virtual camera transport.
+//
+// Pushes generated I420 frames through DriverInterface, i.e. the same
+// conversion and shared memory path as decoded WebRTC frames, so the
+// pipeline can be measured and stress-tested without a phone.
+//
+// Usage: vcam_sender [width height] [--fps N] [--seconds N] [--device path] [--max WxH]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "driver_interface.h"
+
+int main(int argc, char** argv) {
+    int width = 1280, height = 720, fps = 30, seconds = 10;
+    int maxWidth = 0, maxHeight = 0;
+    std::string devicePath;
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--fps") && i + 1 < argc) {
+            fps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max") && i + 1 < argc) {
+            sscanf(argv[++i], "%dx%d", &maxWidth, &maxHeight);
+        } else if (!strcmp(argv[i], "--device") && i + 1 < argc) {
+            devicePath = argv[++i];
+        } else if (positional++ == 0) {
+            width = atoi(argv[i]);
+        } else {
+            height = atoi(argv[i]);
+        }
+    }
+    width &= ~1, height &= ~1;
+
+    std::vector<DeviceInfo> devices = DriverInterface::GetDevices();
+    if (devicePath.empty() && !devices.empty()) {
+        devicePath = devices.front().devicePath;
+    }
+    std::unique_ptr<VirtualCameraOutput> output = VirtualCameraOutput::Create(devicePath);
+    if (output == nullptr) {
+        fprintf(stderr, "device not found: %s\n", devicePath.c_str());
+        return 1;
+    }
+    output->SetMaxResolution(maxWidth, maxHeight);
+
+    const int chromaWidth = width / 2, chromaHeight = height / 2;
+    std::vector<uint8_t> y(static_cast<size_t>(width) * height);
+    std::vector<uint8_t> u(static_cast<size_t>(chromaWidth) * chromaHeight);
+    std::vector<uint8_t> v(u.size());
+    const I420Buffer frame{y.data(), u.data(), v.data(), width, chromaWidth, chromaWidth, width, height};
+
+    printf("sending %dx%d at %d fps to %s\n", width, height, fps, devicePath.c_str());
+
+    using clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::microseconds(fps > 0 ? 1000000 / fps : 0);
+    const auto start = clock::now();
+    auto next = start;
+    auto windowStart = start;
+    int sent = 0, unrequested = 0, idle = 0;
+    double convertMs = 0;
+
+    for (int n = 0; clock::now() - start < std::chrono::seconds(seconds); n++) {
+        // Moving gradient, cheap to generate and easy to eyeball in a dump.
+        for (int row = 0; row < height; row++) {
+            memset(&y[static_cast<size_t>(row) * width], (row + n) & 0xff, width);
+        }
+        memset(u.data(), (n * 3) & 0xff, u.size());
+        memset(v.data(), 255 - ((n * 3) & 0xff), v.size());
+
+        const auto t0 = clock::now();
+        const int result = output->SendBuffer(frame);
+        convertMs += std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+
+        if (result == -2) idle++;  // nobody asked for a frame, nothing was converted
+        else if (result == 2) sent++;
+        else unrequested++;  // SENDRES_WARN_FRAMESKIP: sent before a receiver asked for it
+
+        const auto now = clock::now();
+        if (now - windowStart >= std::chrono::seconds(1)) {
+            const int calls = sent + unrequested + idle;
+            printf("sent %d, unrequested %d, idle %d, %.3f ms per call\n",
+                   sent, unrequested, idle, calls ? convertMs / calls : 0.0);
+            fflush(stdout);
+            windowStart = now;
+            sent = unrequested = idle = 0;
+            convertMs = 0;
+        }
+
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+
+    return 0;
+}